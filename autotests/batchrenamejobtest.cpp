@@ -117,6 +117,81 @@ private Q_SLOTS:
         QVERIFY(checkFileExistence(newFilenames));
     }
 
+    void batchRenameCycleTest()
+    {
+        // Rotate the names of three files, and hand one name down a chain
+        const QStringList names{QStringLiteral("cycle1.txt"), QStringLiteral("cycle2.txt"), QStringLiteral("cycle3.txt"), QStringLiteral("chain1.txt"), QStringLiteral("chain2.txt")};
+        for (const QString &name : names) {
+            createTestFile(m_homeDir + name, false, name.toUtf8());
+        }
+        const QStringList newNames{QStringLiteral("cycle2.txt"), QStringLiteral("cycle3.txt"), QStringLiteral("cycle1.txt"), QStringLiteral("chain2.txt"), QStringLiteral("chain3.txt")};
+
+        KIO::BatchRenameJob *job = KIO::batchRename(createUrlList(names), createUrlList(newNames), KIO::HideProgressInfo);
+        job->setUiDelegate(nullptr);
+        QSignalSpy spy(job, &KIO::BatchRenameJob::fileRenamed);
+        QVERIFY2(job->exec(), qPrintable(job->errorString()));
+        QCOMPARE(spy.count(), names.count());
+        QCOMPARE(job->processedAmount(KJob::Items), names.count());
+
+        for (int i = 0; i < names.count(); ++i) {
+            QFile file(m_homeDir + newNames.at(i));
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            QCOMPARE(file.readAll(), names.at(i).toUtf8());
+        }
+        QVERIFY(!QFile::exists(m_homeDir + QStringLiteral("chain1.txt")));
+        QCOMPARE(QDir(m_homeDir).entryList({QStringLiteral(".kio-rename-*")}, QDir::Files | QDir::Hidden), QStringList());
+    }
+
+    void batchRenameConflictTest()
+    {
+        // Renaming onto a file outside of the batch must not overwrite it
+        const QStringList names{QStringLiteral("conflict1.txt"), QStringLiteral("conflict2.txt")};
+        createTestFiles(names);
+        createTestFile(m_homeDir + QStringLiteral("existing.txt"), false, "existing");
+
+        const QStringList newNames{QStringLiteral("renamed1.txt"), QStringLiteral("existing.txt")};
+        KIO::BatchRenameJob *job = KIO::batchRename(createUrlList(names), createUrlList(newNames), KIO::HideProgressInfo);
+        job->setUiDelegate(nullptr);
+        QSignalSpy spy(job, &KIO::BatchRenameJob::fileRenamed);
+        QVERIFY(!job->exec());
+        QCOMPARE(job->error(), KIO::ERR_FILE_ALREADY_EXIST);
+
+        QFile file(m_homeDir + QStringLiteral("existing.txt"));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), QByteArray("existing"));
+        QVERIFY(QFile::exists(m_homeDir + QStringLiteral("conflict2.txt")));
+
+        // The batch renamed nothing, so the job went on one by one, which is where a
+        // ui delegate would ask about the conflict. Without one, it stopped there.
+        QCOMPARE(spy.count(), 1);
+        QVERIFY(!QFile::exists(m_homeDir + QStringLiteral("conflict1.txt")));
+        QVERIFY(QFile::exists(m_homeDir + QStringLiteral("renamed1.txt")));
+    }
+
+    void batchRenameSwapConflictTest()
+    {
+        // Swapping names can't be done one by one, so a failed batch changes nothing
+        const QStringList names{QStringLiteral("swap1.txt"), QStringLiteral("swap2.txt"), QStringLiteral("swap3.txt")};
+        for (const QString &name : names) {
+            createTestFile(m_homeDir + name, false, name.toUtf8());
+        }
+        createTestFile(m_homeDir + QStringLiteral("existing.txt"), false, "existing");
+
+        const QStringList newNames{QStringLiteral("swap2.txt"), QStringLiteral("swap1.txt"), QStringLiteral("existing.txt")};
+        KIO::BatchRenameJob *job = KIO::batchRename(createUrlList(names), createUrlList(newNames), KIO::HideProgressInfo);
+        job->setUiDelegate(nullptr);
+        QSignalSpy spy(job, &KIO::BatchRenameJob::fileRenamed);
+        QVERIFY(!job->exec());
+        QCOMPARE(job->error(), KIO::ERR_FILE_ALREADY_EXIST);
+
+        QCOMPARE(spy.count(), 0);
+        for (const QString &name : names) {
+            QFile file(m_homeDir + name);
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            QCOMPARE(file.readAll(), name.toUtf8());
+        }
+    }
+
 private:
     QString m_homeDir;
 };
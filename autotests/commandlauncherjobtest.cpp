@@ -15,6 +15,11 @@
 #include <QTest>
 #include <kprocessrunner_p.h>
 
+#ifdef Q_OS_UNIX
+#include <pthread.h>
+#include <signal.h> // kill, pthread_sigmask
+#endif
+
 QTEST_GUILESS_MAIN(CommandLauncherJobTest)
 
 void CommandLauncherJobTest::initTestCase()
@@ -215,6 +220,74 @@ void CommandLauncherJobTest::startProcessWithEnvironmentVariables()
     QCOMPARE(data, "myvar=myvalue");
 }
 
+static QByteArray readDestFile(const QString &path)
+{
+    QFile destFile(path);
+    if (!destFile.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return destFile.readAll().trimmed();
+}
+
+void CommandLauncherJobTest::startProcessShouldReportExit()
+{
+#ifdef Q_OS_UNIX
+    KIO::CommandLauncherJob *job = new KIO::CommandLauncherJob(QStringLiteral("sleep 1"), this);
+    QVERIFY(job->exec());
+    const qint64 pid = job->pid();
+    QVERIFY(pid != 0);
+
+    // The runner lives as long as the process does, whether QProcess or a pidfd watches it
+    QCOMPARE(::kill(pid, 0), 0);
+    QCOMPARE(KProcessRunner::instanceCount(), 1);
+    QTRY_COMPARE_WITH_TIMEOUT(KProcessRunner::instanceCount(), 0, 10000);
+    // and the process was reaped, not left as a zombie
+    QCOMPARE(::kill(pid, 0), -1);
+#else
+    QSKIP("Uses sleep and kill");
+#endif
+}
+
+void CommandLauncherJobTest::startProcessStdinShouldBePipe()
+{
+#ifdef Q_OS_UNIX
+    // Applications get a pipe as stdin, like QProcess always gave them, not /dev/null or ours
+    QTemporaryDir tempDir;
+    const QString command = QStringLiteral("if [ -p /dev/stdin ]; then echo pipe; else echo other; fi > destfile");
+    KIO::CommandLauncherJob *job = new KIO::CommandLauncherJob(command, this);
+    job->setWorkingDirectory(tempDir.path());
+    QVERIFY(job->exec());
+
+    QTRY_COMPARE(readDestFile(tempDir.path() + "/destfile"), "pipe");
+    QTRY_COMPARE(KProcessRunner::instanceCount(), 0);
+#else
+    QSKIP("Uses /dev/stdin");
+#endif
+}
+
+void CommandLauncherJobTest::startProcessShouldNotInheritBlockedSignals()
+{
+#ifdef Q_OS_LINUX
+    sigset_t blocked;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGUSR2);
+    sigset_t previous;
+    QCOMPARE(pthread_sigmask(SIG_BLOCK, &blocked, &previous), 0);
+
+    QTemporaryDir tempDir;
+    KIO::CommandLauncherJob *job = new KIO::CommandLauncherJob(QStringLiteral("grep SigBlk /proc/self/status > destfile"), this);
+    job->setWorkingDirectory(tempDir.path());
+    const bool started = job->exec();
+    QCOMPARE(pthread_sigmask(SIG_SETMASK, &previous, nullptr), 0);
+    QVERIFY(started);
+
+    QTRY_COMPARE(readDestFile(tempDir.path() + "/destfile"), "SigBlk:\t0000000000000000");
+    QTRY_COMPARE(KProcessRunner::instanceCount(), 0);
+#else
+    QSKIP("Uses /proc/self/status");
+#endif
+}
+
 void CommandLauncherJobTest::doesNotFailOnNonExistingExecutable()
 {
     // Given a command that uses an executable that doesn't exist
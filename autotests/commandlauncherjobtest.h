@@ -29,6 +29,10 @@ private Q_SLOTS:
 
     void startProcessWithEnvironmentVariables();
 
+    void startProcessShouldReportExit();
+    void startProcessStdinShouldBePipe();
+    void startProcessShouldNotInheritBlockedSignals();
+
     void doesNotFailOnNonExistingExecutable();
     void shouldDoNothingOnEmptyCommand();
 };
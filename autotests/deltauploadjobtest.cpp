@@ -0,0 +1,186 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "deltauploadjob.h"
+
+static constexpr qint64 blockSize = FileChecksums::blockSize;
+
+class DeltaUploadJobTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void changedBlockShouldBeWritten();
+    void shorterFileShouldBeTruncated();
+    void shouldFallBackToCopy_data();
+    void shouldFallBackToCopy();
+
+private:
+    FileChecksums download();
+    void changeRemoteBlock(bool keepModificationTime);
+
+    QTemporaryDir m_dir;
+    QString m_remotePath;
+    QString m_localPath;
+    QByteArray m_content;
+};
+
+static void writeFile(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(content), content.size());
+}
+
+static QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+static void setModificationTime(const QString &path, const QDateTime &mtime)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(mtime, QFileDevice::FileModificationTime));
+}
+
+void DeltaUploadJobTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+
+    // 3.5 blocks, that differ from each other
+    m_content.reserve(3 * blockSize + blockSize / 2);
+    for (qint64 i = 0; i < 3 * blockSize + blockSize / 2; ++i) {
+        m_content += char(i % 251);
+    }
+}
+
+void DeltaUploadJobTest::init()
+{
+    m_remotePath = m_dir.filePath(QStringLiteral("remote.bin"));
+    m_localPath = m_dir.filePath(QStringLiteral("local.bin"));
+    QFile::remove(m_remotePath);
+    QFile::remove(m_localPath);
+    writeFile(m_remotePath, m_content);
+    // An hour ago, so that it's not the time of any local change
+    setModificationTime(m_remotePath, QDateTime::currentDateTime().addSecs(-3600));
+}
+
+// Like kioexec: the downloaded file gets the modification time of the remote one
+FileChecksums DeltaUploadJobTest::download()
+{
+    if (!QFile::copy(m_remotePath, m_localPath)) {
+        return FileChecksums();
+    }
+    setModificationTime(m_localPath, QDateTime::fromSecsSinceEpoch(QFileInfo(m_remotePath).lastModified().toSecsSinceEpoch()));
+    return FileChecksums::compute(m_localPath);
+}
+
+// Changes the first block of the remote file behind the job's back. Only a full copy overwrites it.
+void DeltaUploadJobTest::changeRemoteBlock(bool keepModificationTime)
+{
+    const QDateTime mtime = QFileInfo(m_remotePath).lastModified();
+    QFile file(m_remotePath);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QCOMPARE(file.write(QByteArray(16, 'R')), 16);
+    file.close();
+    setModificationTime(m_remotePath, keepModificationTime ? mtime : mtime.addSecs(100));
+}
+
+void DeltaUploadJobTest::changedBlockShouldBeWritten()
+{
+    const FileChecksums remote = download();
+    QVERIFY(remote.isValid());
+    QCOMPARE(remote.blockCount(), 4);
+    changeRemoteBlock(true);
+
+    QByteArray content = m_content;
+    content.replace(blockSize + 10, 5, "HELLO");
+    writeFile(m_localPath, content);
+    const FileChecksums local = FileChecksums::compute(m_localPath);
+
+    DeltaUploadJob *job = new DeltaUploadJob(m_localPath, QUrl::fromLocalFile(m_remotePath), remote, local);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+
+    // Only the second block was written
+    QByteArray expected = content;
+    expected.replace(0, 16, QByteArray(16, 'R'));
+    QCOMPARE(readFile(m_remotePath), expected);
+    // Like a copy, so that the next upload can check it
+    QCOMPARE(QFileInfo(m_remotePath).lastModified().toSecsSinceEpoch(), local.modificationTime().toSecsSinceEpoch());
+}
+
+void DeltaUploadJobTest::shorterFileShouldBeTruncated()
+{
+    const FileChecksums remote = download();
+    QVERIFY(remote.isValid());
+    changeRemoteBlock(true);
+
+    const QByteArray content = m_content.left(2 * blockSize + 100);
+    writeFile(m_localPath, content);
+    const FileChecksums local = FileChecksums::compute(m_localPath);
+
+    DeltaUploadJob *job = new DeltaUploadJob(m_localPath, QUrl::fromLocalFile(m_remotePath), remote, local);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+
+    QByteArray expected = content;
+    expected.replace(0, 16, QByteArray(16, 'R'));
+    QCOMPARE(readFile(m_remotePath), expected);
+}
+
+void DeltaUploadJobTest::shouldFallBackToCopy_data()
+{
+    QTest::addColumn<bool>("remoteChanged");
+    QTest::addColumn<QList<qint64>>("changedBlocks");
+    QTest::addColumn<bool>("withRemoteChecksums");
+
+    QTest::newRow("remote changed") << true << QList<qint64>{1} << true;
+    QTest::newRow("most blocks changed") << false << QList<qint64>{1, 2, 3} << true;
+    QTest::newRow("no checksums") << false << QList<qint64>{1} << false;
+}
+
+void DeltaUploadJobTest::shouldFallBackToCopy()
+{
+    QFETCH(bool, remoteChanged);
+    QFETCH(QList<qint64>, changedBlocks);
+    QFETCH(bool, withRemoteChecksums);
+
+    const FileChecksums remote = download();
+    QVERIFY(remote.isValid());
+    // With the same modification time, only a full copy notices
+    changeRemoteBlock(!remoteChanged);
+
+    QByteArray content = m_content;
+    for (qint64 block : changedBlocks) {
+        content.replace(block * blockSize + 10, 5, "HELLO");
+    }
+    writeFile(m_localPath, content);
+    const FileChecksums local = FileChecksums::compute(m_localPath);
+
+    DeltaUploadJob *job = new DeltaUploadJob(m_localPath, QUrl::fromLocalFile(m_remotePath), withRemoteChecksums ? remote : FileChecksums(), local);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+
+    // The whole file was copied, over the change behind the job's back
+    QCOMPARE(readFile(m_remotePath), content);
+}
+
+QTEST_GUILESS_MAIN(DeltaUploadJobTest)
+
+#include "deltauploadjobtest.moc"
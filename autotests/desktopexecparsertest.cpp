@@ -12,11 +12,13 @@
 QTEST_GUILESS_MAIN(DesktopExecParserTest)
 
 #include <QStandardPaths>
+#include <QTemporaryDir>
 
 #include <desktopexecparser.h>
 
 #include <KApplicationTrader>
 #include <KConfigGroup>
+#include <KDesktopFile>
 #include <KProcess>
 #include <KService>
 #include <KSharedConfig>
@@ -276,4 +278,40 @@ void DesktopExecParserTest::testKtelnetservice()
     }
 }
 
+static void writeDesktopFile(const QString &path, const QString &name)
+{
+    KDesktopFile file(path);
+    KConfigGroup group = file.desktopGroup();
+    group.writeEntry("Type", "Application");
+    group.writeEntry("Name", name);
+    group.writeEntry("Exec", "true %c %f");
+    file.sync();
+}
+
+void DesktopExecParserTest::testModifiedDesktopFile()
+{
+    // The parsed Exec line is cached, but must follow changes to the desktop file
+    QTemporaryDir tempDir;
+    const QString desktopFilePath = tempDir.filePath(QStringLiteral("modified.desktop"));
+    const QList<QUrl> urls({QUrl::fromLocalFile(QStringLiteral("/tmp/file"))});
+
+    writeDesktopFile(desktopFilePath, QStringLiteral("One"));
+    {
+        KService service(desktopFilePath);
+        KIO::DesktopExecParser parser(service, urls);
+        QCOMPARE(parser.resultingArguments(), QStringList({m_pseudoTerminalProgram, QStringLiteral("One"), QStringLiteral("/tmp/file")}));
+    }
+
+    writeDesktopFile(desktopFilePath, QStringLiteral("Two"));
+    QFile file(desktopFilePath);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+    file.close();
+    {
+        KService service(desktopFilePath);
+        KIO::DesktopExecParser parser(service, urls);
+        QCOMPARE(parser.resultingArguments(), QStringList({m_pseudoTerminalProgram, QStringLiteral("Two"), QStringLiteral("/tmp/file")}));
+    }
+}
+
 #include "moc_desktopexecparsertest.cpp"
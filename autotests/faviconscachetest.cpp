@@ -0,0 +1,135 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KConfig>
+#include <KConfigGroup>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTest>
+#include <QThread>
+
+#include <faviconscache_p.h>
+
+using KIO::FavIconsCache;
+
+class FavIconsCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void setIconFromThreadWithoutEventLoopShouldBeSaved();
+    void iconFilesShouldComeFromScan();
+    void iconUrlShouldComeFromIndex();
+    void savedIconShouldBeFoundRightAway();
+
+private:
+    QString m_cacheDir;
+};
+
+static void createFile(const QString &path)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("PNG");
+}
+
+void FavIconsCacheTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    m_cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QStringLiteral("/favicons/");
+    QDir(m_cacheDir).removeRecursively();
+    QVERIFY(QDir().mkpath(m_cacheDir));
+    // Before the first lookup, which starts the scan
+    createFile(m_cacheDir + QStringLiteral("ondisk.example.org.png"));
+}
+
+void FavIconsCacheTest::setIconFromThreadWithoutEventLoopShouldBeSaved()
+{
+    // The cache is created by a thread that never runs an event loop
+    QThread *thread = QThread::create([]() {
+        FavIconsCache::instance()->setIconForUrl(QUrl(QStringLiteral("https://thread.example.org/page")),
+                                                 QUrl(QStringLiteral("https://thread.example.org/icon.png")));
+    });
+    thread->start();
+    QVERIFY(thread->wait());
+    delete thread;
+
+    // The batched write happens anyway, long before the cache is destroyed
+    QTRY_COMPARE_WITH_TIMEOUT(KConfig(m_cacheDir + QStringLiteral("index")).group(QString()).readEntry("thread.example.org/page"),
+                              QStringLiteral("https://thread.example.org/icon.png"),
+                              10000);
+}
+
+void FavIconsCacheTest::iconFilesShouldComeFromScan()
+{
+    FavIconsCache *cache = FavIconsCache::instance();
+
+    // Icons already on disk are found, whether the scan finished or not
+    const QString onDisk = m_cacheDir + QStringLiteral("ondisk.example.org.png");
+    QCOMPARE(cache->iconForUrl(QUrl(QStringLiteral("https://ondisk.example.org/"))), onDisk);
+
+    // Icons reported as saved are remembered across the scan, even when the
+    // scan itself didn't see them. Before the scan finished, the disk is asked.
+    const QString reported = m_cacheDir + QStringLiteral("reported.example.org.png");
+    cache->addCachedIconFile(reported);
+    QTRY_COMPARE(cache->iconForUrl(QUrl(QStringLiteral("https://reported.example.org/"))), reported);
+
+    // Once the scan is done, the result is used rather than the disk
+    QVERIFY(QFile::remove(onDisk));
+    QCOMPARE(cache->iconForUrl(QUrl(QStringLiteral("https://ondisk.example.org/"))), onDisk);
+    QCOMPARE(cache->iconForUrl(QUrl(QStringLiteral("https://unknown.example.org/"))), QString());
+}
+
+void FavIconsCacheTest::iconUrlShouldComeFromIndex()
+{
+    FavIconsCache *cache = FavIconsCache::instance();
+    const QUrl pageUrl(QStringLiteral("https://www.example.org/some/page/"));
+    const QUrl iconUrl(QStringLiteral("https://static.example.org/icons/icon.png"));
+
+    // Nothing known about the host yet, so the default icon URL
+    QCOMPARE(cache->iconUrlForUrl(pageUrl), QUrl(QStringLiteral("https://www.example.org/favicon.ico")));
+
+    cache->setIconForUrl(pageUrl, iconUrl);
+    QCOMPARE(cache->iconUrlForUrl(pageUrl), iconUrl);
+    // Trailing slashes don't matter
+    QCOMPARE(cache->iconUrlForUrl(QUrl(QStringLiteral("https://www.example.org/some/page"))), iconUrl);
+    // Other pages of the host aren't affected
+    QCOMPARE(cache->iconUrlForUrl(QUrl(QStringLiteral("https://www.example.org/other"))), QUrl(QStringLiteral("https://www.example.org/favicon.ico")));
+
+    // The icon of the page is used once it exists on disk
+    const QString iconPath = cache->cachePathForIconUrl(iconUrl);
+    QCOMPARE(iconPath, m_cacheDir + QStringLiteral("static.example.org_icons_icon.png"));
+    QCOMPARE(cache->iconForUrl(pageUrl), QString());
+    createFile(iconPath);
+    cache->addCachedIconFile(iconPath);
+    QCOMPARE(cache->iconForUrl(pageUrl), iconPath);
+
+    QTRY_COMPARE_WITH_TIMEOUT(KConfig(m_cacheDir + QStringLiteral("index")).group(QString()).readEntry("www.example.org/some/page"), iconUrl.url(), 10000);
+}
+
+void FavIconsCacheTest::savedIconShouldBeFoundRightAway()
+{
+    FavIconsCache *cache = FavIconsCache::instance();
+    const QUrl pageUrl(QStringLiteral("https://saved.example.org/"));
+    // The scan is done, without the icon
+    QTRY_COMPARE(cache->iconForUrl(QUrl(QStringLiteral("https://reported.example.org/"))), m_cacheDir + QStringLiteral("reported.example.org.png"));
+    QCOMPARE(cache->iconForUrl(pageUrl), QString());
+
+    // Found without waiting for the next scan
+    const QString iconPath = cache->saveIconFile(cache->iconUrlForUrl(pageUrl), "PNG data");
+    QCOMPARE(iconPath, m_cacheDir + QStringLiteral("saved.example.org.png"));
+    QCOMPARE(cache->iconForUrl(pageUrl), iconPath);
+    QFile file(iconPath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), QByteArray("PNG data"));
+}
+
+QTEST_GUILESS_MAIN(FavIconsCacheTest)
+
+#include "faviconscachetest.moc"
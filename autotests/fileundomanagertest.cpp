@@ -30,6 +30,7 @@
 #include <QFileInfo>
 #include <QMimeData>
 #include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QTest>
 #include <qplatformdefs.h>
 
@@ -263,6 +264,21 @@ void FileUndoManagerTest::doUndo()
     eventLoop.exec(QEventLoop::ExcludeUserInputEvents); // wait for undo job to finish
 }
 
+static void setTimeStamp(const QString &path)
+{
+#ifdef Q_OS_UNIX
+    // Put timestamp in the past so that we can check that the
+    // copy actually preserves it.
+    struct timeval tp;
+    gettimeofday(&tp, nullptr);
+    struct utimbuf utbuf;
+    utbuf.actime = tp.tv_sec + 30; // 30 seconds in the future
+    utbuf.modtime = tp.tv_sec + 60; // 60 second in the future
+    utime(QFile::encodeName(path).constData(), &utbuf);
+    qDebug("Time changed for %s", qPrintable(path));
+#endif
+}
+
 void FileUndoManagerTest::testCopyFiles()
 {
     // Initially inspired from JobTest::copyFileToSamePartition()
@@ -346,6 +362,52 @@ void FileUndoManagerTest::testMoveFiles()
 #endif
 }
 
+void FileUndoManagerTest::testCopyAndMoveManyFiles()
+{
+    // Files from the same folder are undone with a single job
+    QTemporaryDir tempDir;
+    const QString srcPath = tempDir.path() + "/src";
+    const QString destPath = tempDir.path() + "/dest";
+    QVERIFY(QDir().mkpath(srcPath));
+    QVERIFY(QDir().mkpath(destPath));
+
+    QList<QUrl> lst;
+    for (int i = 0; i < 5; ++i) {
+        const QString path = srcPath + QStringLiteral("/file%1").arg(i);
+        createTestFile(path, "foo");
+        lst.append(QUrl::fromLocalFile(path));
+    }
+
+    KIO::CopyJob *job = KIO::copy(lst, QUrl::fromLocalFile(destPath), KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+    FileUndoManager::self()->recordCopyJob(job);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+
+    const QString modifiedFile = destPath + "/file3";
+    setTimeStamp(modifiedFile);
+    m_uiInterface->clear();
+
+    doUndo();
+
+    // The modified file was still asked about
+    QCOMPARE(m_uiInterface->dest().toLocalFile(), modifiedFile);
+    QVERIFY(QDir(destPath).isEmpty());
+    QCOMPARE(QDir(srcPath).entryList(QDir::Files).count(), 5);
+
+    job = KIO::move(lst, QUrl::fromLocalFile(destPath), KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+    FileUndoManager::self()->recordCopyJob(job);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+    QVERIFY(QDir(srcPath).isEmpty());
+
+    doUndo();
+
+    QVERIFY(QDir(destPath).isEmpty());
+    for (const QUrl &url : std::as_const(lst)) {
+        QVERIFY(QFile::exists(url.toLocalFile()));
+    }
+}
+
 void FileUndoManagerTest::testCopyDirectory()
 {
     const QString destdir = destDir();
@@ -606,21 +668,6 @@ void FileUndoManagerTest::testRestoreTrashedFiles()
     // TODO support for RestoreJob in FileUndoManager !!!
 }
 
-static void setTimeStamp(const QString &path)
-{
-#ifdef Q_OS_UNIX
-    // Put timestamp in the past so that we can check that the
-    // copy actually preserves it.
-    struct timeval tp;
-    gettimeofday(&tp, nullptr);
-    struct utimbuf utbuf;
-    utbuf.actime = tp.tv_sec + 30; // 30 seconds in the future
-    utbuf.modtime = tp.tv_sec + 60; // 60 second in the future
-    utime(QFile::encodeName(path).constData(), &utbuf);
-    qDebug("Time changed for %s", qPrintable(path));
-#endif
-}
-
 void FileUndoManagerTest::testModifyFileBeforeUndo()
 {
     // based on testCopyDirectory (so that we check that it works for files in subdirs too)
@@ -713,6 +760,34 @@ void FileUndoManagerTest::testBatchRename()
     QVERIFY(QFile::exists(srcList.at(2).path()));
 }
 
+void FileUndoManagerTest::testBatchRenameSwap()
+{
+    const QUrl first = QUrl::fromLocalFile(homeTmpDir() + QLatin1String("swap1.txt"));
+    const QUrl second = QUrl::fromLocalFile(homeTmpDir() + QLatin1String("swap2.txt"));
+    createTestFile(first.toLocalFile(), "first");
+    createTestFile(second.toLocalFile(), "second");
+
+    // Swapping names only works as a batch, and so does undoing it
+    KIO::Job *job = KIO::batchRename({first, second}, {second, first}, KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+    FileUndoManager::self()->recordJob(FileUndoManager::BatchRename, {first, second}, QUrl(), job);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+
+    auto readFile = [](const QUrl &url) {
+        QFile file(url.toLocalFile());
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    };
+    QCOMPARE(readFile(first), QByteArray("second"));
+    QCOMPARE(readFile(second), QByteArray("first"));
+
+    doUndo();
+
+    QCOMPARE(readFile(first), QByteArray("first"));
+    QCOMPARE(readFile(second), QByteArray("second"));
+    QVERIFY(QFile::remove(first.toLocalFile()));
+    QVERIFY(QFile::remove(second.toLocalFile()));
+}
+
 void FileUndoManagerTest::testUndoCopyOfDeletedFile()
 {
     const QUrl source = QUrl::fromLocalFile(homeTmpDir() + QLatin1String("source.txt"));
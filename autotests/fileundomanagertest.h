@@ -19,6 +19,7 @@ private Q_SLOTS:
     void cleanupTestCase();
     void testCopyFiles();
     void testMoveFiles();
+    void testCopyAndMoveManyFiles();
     void testCopyDirectory();
     void testCopyEmptyDirectory();
     void testMoveDirectory();
@@ -32,6 +33,7 @@ private Q_SLOTS:
     void testMkpath();
     void testPasteClipboardUndo(); // #318757
     void testBatchRename();
+    void testBatchRenameSwap();
     void testUndoCopyOfDeletedFile();
     void testErrorDuringMoveUndo();
     void testNoUndoForSkipAll();
@@ -0,0 +1,89 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include <forwardingworkerbase_p.h>
+
+class ForwardingWorkerBaseTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testListingUrlRewriter_data();
+    void testListingUrlRewriter();
+    void testListingUrlRewriterInvalid();
+};
+
+void ForwardingWorkerBaseTest::testListingUrlRewriter_data()
+{
+    QTest::addColumn<QUrl>("requestedUrl");
+    QTest::addColumn<QString>("fileName");
+
+    const QList<QUrl> requestedUrls{
+        QUrl(QStringLiteral("remote:/dir")),
+        QUrl(QStringLiteral("remote:/dir/")),
+        QUrl(QStringLiteral("remote:/")),
+        QUrl(QStringLiteral("fish://user@host:22/home/user/a b")),
+        QUrl(QStringLiteral("trash:/0-Ünïcödé%23dir")),
+    };
+    const QStringList fileNames{
+        QStringLiteral("plain.txt"),
+        QStringLiteral("with space"),
+        QStringLiteral("100%"),
+        QStringLiteral("percent%20encoded"),
+        QStringLiteral("hash#tag"),
+        QStringLiteral("question?mark"),
+        QStringLiteral("colon:name"),
+        QStringLiteral("[brackets]"),
+        QStringLiteral("semi;colon+plus&amp=eq"),
+        QStringLiteral("ünïcödé €"),
+        QStringLiteral("tab\tand\nnewline"),
+    };
+
+    for (const QUrl &requestedUrl : requestedUrls) {
+        for (const QString &fileName : fileNames) {
+            QTest::addRow("%s %s", qPrintable(requestedUrl.toString()), qPrintable(fileName)) << requestedUrl << fileName;
+        }
+    }
+}
+
+void ForwardingWorkerBaseTest::testListingUrlRewriter()
+{
+    QFETCH(QUrl, requestedUrl);
+    QFETCH(QString, fileName);
+
+    QUrl entryUrl(QStringLiteral("file:///some/where/"));
+    entryUrl.setPath(entryUrl.path() + fileName);
+
+    // What adjustUDSEntry() does for entries that aren't listed
+    QUrl expected(requestedUrl);
+    expected.setPath(Utils::concatPaths(expected.path(), QUrl(entryUrl.toString()).fileName()));
+
+    const KIO::ListingUrlRewriter rewriter(requestedUrl);
+    QVERIFY(rewriter.isValid());
+    for (const QString &urlStr : {entryUrl.toString(), entryUrl.toString(QUrl::FullyEncoded)}) {
+        QString newUrlStr;
+        QVERIFY(rewriter.rewrite(urlStr, newUrlStr));
+        QCOMPARE(newUrlStr, expected.toString());
+    }
+}
+
+void ForwardingWorkerBaseTest::testListingUrlRewriterInvalid()
+{
+    QString newUrlStr;
+    QVERIFY(!KIO::ListingUrlRewriter().isValid());
+    QVERIFY(!KIO::ListingUrlRewriter(QUrl(QStringLiteral("remote:/dir?query"))).isValid());
+    QVERIFY(!KIO::ListingUrlRewriter(QUrl(QStringLiteral("remote:/dir#fragment"))).rewrite(QStringLiteral("file:///a"), newUrlStr));
+    QVERIFY(!KIO::ListingUrlRewriter(QUrl(QStringLiteral("remote://host"))).isValid());
+
+    // Not something that has a file name to take over
+    QVERIFY(!KIO::ListingUrlRewriter(QUrl(QStringLiteral("remote:/dir"))).rewrite(QStringLiteral("nopath"), newUrlStr));
+}
+
+QTEST_MAIN(ForwardingWorkerBaseTest)
+
+#include "forwardingworkerbasetest.moc"
@@ -11,9 +11,16 @@
 #include "global.h"
 #include "kioglobal_p.h"
 
+#include <QDir>
 #include <QFile>
+#include <QTemporaryDir>
 
 #include <sys/stat.h>
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <sys/mount.h>
+#endif
 
 QTEST_MAIN(GlobalTest)
 
@@ -62,4 +69,57 @@ void GlobalTest::testOtherPermissionConversion()
     QCOMPARE(qPermissions & perms, perms);
 }
 
+void GlobalTest::testFileSystemTypeCache()
+{
+    const QString ramPath = QStringLiteral("/dev/shm");
+    if (KFileSystemType::fileSystemType(ramPath) != KFileSystemType::Ramfs) {
+        QSKIP("No tmpfs at /dev/shm");
+    }
+    const QString tempPath = QDir::tempPath();
+    const KFileSystemType::Type tempType = KFileSystemType::fileSystemType(tempPath);
+    if (tempType == KFileSystemType::Ramfs) {
+        QSKIP("The temporary directory is on a tmpfs too");
+    }
+
+    // The type is looked up once per device id, whatever the path
+    const qint64 deviceId = 0x7fff0001;
+    QCOMPARE(KIOPrivate::fileSystemType(tempPath, deviceId), tempType);
+    QCOMPARE(KIOPrivate::fileSystemType(ramPath, deviceId), tempType);
+
+    // Without a device id, the path is always looked up
+    QCOMPARE(KIOPrivate::fileSystemType(ramPath), KFileSystemType::Ramfs);
+    QCOMPARE(KIOPrivate::fileSystemType(ramPath, 0x7fff0002), KFileSystemType::Ramfs);
+}
+
+void GlobalTest::testFileSystemTypeCacheMountChange()
+{
+#ifdef Q_OS_LINUX
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const KFileSystemType::Type type = KFileSystemType::fileSystemType(dir.path());
+    if (type == KFileSystemType::Ramfs) {
+        QSKIP("The temporary directory is on a tmpfs already");
+    }
+
+    const qint64 deviceId = 0x7fff0003;
+    QCOMPARE(KIOPrivate::fileSystemType(dir.path(), deviceId), type);
+
+    const QByteArray mountPoint = QFile::encodeName(dir.path());
+    if (::mount("tmpfs", mountPoint.constData(), "tmpfs", 0, nullptr) != 0) {
+        QSKIP(qPrintable(QStringLiteral("Can't mount a tmpfs: %1").arg(QString::fromLocal8Bit(strerror(errno)))));
+    }
+
+    // Mounting invalidates the cached types
+    const bool found = QTest::qWaitFor(
+        [&]() {
+            return KIOPrivate::fileSystemType(dir.path(), deviceId) == KFileSystemType::Ramfs;
+        },
+        3000);
+    QVERIFY(::umount(mountPoint.constData()) == 0);
+    QVERIFY(found);
+#else
+    QSKIP("Only implemented on Linux");
+#endif
+}
+
 #include "moc_globaltest.cpp"
@@ -23,6 +23,8 @@ private Q_SLOTS:
     void testUserPermissionConversion();
     void testGroupPermissionConversion();
     void testOtherPermissionConversion();
+    void testFileSystemTypeCache();
+    void testFileSystemTypeCacheMountChange();
 };
 
 #endif
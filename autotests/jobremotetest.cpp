@@ -25,6 +25,7 @@
 #include <kio/statjob.h>
 #include <kio/storedtransferjob.h>
 #include <kprotocolinfo.h>
+#include <kprotocolmanager.h>
 // #include "kiotesthelper.h" // createTestFile etc.
 
 QTEST_MAIN(JobRemoteTest)
@@ -479,4 +480,139 @@ void JobRemoteTest::slotFileJob4Truncated(KIO::Job *job, KIO::filesize_t length)
     }
 }
 
+void JobRemoteTest::openFileReadv()
+{
+    QUrl u(remoteTmpUrl());
+    u.setPath(u.path() + "openFileReadv");
+    if (!KProtocolManager::supportsVectoredReading(u)) {
+        QSKIP("Protocol doesn't support vectored reading");
+    }
+
+    KIO::StoredTransferJob *putJob = KIO::storedPut(QByteArray("test1test2test3test4test5"), u, 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    putJob->setUiDelegate(nullptr);
+    QVERIFY(putJob->exec());
+
+    QList<QByteArray> chunks;
+    fileJob = KIO::open(u, QIODevice::ReadOnly);
+    fileJob->setUiDelegate(nullptr);
+    connect(fileJob, &KJob::result, this, &JobRemoteTest::slotResult);
+    connect(fileJob, &KIO::FileJob::fileClosed, this, &JobRemoteTest::slotFileJobClose);
+    connect(fileJob, &KIO::FileJob::open, this, [this]() {
+        // Out of order, and the last range extends past the end of the file
+        fileJob->readv({{20, 5}, {0, 5}, {22, 10}});
+    });
+    connect(fileJob, &KIO::FileJob::dataVector, this, [this, &chunks](KIO::Job *, const QList<QByteArray> &data) {
+        chunks = data;
+        fileJob->close();
+    });
+
+    m_result = -1;
+    m_closeSignalCalled = false;
+
+    enterLoop();
+    QCOMPARE(m_result, 0); // no error
+    QVERIFY(m_closeSignalCalled);
+    QCOMPARE(chunks, QList<QByteArray>({"test5", "test1", "st5"}));
+}
+
+void JobRemoteTest::openFileReadvLarge()
+{
+    QUrl u(remoteTmpUrl());
+    u.setPath(u.path() + "openFileReadvLarge");
+    if (!KProtocolManager::supportsVectoredReading(u)) {
+        QSKIP("Protocol doesn't support vectored reading");
+    }
+
+    QByteArray content;
+    for (int i = 0; content.size() < 3 * 1024 * 1024; ++i) {
+        content += QByteArray::number(i) + ' ';
+    }
+    KIO::StoredTransferJob *putJob = KIO::storedPut(content, u, 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    putJob->setUiDelegate(nullptr);
+    QVERIFY(putJob->exec());
+
+    // More data and more ranges than fit a single request to the worker
+    KIO::FileRangeList ranges{{10, 2 * 1024 * 1024}, {0, 10}};
+    QList<QByteArray> expected{content.mid(10, 2 * 1024 * 1024), content.left(10)};
+    for (int i = 0; i < 3000; ++i) {
+        ranges.append({i * 1000, 7});
+        expected.append(content.mid(i * 1000, 7));
+    }
+
+    QList<QList<QByteArray>> answers;
+    fileJob = KIO::open(u, QIODevice::ReadOnly);
+    fileJob->setUiDelegate(nullptr);
+    connect(fileJob, &KJob::result, this, &JobRemoteTest::slotResult);
+    connect(fileJob, &KIO::FileJob::fileClosed, this, &JobRemoteTest::slotFileJobClose);
+    connect(fileJob, &KIO::FileJob::open, this, [this, &ranges, &content]() {
+        fileJob->readv(ranges);
+        fileJob->readv({{content.size() - 3, 10}});
+    });
+    connect(fileJob, &KIO::FileJob::dataVector, this, [this, &answers](KIO::Job *, const QList<QByteArray> &data) {
+        answers.append(data);
+        if (answers.size() == 2) {
+            fileJob->close();
+        }
+    });
+
+    m_result = -1;
+    m_closeSignalCalled = false;
+
+    enterLoop();
+    QCOMPARE(m_result, 0); // no error
+    QVERIFY(m_closeSignalCalled);
+    QCOMPARE(answers.size(), 2);
+    QCOMPARE(answers.at(0).size(), expected.size());
+    QVERIFY(answers.at(0) == expected);
+    QCOMPARE(answers.at(1), QList<QByteArray>{content.right(3)});
+}
+
+void JobRemoteTest::openFileReadAhead()
+{
+    QUrl u(remoteTmpUrl());
+    u.setPath(u.path() + "openFileReadAhead");
+    if (!KProtocolManager::supportsVectoredReading(u)) {
+        QSKIP("Protocol doesn't support vectored reading");
+    }
+
+    KIO::StoredTransferJob *putJob = KIO::storedPut(QByteArray("test1test2test3test4test5"), u, 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    putJob->setUiDelegate(nullptr);
+    QVERIFY(putJob->exec());
+
+    m_data = QByteArray();
+    QList<KIO::filesize_t> positions;
+    fileJob = KIO::open(u, QIODevice::ReadOnly);
+    fileJob->setUiDelegate(nullptr);
+    connect(fileJob, &KJob::result, this, &JobRemoteTest::slotResult);
+    connect(fileJob, &KIO::FileJob::fileClosed, this, &JobRemoteTest::slotFileJobClose);
+    connect(fileJob, &KIO::FileJob::open, this, [this]() {
+        fileJob->setReadAheadDepth(2);
+        QCOMPARE(fileJob->readAheadDepth(), 2);
+        fileJob->seek(5);
+    });
+    connect(fileJob, &KIO::FileJob::position, this, [this, &positions](KIO::Job *, KIO::filesize_t offset) {
+        positions.append(offset);
+        if (offset == 5) {
+            fileJob->read(3);
+        }
+    });
+    connect(fileJob, &KIO::FileJob::data, this, [this](KIO::Job *, const QByteArray &data) {
+        if (data.isEmpty()) { // EOD
+            fileJob->close();
+            return;
+        }
+        m_data.append(data);
+        fileJob->read(3);
+    });
+
+    m_result = -1;
+    m_closeSignalCalled = false;
+
+    enterLoop();
+    QCOMPARE(m_result, 0); // no error
+    QVERIFY(m_closeSignalCalled);
+    QCOMPARE(positions, QList<KIO::filesize_t>({0, 5}));
+    QCOMPARE(m_data, QByteArray("test2test3test4test5"));
+}
+
 #include "moc_jobremotetest.cpp"
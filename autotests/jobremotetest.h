@@ -47,6 +47,9 @@ private Q_SLOTS:
     void openFileReading();
     void openFileRead0Bytes();
     void openFileTruncating();
+    void openFileReadv();
+    void openFileReadvLarge();
+    void openFileReadAhead();
 
     // void calculateRemainingSeconds();
 
@@ -10,10 +10,12 @@
 
 #include "kio/job.h"
 #include "kiotesthelper.h" // createTestFile etc.
+#include <kio/checksumjob.h>
 #include <kio/chmodjob.h>
 #include <kio/copyjob.h>
 #include <kio/deletejob.h>
 #include <kio/directorysizejob.h>
+#include <kio/filecopyjob.h>
 #include <kio/statjob.h>
 #include <kmountpoint.h>
 #include <kprotocolinfo.h>
@@ -22,6 +24,7 @@
 #include <KLocalizedString>
 
 #include <QBuffer>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDir>
 #include <QElapsedTimer>
@@ -36,6 +39,7 @@
 #include <QTimer>
 #include <QUrl>
 #include <QVariant>
+#include <qplatformdefs.h>
 
 #ifndef Q_OS_WIN
 #include <unistd.h> // for readlink
@@ -172,6 +176,35 @@ void JobTest::storedGet()
     QVERIFY(!spyPercent.isEmpty());
 }
 
+void JobTest::storedGetRange()
+{
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    createTestFile(filePath);
+    QUrl u = QUrl::fromLocalFile(filePath);
+
+    // Only the first bytes, as used for MIME type sniffing
+    KIO::StoredTransferJob *job = KIO::storedGet(u, KIO::NoReload, KIO::HideProgressInfo);
+    job->addMetaData(QStringLiteral("range-end"), QStringLiteral("4"));
+    job->setUiDelegate(nullptr);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+    QCOMPARE(job->data(), QByteArray("Hello"));
+
+    // A range in the middle of the file
+    job = KIO::storedGet(u, KIO::NoReload, KIO::HideProgressInfo);
+    job->addMetaData(QStringLiteral("range-start"), QStringLiteral("6"));
+    job->addMetaData(QStringLiteral("range-end"), QStringLiteral("8"));
+    job->setUiDelegate(nullptr);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+    QCOMPARE(job->data(), QByteArray("wor"));
+
+    // A range past the end of the file
+    job = KIO::storedGet(u, KIO::NoReload, KIO::HideProgressInfo);
+    job->addMetaData(QStringLiteral("range-end"), QStringLiteral("1000"));
+    job->setUiDelegate(nullptr);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+    QCOMPARE(job->data(), QByteArray("Hello\0world", 11));
+}
+
 void JobTest::slotGetResult(KJob *job)
 {
     m_result = job->error();
@@ -271,6 +304,48 @@ void JobTest::storedPut()
     QVERIFY(!spyPercent.isEmpty());
 }
 
+void JobTest::putBigData_data()
+{
+    QTest::addColumn<bool>("fromDataReq");
+
+    QTest::newRow("static data") << false;
+    QTest::newRow("from dataReq") << true;
+}
+
+void JobTest::putBigData()
+{
+    QFETCH(bool, fromDataReq);
+
+    // Above the 14 MiB sent at once, so it's split into several chunks, the last one shorter
+    QByteArray bigData(2 * 14 * 1024 * 1024 + 1234, Qt::Uninitialized);
+    for (qsizetype i = 0; i < bigData.size(); ++i) {
+        bigData[i] = char(i % 251);
+    }
+
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    const QUrl url = QUrl::fromLocalFile(filePath);
+    KIO::TransferJob *job;
+    if (fromDataReq) {
+        job = KIO::put(url, 0600, KIO::Overwrite | KIO::HideProgressInfo);
+        bool sent = false;
+        connect(job, &KIO::TransferJob::dataReq, this, [&bigData, &sent](KIO::Job *, QByteArray &data) {
+            if (!sent) {
+                data = bigData;
+                sent = true;
+            }
+        });
+    } else {
+        job = KIO::storedPut(bigData, url, 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    }
+    job->setUiDelegate(nullptr);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.size(), bigData.size());
+    QVERIFY(file.readAll() == bigData);
+}
+
 void JobTest::storedPutIODevice()
 {
     const QString filePath = homeTmpDir() + "fileFromHome";
@@ -496,6 +571,190 @@ void JobTest::asyncStoredPutReadyReadAfterFinish()
     QTRY_VERIFY(jobFinished);
 }
 
+void JobTest::putDataCreditWindow_data()
+{
+    QTest::addColumn<QString>("window");
+
+    QTest::newRow("one request per chunk") << QStringLiteral("0");
+    QTest::newRow("window of one chunk") << QStringLiteral("1");
+    QTest::newRow("default") << QString();
+    QTest::newRow("above the worker's maximum") << QStringLiteral("1000");
+}
+
+void JobTest::putDataCreditWindow()
+{
+    QFETCH(QString, window);
+
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    KIO::TransferJob *job = KIO::put(QUrl::fromLocalFile(filePath), 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    if (!window.isEmpty()) {
+        job->addMetaData(QStringLiteral("DataCreditWindow"), window);
+    }
+    job->setUiDelegate(nullptr);
+
+    QByteArray expected;
+    int chunks = 0;
+    connect(job, &KIO::TransferJob::dataReq, this, [&expected, &chunks](KIO::Job *, QByteArray &data) {
+        if (chunks == 100) {
+            data.clear();
+            return;
+        }
+        data = QByteArray::number(chunks++) + QByteArray(1000, 'x') + '\n';
+        expected += data;
+    });
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+    QCOMPARE(chunks, 100);
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), expected);
+}
+
+void JobTest::dataCreditWindowOnlyForPuts()
+{
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    const QUrl url = QUrl::fromLocalFile(filePath);
+
+    KIO::StoredTransferJob *putJob = KIO::storedPut(QByteArray("Hello"), url, 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    putJob->setUiDelegate(nullptr);
+    QVERIFY2(putJob->exec(), qPrintable(putJob->errorString()));
+    QVERIFY(putJob->outgoingMetaData().contains(QStringLiteral("DataCreditWindow")));
+
+    // Nothing is uploaded
+    KIO::StoredTransferJob *getJob = KIO::storedGet(url, KIO::NoReload, KIO::HideProgressInfo);
+    getJob->setUiDelegate(nullptr);
+    QVERIFY2(getJob->exec(), qPrintable(getJob->errorString()));
+    QCOMPARE(getJob->data(), QByteArray("Hello"));
+    QVERIFY(!getJob->outgoingMetaData().contains(QStringLiteral("DataCreditWindow")));
+
+    // The device is read when it has data, not when the worker grants credit
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    KIO::StoredTransferJob *devicePutJob = KIO::storedPut(&buffer, url, 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    devicePutJob->setAsyncDataEnabled(true);
+    devicePutJob->setUiDelegate(nullptr);
+    buffer.write("World");
+    buffer.seek(0);
+    Q_EMIT buffer.readChannelFinished();
+    QVERIFY2(devicePutJob->exec(), qPrintable(devicePutJob->errorString()));
+    QVERIFY(!devicePutJob->outgoingMetaData().contains(QStringLiteral("DataCreditWindow")));
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), QByteArray("World"));
+}
+
+void JobTest::putSuspendedWhileSendingAhead()
+{
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    KIO::TransferJob *job = KIO::put(QUrl::fromLocalFile(filePath), 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+
+    QByteArray expected;
+    int chunks = 0;
+    bool askedWhileSuspended = false;
+    connect(job, &KIO::TransferJob::dataReq, this, [&](KIO::Job *job, QByteArray &data) {
+        askedWhileSuspended = askedWhileSuspended || job->isSuspended();
+        if (chunks == 20) {
+            data.clear();
+            return;
+        }
+        data = QByteArray::number(chunks++) + QByteArray(1000, 'x') + '\n';
+        expected += data;
+        // Like FileCopyJob does when its buffer is drained, with credit left
+        if (chunks == 3 || chunks == 11) {
+            job->suspend();
+            QTimer::singleShot(100, job, [job]() {
+                job->resume();
+            });
+        }
+    });
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+    QVERIFY(!askedWhileSuspended);
+    QCOMPARE(chunks, 20);
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), expected);
+}
+
+void JobTest::putErrorDropsDataSentAhead()
+{
+    // The worker fails when opening the destination after the first chunk,
+    // while the job already sent the rest of its credit window
+    KIO::TransferJob *job = KIO::put(QUrl::fromLocalFile(homeTmpDir() + "doesNotExist/fileFromHome"), 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+    int chunks = 0;
+    connect(job, &KIO::TransferJob::dataReq, this, [&chunks](KIO::Job *, QByteArray &data) {
+        data = QByteArray(1000, 'x');
+        ++chunks;
+    });
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), KIO::ERR_CANNOT_OPEN_FOR_WRITING);
+    QVERIFY(chunks > 1);
+
+    // The idle worker gets the next command, the leftover chunks must not end up in it
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    KIO::StoredTransferJob *putJob = KIO::storedPut(QByteArray("after the error"), QUrl::fromLocalFile(filePath), 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    putJob->setUiDelegate(nullptr);
+    QVERIFY2(putJob->exec(), qPrintable(putJob->errorString()));
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), QByteArray("after the error"));
+}
+
+void JobTest::putWriteBehindPreallocated_data()
+{
+    QTest::addColumn<QString>("sizeMetaData");
+
+    // 5 MiB are sent, the part above 1 MiB goes through the write-behind thread
+    QTest::newRow("unknown size") << QString();
+    QTest::newRow("exact size") << QString::number(5 * 1024 * 1024);
+    // Preallocated more than the data that arrives, e.g. when the source shrank
+    QTest::newRow("short write") << QString::number(8 * 1024 * 1024);
+}
+
+void JobTest::putWriteBehindPreallocated()
+{
+    QFETCH(QString, sizeMetaData);
+
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    KIO::TransferJob *job = KIO::put(QUrl::fromLocalFile(filePath), 0600, KIO::Overwrite | KIO::HideProgressInfo);
+    if (!sizeMetaData.isEmpty()) {
+        job->addMetaData(QStringLiteral("size"), sizeMetaData);
+    }
+    job->setUiDelegate(nullptr);
+
+    QCryptographicHash expected(QCryptographicHash::Sha1);
+    int chunks = 0;
+    connect(job, &KIO::TransferJob::dataReq, this, [&expected, &chunks](KIO::Job *, QByteArray &data) {
+        if (chunks == 80) {
+            data.clear();
+            return;
+        }
+        data = QByteArray(64 * 1024, 'a' + chunks++ % 26);
+        expected.addData(data);
+    });
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+    QCOMPARE(chunks, 80);
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.size(), 5 * 1024 * 1024);
+    QCryptographicHash actual(QCryptographicHash::Sha1);
+    QVERIFY(actual.addData(&file));
+    QCOMPARE(actual.result(), expected.result());
+
+#ifndef Q_OS_WIN
+    // Nothing that was reserved beyond the data is kept. Some slack is fine,
+    // filesystems round up and may keep some blocks of their own.
+    QT_STATBUF buff;
+    QCOMPARE(QT_STAT(QFile::encodeName(filePath).constData(), &buff), 0);
+    QVERIFY2(qint64(buff.st_blocks) * 512 < file.size() + 1024 * 1024, qPrintable(QString::number(qint64(buff.st_blocks) * 512)));
+#endif
+}
+
 static QHash<QString, QString> getSampleXattrs()
 {
     QHash<QString, QString> attrs;
@@ -2091,6 +2350,75 @@ void JobTest::chmodFileError()
     QFile::remove(filePath);
 }
 
+#ifdef Q_OS_UNIX
+void JobTest::chmodRecursive()
+{
+    const QString dirPath = homeTmpDir() + "dirForChmodRecursive";
+    QDir().mkpath(dirPath + "/subdir");
+    createTestFile(dirPath + "/file");
+    createTestFile(dirPath + "/script");
+    createTestFile(dirPath + "/subdir/file");
+    QVERIFY(QFile::link(dirPath + "/file", dirPath + "/link"));
+    QCOMPARE(::chmod(QFile::encodeName(dirPath).constData(), 0700), 0);
+    QCOMPARE(::chmod(QFile::encodeName(dirPath + "/file").constData(), 0600), 0);
+    QCOMPARE(::chmod(QFile::encodeName(dirPath + "/script").constData(), 0700), 0);
+    QCOMPARE(::chmod(QFile::encodeName(dirPath + "/subdir").constData(), 0700), 0);
+    QCOMPARE(::chmod(QFile::encodeName(dirPath + "/subdir/file").constData(), 0600), 0);
+
+    // Give read and execute permissions to group and others
+    KFileItemList items({KFileItem(QUrl::fromLocalFile(dirPath))});
+    KIO::Job *job = KIO::chmod(items, 0755, 0077, QString(), QString(), true, KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+    QCOMPARE(job->processedAmount(KJob::Files), 5ULL);
+
+    auto permissions = [](const QString &path) {
+        QT_STATBUF buff;
+        QT_LSTAT(QFile::encodeName(path).constData(), &buff);
+        return QString::number(buff.st_mode & 07777, 8);
+    };
+    QCOMPARE(permissions(dirPath), QStringLiteral("755"));
+    QCOMPARE(permissions(dirPath + "/subdir"), QStringLiteral("755"));
+    // Only files that were executable already get the "x" bits (chmod +X)
+    QCOMPARE(permissions(dirPath + "/file"), QStringLiteral("644"));
+    QCOMPARE(permissions(dirPath + "/script"), QStringLiteral("755"));
+    QCOMPARE(permissions(dirPath + "/subdir/file"), QStringLiteral("644"));
+
+    QVERIFY(QDir(dirPath).removeRecursively());
+}
+
+void JobTest::chmodRecursiveUnreadableSubdir()
+{
+    const QString dirPath = homeTmpDir() + "dirForChmodRecursiveUnreadable";
+    QDir().mkpath(dirPath + "/locked");
+    createTestFile(dirPath + "/file");
+    createTestFile(dirPath + "/locked/file");
+    QCOMPARE(::chmod(QFile::encodeName(dirPath).constData(), 0700), 0);
+    QCOMPARE(::chmod(QFile::encodeName(dirPath + "/file").constData(), 0400), 0);
+    QCOMPARE(::chmod(QFile::encodeName(dirPath + "/locked/file").constData(), 0400), 0);
+    QCOMPARE(::chmod(QFile::encodeName(dirPath + "/locked").constData(), 0000), 0);
+
+    // u+rwX: the locked directory has to be opened up before it can be read
+    KFileItemList items({KFileItem(QUrl::fromLocalFile(dirPath))});
+    KIO::Job *job = KIO::chmod(items, 0700, 0700, QString(), QString(), true, KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+    QCOMPARE(job->processedAmount(KJob::Files), 4ULL);
+
+    auto permissions = [](const QString &path) {
+        QT_STATBUF buff;
+        QT_LSTAT(QFile::encodeName(path).constData(), &buff);
+        return QString::number(buff.st_mode & 07777, 8);
+    };
+    QCOMPARE(permissions(dirPath), QStringLiteral("700"));
+    QCOMPARE(permissions(dirPath + "/locked"), QStringLiteral("700"));
+    QCOMPARE(permissions(dirPath + "/file"), QStringLiteral("600"));
+    QCOMPARE(permissions(dirPath + "/locked/file"), QStringLiteral("600"));
+
+    QVERIFY(QDir(dirPath).removeRecursively());
+}
+#endif
+
 void JobTest::mimeType()
 {
 #if 1
@@ -2129,6 +2457,186 @@ void JobTest::mimeTypeError()
     QCOMPARE(spyResult.count(), 1);
 }
 
+void JobTest::checksum()
+{
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    createTestFile(filePath);
+    const QByteArray data("Hello\0world", 11);
+
+    const QStringList algorithms{QStringLiteral("sha256"), QStringLiteral("md5"), QStringLiteral("unknown")};
+    KIO::ChecksumJob *job = KIO::checksum(QUrl::fromLocalFile(filePath), algorithms, KIO::HideProgressInfo);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+
+    QCOMPARE(job->checksums().size(), 2);
+    QCOMPARE(job->checksum(QStringLiteral("sha256")), QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex()));
+    QCOMPARE(job->checksum(QStringLiteral("md5")), QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex()));
+    QVERIFY(job->checksum(QStringLiteral("unknown")).isEmpty());
+}
+
+void JobTest::checksumError()
+{
+    const QString filePath = homeTmpDir() + "doesNotExist";
+    KIO::ChecksumJob *job = KIO::checksum(QUrl::fromLocalFile(filePath), {QStringLiteral("sha256")}, KIO::HideProgressInfo);
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), KIO::ERR_DOES_NOT_EXIST);
+
+    createTestFile(filePath);
+    job = KIO::checksum(QUrl::fromLocalFile(filePath), {QStringLiteral("unknown")}, KIO::HideProgressInfo);
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), KIO::ERR_UNSUPPORTED_ACTION);
+    QVERIFY(QFile::remove(filePath));
+}
+
+void JobTest::copyFileVerifyChecksums()
+{
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    const QString dest = otherTmpDir() + "fileFromHome_verified";
+    createTestFile(filePath);
+    QFile::remove(dest);
+
+    KIO::CopyJob *job = KIO::copy(QUrl::fromLocalFile(filePath), QUrl::fromLocalFile(dest), KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+    job->setVerifyChecksums(true);
+    QSignalSpy spyCopyingDone(job, &KIO::CopyJob::copyingDone);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+
+    QCOMPARE(spyCopyingDone.count(), 1);
+    QVERIFY(QFile::exists(filePath));
+    QVERIFY(QFile::exists(dest));
+    QVERIFY(QFile::remove(dest));
+}
+
+void JobTest::moveFileVerifyChecksums()
+{
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    const QString dest = otherTmpDir() + "fileFromHome_verified";
+    createTestFile(filePath);
+    // An existing destination makes the direct rename fail, even on the same partition,
+    // so the file is copied, verified and then deleted
+    createTestFile(dest);
+
+    KIO::CopyJob *job = KIO::move(QUrl::fromLocalFile(filePath), QUrl::fromLocalFile(dest), KIO::Overwrite | KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+    job->setVerifyChecksums(true);
+    QSignalSpy spyCopyingDone(job, &KIO::CopyJob::copyingDone);
+    QVERIFY2(job->exec(), qPrintable(job->errorString()));
+
+    QCOMPARE(spyCopyingDone.count(), 1);
+    QVERIFY(!spyCopyingDone.at(0).at(5).toBool()); // not renamed
+    QVERIFY(!QFile::exists(filePath));
+    QFile destFile(dest);
+    QVERIFY(destFile.open(QIODevice::ReadOnly));
+    QCOMPARE(destFile.readAll(), QByteArray("Hello\0world", 11));
+    destFile.close();
+    QVERIFY(QFile::remove(dest));
+}
+
+namespace
+{
+// Changes the source file once the copy of it is about to start, after its checksum was taken
+class ChangeSourceBeforeCopy : public QObject
+{
+public:
+    explicit ChangeSourceBeforeCopy(const QString &filePath)
+        : m_filePath(filePath)
+    {
+    }
+
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::ChildAdded && qobject_cast<KIO::FileCopyJob *>(static_cast<QChildEvent *>(event)->child())) {
+            QFile file(m_filePath);
+            if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+                file.write("changed");
+                changed = true;
+            }
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+    bool changed = false;
+
+private:
+    const QString m_filePath;
+};
+}
+
+void JobTest::moveFileVerifyChecksumsMismatch()
+{
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    const QString dest = otherTmpDir() + "fileFromHome_verified";
+    createTestFile(filePath);
+    createTestFile(dest);
+
+    KIO::CopyJob *job = KIO::move(QUrl::fromLocalFile(filePath), QUrl::fromLocalFile(dest), KIO::Overwrite | KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+    job->setVerifyChecksums(true);
+    ChangeSourceBeforeCopy changeSource(filePath);
+    job->installEventFilter(&changeSource);
+    QSignalSpy spyCopyingDone(job, &KIO::CopyJob::copyingDone);
+    QVERIFY(!job->exec());
+    QVERIFY(changeSource.changed);
+
+    QCOMPARE(job->error(), KIO::ERR_CHECKSUM_MISMATCH);
+    QCOMPARE(spyCopyingDone.count(), 0);
+    // The copy didn't check out, so the source must still be there
+    QFile sourceFile(filePath);
+    QVERIFY(sourceFile.open(QIODevice::ReadOnly));
+    QCOMPARE(sourceFile.readAll(), QByteArray("Hello\0worldchanged", 18));
+    sourceFile.close();
+    QVERIFY(QFile::remove(filePath));
+    QFile::remove(dest);
+}
+
+void JobTest::verifyChecksumsNoCommonAlgorithm_data()
+{
+    QTest::addColumn<bool>("move");
+
+    QTest::newRow("copy") << false;
+    QTest::newRow("move") << true;
+}
+
+void JobTest::verifyChecksumsNoCommonAlgorithm()
+{
+    QFETCH(bool, move);
+
+    // Like an upload to a server that only stores MD5 checksums, while the local source is hashed with SHA256
+    extern KIOCORE_EXPORT QStringList kio_copyjob_dest_checksum_algorithms;
+    kio_copyjob_dest_checksum_algorithms = QStringList{QStringLiteral("md5")};
+    ScopedCleaner cleaner([] {
+        kio_copyjob_dest_checksum_algorithms.clear();
+    });
+
+    const QString filePath = homeTmpDir() + "fileFromHome";
+    const QString dest = otherTmpDir() + "fileFromHome_verified";
+    createTestFile(filePath);
+    createTestFile(dest);
+
+    const QUrl srcUrl = QUrl::fromLocalFile(filePath);
+    const QUrl destUrl = QUrl::fromLocalFile(dest);
+    KIO::CopyJob *job = move ? KIO::move(srcUrl, destUrl, KIO::Overwrite | KIO::HideProgressInfo) //
+                             : KIO::copy(srcUrl, destUrl, KIO::Overwrite | KIO::HideProgressInfo);
+    job->setUiDelegate(nullptr);
+    job->setVerifyChecksums(true);
+    QSignalSpy spyWarning(job, &KJob::warning);
+    if (move) {
+        // The copy can't be verified, so the source is kept
+        QVERIFY(!job->exec());
+        QCOMPARE(job->error(), KIO::ERR_CANNOT_DELETE_ORIGINAL);
+    } else {
+        QVERIFY2(job->exec(), qPrintable(job->errorString()));
+        QCOMPARE(spyWarning.count(), 1);
+    }
+
+    QVERIFY(QFile::exists(filePath));
+    QFile destFile(dest);
+    QVERIFY(destFile.open(QIODevice::ReadOnly));
+    QCOMPARE(destFile.readAll(), QByteArray("Hello\0world", 11));
+    destFile.close();
+    QVERIFY(QFile::remove(dest));
+    QVERIFY(QFile::remove(filePath));
+}
+
 void JobTest::moveFileDestAlreadyExists_data()
 {
     QTest::addColumn<bool>("autoSkip");
@@ -36,9 +36,12 @@ private Q_SLOTS:
 
     // Local tests (kio_file only)
     void storedGet();
+    void storedGetRange();
     void put();
     void putPermissionKept();
     void storedPut();
+    void putBigData_data();
+    void putBigData();
     void storedPutIODevice();
     void storedPutIODeviceFile();
     void storedPutIODeviceTempFile();
@@ -46,6 +49,13 @@ private Q_SLOTS:
     void storedPutIODeviceSlowDevice();
     void storedPutIODeviceSlowDeviceBigChunk();
     void asyncStoredPutReadyReadAfterFinish();
+    void putDataCreditWindow_data();
+    void putDataCreditWindow();
+    void putSuspendedWhileSendingAhead();
+    void dataCreditWindowOnlyForPuts();
+    void putErrorDropsDataSentAhead();
+    void putWriteBehindPreallocated_data();
+    void putWriteBehindPreallocated();
     void copyFileToSamePartition();
     void testCopyFilePermissionsToSamePartition();
     void copyDirectoryToSamePartition();
@@ -100,8 +110,19 @@ private Q_SLOTS:
     void chmodSticky();
 #endif
     void chmodFileError();
+#ifdef Q_OS_UNIX
+    void chmodRecursive();
+    void chmodRecursiveUnreadableSubdir();
+#endif
     void mimeType();
     void mimeTypeError();
+    void checksum();
+    void checksumError();
+    void copyFileVerifyChecksums();
+    void moveFileVerifyChecksums();
+    void moveFileVerifyChecksumsMismatch();
+    void verifyChecksumsNoCommonAlgorithm_data();
+    void verifyChecksumsNoCommonAlgorithm();
     void calculateRemainingSeconds();
     void moveFileDestAlreadyExists_data();
     void moveFileDestAlreadyExists();
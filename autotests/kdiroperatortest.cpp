@@ -8,8 +8,11 @@
 #include <KConfigGroup>
 #include <KDirLister>
 #include <KSharedConfig>
+#include <QAbstractItemView>
 #include <QDir>
+#include <QFile>
 #include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QTest>
 #include <QTreeView>
 #include <kdiroperator.h>
@@ -254,6 +257,37 @@ private Q_SLOTS:
         QVERIFY(dirOp.selectedItems().isEmpty());
     }
 
+    // The icon view lays out huge directories in batches, the current item has to be
+    // scrolled to even if it wasn't laid out yet when it was selected
+    void testCurrentItemVisibleInLargeDir()
+    {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        const int fileCount = 3000;
+        for (int i = 0; i < fileCount; ++i) {
+            QFile file(tempDir.filePath(QString::asprintf("file%04d.txt", i)));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+
+        KDirOperator dirOp(QUrl::fromLocalFile(tempDir.path()));
+        dirOp.resize(500, 400);
+        dirOp.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&dirOp));
+
+        QSignalSpy finishedSpy(&dirOp, &KDirOperator::finishedLoading);
+        dirOp.setViewMode(KFile::Default);
+        QVERIFY(finishedSpy.wait(10000));
+
+        const QUrl lastFile = QUrl::fromLocalFile(tempDir.filePath(QString::asprintf("file%04d.txt", fileCount - 1)));
+        dirOp.setCurrentItem(lastFile);
+
+        QAbstractItemView *view = dirOp.view();
+        const QModelIndex current = view->currentIndex();
+        QVERIFY(current.isValid());
+        QTRY_VERIFY(view->viewport()->rect().contains(view->visualRect(current).center()));
+        QCOMPARE(dirOp.selectedItems().at(0).url(), lastFile);
+    }
+
     /**
      * If one copies the location of a file and then paste that into the location bar,
      * the directory browser should show the directory of the file instead of showing an error.
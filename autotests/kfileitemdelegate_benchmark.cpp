@@ -0,0 +1,128 @@
+/*
+    This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include <KDirLister>
+#include <KDirModel>
+#include <KFileItemDelegate>
+
+#include <QFile>
+#include <QImage>
+#include <QListView>
+#include <QPainter>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+#include <memory>
+
+// How many files the benchmarked directory has
+static const int fileCount = 5000;
+
+// Paints and measures all the items of a large directory listed by KDirModel, like an icon view
+// that is scrolled through. The delegate keeps the text layouts, so painting them again is cheaper
+// than the first time, which the "new delegate" rows measure.
+class KFileItemDelegateBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        QVERIFY(m_tempDir.isValid());
+
+        for (int i = 0; i < fileCount; ++i) {
+            QFile file(m_tempDir.filePath(QStringLiteral("a file with a rather long name, number %1.txt").arg(i)));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+
+        m_view.setViewMode(QListView::IconMode);
+        m_view.setWordWrap(true);
+        m_view.setModel(&m_model);
+
+        QSignalSpy spyCompleted(m_model.dirLister(), qOverload<>(&KCoreDirLister::completed));
+        m_model.openUrl(QUrl::fromLocalFile(m_tempDir.path()));
+        QVERIFY(spyCompleted.wait(30000));
+        QCOMPARE(m_model.rowCount(), fileCount);
+    }
+
+    void paint_data()
+    {
+        QTest::addColumn<bool>("newDelegate");
+
+        QTest::newRow("same delegate") << false;
+        QTest::newRow("new delegate") << true;
+    }
+
+    void paint()
+    {
+        QFETCH(bool, newDelegate);
+
+        const QStyleOptionViewItem option = viewOption();
+        QImage image(option.rect.size(), QImage::Format_ARGB32_Premultiplied);
+        auto delegate = std::make_unique<KFileItemDelegate>();
+
+        QBENCHMARK {
+            if (newDelegate) {
+                delegate = std::make_unique<KFileItemDelegate>();
+            }
+            image.fill(Qt::transparent);
+            QPainter painter(&image);
+            for (int row = 0; row < fileCount; ++row) {
+                delegate->paint(&painter, option, m_model.index(row, KDirModel::Name));
+            }
+        }
+    }
+
+    void sizeHint_data()
+    {
+        paint_data();
+    }
+
+    void sizeHint()
+    {
+        QFETCH(bool, newDelegate);
+
+        const QStyleOptionViewItem option = viewOption();
+        auto delegate = std::make_unique<KFileItemDelegate>();
+
+        QBENCHMARK {
+            if (newDelegate) {
+                delegate = std::make_unique<KFileItemDelegate>();
+            }
+            for (int row = 0; row < fileCount; ++row) {
+                delegate->sizeHint(option, m_model.index(row, KDirModel::Name));
+            }
+        }
+    }
+
+private:
+    QStyleOptionViewItem viewOption() const
+    {
+        QStyleOptionViewItem option;
+        option.initFrom(&m_view);
+        option.widget = &m_view;
+        option.state = QStyle::State_Enabled;
+        option.features = QStyleOptionViewItem::WrapText | QStyleOptionViewItem::HasDisplay | QStyleOptionViewItem::HasDecoration;
+        option.decorationSize = QSize(48, 48);
+        option.decorationPosition = QStyleOptionViewItem::Top;
+        option.decorationAlignment = Qt::AlignCenter;
+        option.displayAlignment = Qt::AlignHCenter | Qt::AlignTop;
+        option.rect = QRect(0, 0, 120, 120);
+        return option;
+    }
+
+    QTemporaryDir m_tempDir;
+    KDirModel m_model;
+    QListView m_view;
+};
+
+QTEST_MAIN(KFileItemDelegateBenchmark)
+
+#include "kfileitemdelegate_benchmark.moc"
@@ -0,0 +1,124 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KFileItemDelegate>
+
+#include <QImage>
+#include <QListView>
+#include <QPainter>
+#include <QStandardItemModel>
+#include <QStandardPaths>
+#include <QTest>
+
+// What the layout of a label depends on
+struct Label {
+    QString text = QStringLiteral("a rather long file name that has to be wrapped.txt");
+    int width = 96;
+    QTextOption::WrapMode wrapMode = QTextOption::WrapAtWordBoundaryOrAnywhere;
+    int pointSize = 10;
+};
+Q_DECLARE_METATYPE(Label)
+
+class KFileItemDelegateTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void changedLabelShouldGetNewLayout_data();
+    void changedLabelShouldGetNewLayout();
+
+private:
+    QStyleOptionViewItem viewOption(KFileItemDelegate &delegate, const Label &label);
+    QImage render(KFileItemDelegate &delegate, const Label &label);
+
+    QStandardItemModel m_model;
+    QListView m_view;
+};
+
+void KFileItemDelegateTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    m_model.appendRow(new QStandardItem(QStringLiteral("file")));
+    m_view.setModel(&m_model);
+}
+
+// Sets up the model and the delegate for @p label, returns the option to paint it with
+QStyleOptionViewItem KFileItemDelegateTest::viewOption(KFileItemDelegate &delegate, const Label &label)
+{
+    m_model.item(0)->setText(label.text);
+    delegate.setWrapMode(label.wrapMode);
+    delegate.setMaximumSize(QSize(label.width, 1000));
+
+    QStyleOptionViewItem option;
+    option.initFrom(&m_view);
+    option.widget = &m_view;
+    option.state = QStyle::State_Enabled;
+    option.font.setPointSize(label.pointSize);
+    option.features = QStyleOptionViewItem::WrapText | QStyleOptionViewItem::HasDisplay;
+    option.decorationSize = QSize(32, 32);
+    option.decorationPosition = QStyleOptionViewItem::Top;
+    option.decorationAlignment = Qt::AlignCenter;
+    option.displayAlignment = Qt::AlignHCenter | Qt::AlignTop;
+    option.rect = QRect(0, 0, label.width, 200);
+    return option;
+}
+
+QImage KFileItemDelegateTest::render(KFileItemDelegate &delegate, const Label &label)
+{
+    const QStyleOptionViewItem option = viewOption(delegate, label);
+    QImage image(option.rect.size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    delegate.paint(&painter, option, m_model.index(0, 0));
+    return image;
+}
+
+void KFileItemDelegateTest::changedLabelShouldGetNewLayout_data()
+{
+    QTest::addColumn<Label>("changed");
+
+    Label label;
+    label.text = QStringLiteral("short.txt");
+    QTest::newRow("text") << label;
+
+    label = Label();
+    label.width = 200;
+    QTest::newRow("width") << label;
+
+    label = Label();
+    label.wrapMode = QTextOption::NoWrap;
+    QTest::newRow("wrap mode") << label;
+
+    label = Label();
+    label.pointSize = 16;
+    QTest::newRow("font") << label;
+}
+
+void KFileItemDelegateTest::changedLabelShouldGetNewLayout()
+{
+    QFETCH(Label, changed);
+
+    // Fill the caches of the delegate with the layout of the initial label
+    KFileItemDelegate delegate;
+    const Label initial;
+    const QSize initialSizeHint = delegate.sizeHint(viewOption(delegate, initial), m_model.index(0, 0));
+    const QImage initialImage = render(delegate, initial);
+
+    // The changed label looks like it does with a delegate that never saw the initial one
+    KFileItemDelegate newDelegate;
+    const QSize sizeHint = delegate.sizeHint(viewOption(delegate, changed), m_model.index(0, 0));
+    QCOMPARE(sizeHint, newDelegate.sizeHint(viewOption(newDelegate, changed), m_model.index(0, 0)));
+    const QImage image = render(delegate, changed);
+    QCOMPARE(image, render(newDelegate, changed));
+
+    // And not like the initial one
+    QVERIFY(sizeHint != initialSizeHint || image.size() != initialImage.size() || image != initialImage);
+}
+
+QTEST_MAIN(KFileItemDelegateTest)
+
+#include "kfileitemdelegatetest.moc"
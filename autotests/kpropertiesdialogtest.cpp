@@ -0,0 +1,105 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KFileItem>
+#include <KPropertiesDialog>
+#include <kio/udsentry.h>
+
+#include <QCryptographicHash>
+#include <QLabel>
+#include <QPushButton>
+#include <QStandardPaths>
+#include <QTest>
+#include <qplatformdefs.h>
+
+class KPropertiesDialogTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void checksumsShouldSupportRemoteFiles();
+    void checksumsShouldComputeRemoteFile();
+    void checksumsShouldHandleRemoteError();
+};
+
+static KFileItem remoteItem(const QUrl &url, mode_t fileType)
+{
+    KIO::UDSEntry entry;
+    entry.fastInsert(KIO::UDSEntry::UDS_NAME, QStringLiteral("file.txt"));
+    entry.fastInsert(KIO::UDSEntry::UDS_FILE_TYPE, fileType);
+    entry.fastInsert(KIO::UDSEntry::UDS_ACCESS, 0644);
+    entry.fastInsert(KIO::UDSEntry::UDS_MIME_TYPE, fileType == S_IFDIR ? QStringLiteral("inode/directory") : QStringLiteral("text/plain"));
+    return KFileItem(entry, url);
+}
+
+static QLabel *labelWithText(QWidget *parent, const QString &text)
+{
+    const auto labels = parent->findChildren<QLabel *>();
+    for (QLabel *label : labels) {
+        if (label->text() == text) {
+            return label;
+        }
+    }
+    return nullptr;
+}
+
+void KPropertiesDialogTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void KPropertiesDialogTest::checksumsShouldSupportRemoteFiles()
+{
+    // Files without a local path get the checksums page, they are downloaded for it
+    const QUrl url(QStringLiteral("data:text/plain,remote"));
+    KPropertiesDialog fileDialog(remoteItem(url, S_IFREG));
+    QVERIFY(fileDialog.findChild<QPushButton *>(QStringLiteral("md5Button")));
+
+    // Directories don't, whether they are remote or not
+    KPropertiesDialog dirDialog(remoteItem(url, S_IFDIR));
+    QVERIFY(!dirDialog.findChild<QPushButton *>(QStringLiteral("md5Button")));
+}
+
+void KPropertiesDialogTest::checksumsShouldComputeRemoteFile()
+{
+    QByteArray content;
+    for (int i = 0; content.size() < 200 * 1024; ++i) {
+        content += QByteArray::number(i) + ' ';
+    }
+    const QUrl url(QStringLiteral("data:text/plain,") + QString::fromLatin1(content.toPercentEncoding()));
+
+    KPropertiesDialog dialog(remoteItem(url, S_IFREG));
+    QPushButton *md5Button = dialog.findChild<QPushButton *>(QStringLiteral("md5Button"));
+    QPushButton *md5CopyButton = dialog.findChild<QPushButton *>(QStringLiteral("md5CopyButton"));
+    QPushButton *sha512Button = dialog.findChild<QPushButton *>(QStringLiteral("sha512Button"));
+    QVERIFY(md5Button && md5CopyButton && sha512Button);
+
+    md5Button->click();
+    QTRY_VERIFY(!md5CopyButton->isHidden());
+    QVERIFY(labelWithText(&dialog, QString::fromLatin1(QCryptographicHash::hash(content, QCryptographicHash::Md5).toHex())));
+
+    // Computed in the same pass
+    sha512Button->click();
+    QVERIFY(labelWithText(&dialog, QString::fromLatin1(QCryptographicHash::hash(content, QCryptographicHash::Sha512).toHex())));
+}
+
+void KPropertiesDialogTest::checksumsShouldHandleRemoteError()
+{
+    KPropertiesDialog dialog(remoteItem(QUrl(QStringLiteral("kpropertiesdialogtest-unknown:/file.txt")), S_IFREG));
+    QPushButton *sha1Button = dialog.findChild<QPushButton *>(QStringLiteral("sha1Button"));
+    QPushButton *sha1CopyButton = dialog.findChild<QPushButton *>(QStringLiteral("sha1CopyButton"));
+    QVERIFY(sha1Button && sha1CopyButton);
+
+    // The request is answered, without a checksum
+    sha1Button->click();
+    QTRY_VERIFY(!sha1CopyButton->isHidden());
+    QVERIFY(!labelWithText(&dialog, QStringLiteral("Calculating...")));
+}
+
+QTEST_MAIN(KPropertiesDialogTest)
+
+#include "kpropertiesdialogtest.moc"
@@ -10,9 +10,17 @@
 #include <KRecentDocument>
 
 #include <QDomDocument>
+#include <QEventLoop>
 #include <QStandardPaths>
 #include <QTemporaryFile>
 #include <QTest>
+#include <QTimer>
+
+static QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
 
 void KRecentDocumentTest::initTestCase()
 {
@@ -154,6 +162,76 @@ void KRecentDocumentTest::testXbelBookmarkMaxEntries()
     }
 }
 
+void KRecentDocumentTest::testXbelBookmarkBatched()
+{
+    KConfigGroup config = KSharedConfig::openConfig()->group(QStringLiteral("RecentDocuments"));
+    config.writeEntry(QStringLiteral("UseRecent"), true);
+    config.writeEntry(QStringLiteral("MaxEntries"), 3);
+
+    QList<QUrl> urls;
+    for (int i = 0; i < 4; ++i) {
+        QFile tempFile(QDir::currentPath() + "/batched File" + QString::number(i));
+        QVERIFY(tempFile.open(QIODevice::WriteOnly));
+        urls << QUrl::fromLocalFile(tempFile.fileName());
+    }
+
+    // Without an event loop, adds are written right away
+    KRecentDocument::add(urls.at(0), QStringLiteral("app-a"));
+    QTest::qWait(5);
+    KRecentDocument::add(urls.at(1), QStringLiteral("app-a"));
+    const QByteArray contentBefore = readFile(m_xbelPath);
+    QVERIFY(contentBefore.contains("batched%20File1"));
+
+    // From an event loop, they are merged and written together a bit later
+    bool writtenRightAway = true;
+    QEventLoop loop;
+    QTimer::singleShot(0, &loop, [&]() {
+        KRecentDocument::add(urls.at(2), QStringLiteral("app-a"));
+        KRecentDocument::add(urls.at(3), QStringLiteral("app-a"));
+        KRecentDocument::add(urls.at(2), QStringLiteral("app-b"));
+        writtenRightAway = readFile(m_xbelPath) != contentBefore;
+        loop.quit();
+    });
+    loop.exec();
+    QVERIFY(!writtenRightAway);
+    QTRY_VERIFY(readFile(m_xbelPath) != contentBefore);
+
+    QDomDocument reader;
+    QVERIFY(reader.setContent(readFile(m_xbelPath)));
+    const auto bookmarks = reader.elementsByTagName("bookmark");
+    // The oldest entry was dropped for the two new ones, in the same write
+    QCOMPARE(bookmarks.length(), 3);
+    QStringList hrefs;
+    for (int i = 0; i < bookmarks.length(); ++i) {
+        hrefs << bookmarks.at(i).toElement().attribute("href");
+    }
+    QCOMPARE(hrefs, QStringList({urls.at(1).toString(QUrl::FullyEncoded), urls.at(2).toString(QUrl::FullyEncoded), urls.at(3).toString(QUrl::FullyEncoded)}));
+
+    const auto apps = bookmarks.at(1).toElement().elementsByTagName("bookmark:application");
+    QCOMPARE(apps.length(), 2);
+    QCOMPARE(apps.at(0).toElement().attribute("name"), QStringLiteral("app-a"));
+    QCOMPARE(apps.at(0).toElement().attribute("count"), QStringLiteral("1"));
+    QCOMPARE(apps.at(1).toElement().attribute("name"), QStringLiteral("app-b"));
+    QCOMPARE(apps.at(1).toElement().attribute("count"), QStringLiteral("1"));
+
+    // recentUrls() sees pending adds
+    QTest::qWait(5);
+    QTimer::singleShot(0, &loop, [&]() {
+        KRecentDocument::add(urls.at(0), QStringLiteral("app-a"));
+        loop.quit();
+    });
+    loop.exec();
+    QVERIFY(KRecentDocument::recentUrls().contains(urls.at(0)));
+
+    // Of the entries written together, the first ones in the file go first
+    QVERIFY(KRecentDocument::clearEntriesOldestEntries(2));
+    QCOMPARE(KRecentDocument::recentUrls(), QList<QUrl>({urls.at(3), urls.at(0)}));
+
+    for (const QUrl &url : std::as_const(urls)) {
+        QFile::remove(url.toLocalFile());
+    }
+}
+
 QTEST_MAIN(KRecentDocumentTest)
 
 #include "moc_krecentdocumenttest.cpp"
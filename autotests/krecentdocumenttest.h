@@ -19,6 +19,7 @@ private Q_SLOTS:
     void cleanup();
     void testXbelBookmark();
     void testXbelBookmarkMaxEntries();
+    void testXbelBookmarkBatched();
 
 private:
     QString m_xbelPath;
@@ -8,6 +8,7 @@
 #include "ksambashare_p.h"
 
 #include <KSambaShareData>
+#include <KUser>
 
 #include <QTest>
 
@@ -57,4 +58,64 @@ void KSambaSharePrivateTest::testParser_data()
                                               << "Comment";
 }
 
+void KSambaSharePrivateTest::testUserShareFileParser()
+{
+    QFETCH(QByteArray, fileData);
+    QFETCH(bool, valid);
+    QFETCH(QString, path);
+    QFETCH(QString, acl);
+
+    const auto share = KSambaSharePrivate::parseUserShareFile(fileData, QStringLiteral("share"));
+
+    QCOMPARE(share.has_value(), valid);
+    if (valid) {
+        QCOMPARE(share->name(), QStringLiteral("share"));
+        QCOMPARE(share->path(), path);
+        QCOMPARE(share->acl(), acl);
+        QCOMPARE(share->guestPermission(), KSambaShareData::GuestsNotAllowed);
+    }
+}
+
+void KSambaSharePrivateTest::testUserShareFileParser_data()
+{
+    QTest::addColumn<QByteArray>("fileData");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<QString>("acl");
+
+    QTest::newRow("Everyone") << QByteArrayLiteral("#VERSION 2\npath=/some/path/\ncomment=\nusershare_acl=S-1-1-0:R,\nguest_ok=n\nsharename=Share\n") << true
+                              << QStringLiteral("/some/path") << QStringLiteral("Everyone:R,");
+
+    const KUser user;
+    const QByteArray userData = "#VERSION 2\npath=/some/path\ncomment=\nusershare_acl=S-1-1-0:R,S-1-22-1-" + QByteArray::number(user.userId().nativeId())
+        + ":F,\nguest_ok=n\nsharename=share\n";
+    QTest::newRow("Unix user") << userData << true << QStringLiteral("/some/path")
+                               << QStringLiteral("Everyone:R,Unix User\\%1:F,").arg(user.loginName());
+
+    // Needs a lookup through Samba, 'net usershare info' is used for these
+    QTest::newRow("Domain user") << QByteArrayLiteral("#VERSION 2\npath=/some/path\ncomment=\nusershare_acl=S-1-5-21-1-2-3-1000:F,\nguest_ok=n\n") << false
+                                 << QString() << QString();
+    QTest::newRow("No path") << QByteArrayLiteral("#VERSION 2\ncomment=\nusershare_acl=S-1-1-0:R,\nguest_ok=n\n") << false << QString() << QString();
+}
+
+void KSambaSharePrivateTest::testTestparmDumpParser()
+{
+    // As printed by 'testparm -s -v --section-name global'
+    const QByteArray dump = QByteArrayLiteral(
+        "[global]\n"
+        "\tusershare allow guests = No\n"
+        "\tusershare max shares = 100\n"
+        "\tusershare path = /var/lib/samba/usershares\n"
+        "\tusershare prefix allow list = \n");
+
+    const QHash<QString, QString> values = KSambaSharePrivate::parseTestparmDump(dump);
+
+    QCOMPARE(values.size(), 4);
+    QCOMPARE(values.value(QStringLiteral("usershare path")), QStringLiteral("/var/lib/samba/usershares"));
+    QCOMPARE(values.value(QStringLiteral("usershare max shares")), QStringLiteral("100"));
+    QCOMPARE(values.value(QStringLiteral("usershare allow guests")), QStringLiteral("No"));
+    QVERIFY(values.contains(QStringLiteral("usershare prefix allow list")));
+    QVERIFY(values.value(QStringLiteral("usershare prefix allow list")).isEmpty());
+}
+
 #include "moc_ksambashareprivatetest.cpp"
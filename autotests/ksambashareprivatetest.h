@@ -17,6 +17,9 @@ private Q_SLOTS:
     void initTestCase();
     void testParser();
     void testParser_data();
+    void testUserShareFileParser();
+    void testUserShareFileParser_data();
+    void testTestparmDumpParser();
 };
 
 #endif // KSAMBASHAREPRIVATETEST_H
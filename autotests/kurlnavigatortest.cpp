@@ -346,4 +346,40 @@ void KUrlNavigatorTest::testInitWithRedundantPathSeparators()
     QCOMPARE(buttonUrl, QUrl::fromLocalFile(QStringLiteral("/home/foo/test")));
 }
 
+static bool hasButtonWithText(QWidget *navigator, const QString &text)
+{
+    const QList<QPushButton *> buttons = navigator->findChildren<QPushButton *>();
+    return std::any_of(buttons.cbegin(), buttons.cend(), [&text](QPushButton *button) {
+        return button->text() == text;
+    });
+}
+
+void KUrlNavigatorTest::testSetPlacesModel()
+{
+    KFilePlacesModel model;
+    const QUrl url = QUrl::fromLocalFile(QDir::tempPath());
+    model.addPlace(QStringLiteral("&Temp"), url);
+    KUrlNavigator navigator(nullptr, url, nullptr);
+    QVERIFY(!hasButtonWithText(&navigator, QStringLiteral("&Temp")));
+    QVERIFY(!navigator.isPlacesSelectorVisible());
+
+    // Like passing the model to the constructor
+    navigator.setPlacesModel(&model);
+    QVERIFY(hasButtonWithText(&navigator, QStringLiteral("&Temp")));
+    QVERIFY(navigator.isPlacesSelectorVisible());
+
+    // A hidden places selector stays hidden
+    navigator.setPlacesSelectorVisible(false);
+    navigator.setPlacesModel(&model);
+    QVERIFY(hasButtonWithText(&navigator, QStringLiteral("&Temp")));
+    QVERIFY(!navigator.isPlacesSelectorVisible());
+
+    navigator.setPlacesModel(nullptr);
+    QVERIFY(!hasButtonWithText(&navigator, QStringLiteral("&Temp")));
+    navigator.setPlacesSelectorVisible(true);
+    QVERIFY(!navigator.isPlacesSelectorVisible());
+
+    model.removePlace(model.closestItem(url));
+}
+
 #include "moc_kurlnavigatortest.cpp"
@@ -38,6 +38,8 @@ private Q_SLOTS:
 
     void testInitWithRedundantPathSeparators();
 
+    void testSetPlacesModel();
+
 private:
     KUrlNavigator *m_navigator;
 };
@@ -12,6 +12,7 @@
 
 #include <KConfigGroup>
 #include <KSharedConfig>
+#include <QDateTime>
 #include <QStandardPaths>
 #include <QTemporaryDir>
 #include <QTest>
@@ -86,6 +87,47 @@ void MimeTypeFinderJobTest::determineMimeType()
     QCOMPARE(job->mimeType(), mimeType);
 }
 
+static void writeFile(const QString &path, const QByteArray &content, const QDateTime &mtime)
+{
+    QFile file(path);
+    QVERIFY2(file.open(QFile::WriteOnly | QFile::Truncate), qPrintable(file.errorString()));
+    QCOMPARE(file.write(content), content.size());
+    QVERIFY(file.setFileTime(mtime, QFileDevice::FileModificationTime));
+}
+
+static QString findMimeType(const QUrl &url)
+{
+    KIO::MimeTypeFinderJob *job = new KIO::MimeTypeFinderJob(url);
+    if (!job->exec()) {
+        return job->errorString();
+    }
+    return job->mimeType();
+}
+
+void MimeTypeFinderJobTest::sniffedMimeTypeShouldBeCached()
+{
+    // No extension, so the MIME type comes from the content
+    QTemporaryDir tempDir;
+    const QString srcFile = tempDir.filePath(QStringLiteral("srcfile"));
+    const QUrl url = QUrl::fromLocalFile(srcFile);
+    const QDateTime mtime = QDateTime::currentDateTime().addSecs(-3600);
+
+    writeFile(srcFile, QByteArrayLiteral("Hello world\n"), mtime);
+    QCOMPARE(findMimeType(url), QStringLiteral("text/plain"));
+
+    // Same size and modification time: the cached type is used, the new content isn't looked at
+    writeFile(srcFile, QByteArrayLiteral("#!/bin/sh\nx\n"), mtime);
+    QCOMPARE(findMimeType(url), QStringLiteral("text/plain"));
+
+    // A new modification time means the file is sniffed again
+    writeFile(srcFile, QByteArrayLiteral("#!/bin/sh\nx\n"), mtime.addSecs(10));
+    QCOMPARE(findMimeType(url), QStringLiteral("application/x-shellscript"));
+
+    // And so does a new size
+    writeFile(srcFile, QByteArrayLiteral("Hello world, again\n"), mtime.addSecs(10));
+    QCOMPARE(findMimeType(url), QStringLiteral("text/plain"));
+}
+
 void MimeTypeFinderJobTest::invalidUrl()
 {
     KIO::MimeTypeFinderJob *job = new KIO::MimeTypeFinderJob(QUrl(":/"), this);
@@ -22,6 +22,8 @@ private Q_SLOTS:
     void determineMimeType_data();
     void determineMimeType();
 
+    void sniffedMimeTypeShouldBeCached();
+
     void invalidUrl();
     void nonExistingFile();
 
@@ -25,6 +25,7 @@
 #endif
 
 #include <KSharedConfig>
+#include <QPointer>
 #include <QStandardPaths>
 #include <QTemporaryFile>
 #include <QTest>
@@ -586,6 +587,39 @@ void OpenUrlJobTest::runDesktopFileDirectly()
     QCOMPARE(readFile(dest), QString{});
 }
 
+void OpenUrlJobTest::desktopFileWithoutType()
+{
+    QTemporaryDir tempDir;
+    const QString filePath = tempDir.path() + QLatin1String("/notype.desktop");
+    {
+        KDesktopFile file(filePath);
+        file.desktopGroup().writeEntry("Name", "No Type");
+        file.desktopGroup().writeEntry("Exec", "echo %u > " + QFile::encodeName(m_tempDir.path()) + "/dest");
+        QVERIFY(file.sync());
+    }
+
+    // The file is checked in a thread, the result must still make it to the job
+    KIO::OpenUrlJob *job = new KIO::OpenUrlJob(QUrl::fromLocalFile(filePath), QStringLiteral("application/x-desktop"), this);
+    job->setRunExecutables(true);
+    QVERIFY(!job->exec());
+    QCOMPARE((int)job->error(), (int)KJob::UserDefinedError);
+    QCOMPARE(job->errorString(), QStringLiteral("The desktop entry file %1 has no Type=... entry.").arg(filePath));
+    QVERIFY(!QFile::exists(m_tempDir.path() + "/dest"));
+}
+
+void OpenUrlJobTest::killWhileCheckingLocalFile()
+{
+    // Deleting the job while the file is checked in a thread must not run anything
+    QPointer<KIO::OpenUrlJob> job = new KIO::OpenUrlJob(QUrl::fromLocalFile(m_fakeService), QStringLiteral("application/x-desktop"), this);
+    job->setRunExecutables(true);
+    job->start(); // the MIME type is known, so this goes straight to the checks
+    QVERIFY(job->kill());
+    QTRY_VERIFY(!job);
+
+    QTest::qWait(500);
+    QVERIFY(!QFile::exists(m_tempDir.path() + "/dest"));
+}
+
 void OpenUrlJobTest::writeApplicationDesktopFile(const QString &filePath, const QByteArray &command)
 {
     KDesktopFile file(filePath);
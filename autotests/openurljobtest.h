@@ -48,6 +48,8 @@ private Q_SLOTS:
 
     void takeOverAfterMimeTypeFound();
     void runDesktopFileDirectly();
+    void desktopFileWithoutType();
+    void killWhileCheckingLocalFile();
 
 private:
     void writeApplicationDesktopFile(const QString &filePath, const QByteArray &cmd);
@@ -0,0 +1,71 @@
+/*
+    This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include <KIO/TransferJob>
+
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+// Uploads through the file worker with and without credit based flow control
+// (see the DataCreditWindow metadata), to measure the cost of one dataReq()
+// round trip per chunk.
+class UploadBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        QVERIFY(m_tempDir.isValid());
+    }
+
+    void put_data()
+    {
+        QTest::addColumn<int>("chunkSize");
+        QTest::addColumn<QString>("window");
+
+        for (int chunkSize : {4 * 1024, 64 * 1024, 1024 * 1024}) {
+            const QByteArray size = QByteArray::number(chunkSize / 1024) + "KiB";
+            QTest::newRow(size + " chunks, stop-and-wait") << chunkSize << QStringLiteral("0");
+            QTest::newRow(size + " chunks, window 8") << chunkSize << QStringLiteral("8");
+        }
+    }
+
+    void put()
+    {
+        QFETCH(int, chunkSize);
+        QFETCH(QString, window);
+
+        static const qint64 totalSize = 64 * 1024 * 1024;
+        const QByteArray chunk(chunkSize, 'x');
+        const QUrl dest = QUrl::fromLocalFile(m_tempDir.filePath(QStringLiteral("upload")));
+
+        QBENCHMARK {
+            qint64 sent = 0;
+            KIO::TransferJob *job = KIO::put(dest, -1, KIO::Overwrite | KIO::HideProgressInfo);
+            job->addMetaData(QStringLiteral("DataCreditWindow"), window);
+            connect(job, &KIO::TransferJob::dataReq, this, [&](KIO::Job *, QByteArray &data) {
+                if (sent < totalSize) {
+                    data = chunk;
+                    sent += chunk.size();
+                }
+            });
+            QVERIFY2(job->exec(), qPrintable(job->errorString()));
+            QCOMPARE(sent, totalSize);
+        }
+    }
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+QTEST_MAIN(UploadBenchmark)
+
+#include "upload_benchmark.moc"
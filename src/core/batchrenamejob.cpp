@@ -9,12 +9,15 @@
 
 #include "copyjob.h"
 #include "job_p.h"
+#include "kprotocolmanager.h"
 
 #include <QMimeDatabase>
+#include <QSet>
 #include <QTimer>
 
 #include <KLocalizedString>
 
+#include <algorithm>
 #include <set>
 
 using namespace KIO;
@@ -75,7 +78,21 @@ public:
         }
     }
 
+    BatchRenameJobPrivate(const QList<QUrl> &src, const QList<QUrl> &dest, JobFlags flags)
+        : JobPrivate()
+        , m_srcList(src)
+        , m_destList(dest)
+        , m_index(0)
+        , m_listIterator(m_srcList.constBegin())
+        , m_allExtensionsDifferent(true)
+        , m_useIndex(false)
+        , m_appendIndex(false)
+        , m_flags(flags)
+    {
+    }
+
     QList<QUrl> m_srcList;
+    QList<QUrl> m_destList; // the new url of each item in m_srcList
     QString m_newName;
     int m_index;
     QChar m_placeHolder;
@@ -87,6 +104,10 @@ public:
     QUrl m_newUrl; // for fileRenamed signal
     const JobFlags m_flags;
     QTimer m_reportTimer;
+    // Renames all items with one command, see WorkerBase::renameBatch()
+    KIO::SimpleJob *m_renameBatchJob = nullptr;
+    qulonglong m_renameBatchProcessed = 0;
+    bool m_renameBatchFailed = false;
 
     Q_DECLARE_PUBLIC(BatchRenameJob)
 
@@ -94,6 +115,10 @@ public:
     void slotReport();
 
     QString indexedName(const QString &name, int index, QChar placeHolder) const;
+    void createDestinations();
+    bool canRenameBatch() const;
+    bool reusesNamesOfBatch() const;
+    void renameBatch();
 
     static inline BatchRenameJob *newJob(const QList<QUrl> &src, const QString &newName, int index, QChar placeHolder, JobFlags flags)
     {
@@ -108,6 +133,20 @@ public:
         }
         return job;
     }
+
+    static inline BatchRenameJob *newJob(const QList<QUrl> &src, const QList<QUrl> &dest, JobFlags flags)
+    {
+        BatchRenameJob *job = new BatchRenameJob(*new BatchRenameJobPrivate(src, dest, flags));
+        job->setUiDelegate(KIO::createDefaultJobUiDelegate());
+        if (!(flags & HideProgressInfo)) {
+            KIO::getJobTracker()->registerJob(job);
+        }
+        if (!(flags & NoPrivilegeExecution)) {
+            job->d_func()->m_privilegeExecutionEnabled = true;
+            job->d_func()->m_operationType = Rename;
+        }
+        return job;
+    }
 };
 
 BatchRenameJob::BatchRenameJob(BatchRenameJobPrivate &dd)
@@ -153,28 +192,88 @@ QString BatchRenameJobPrivate::indexedName(const QString &name, int index, QChar
     return newName;
 }
 
+void BatchRenameJobPrivate::createDestinations()
+{
+    QMimeDatabase db;
+    int index = m_index;
+    m_destList.reserve(m_srcList.count());
+    for (const QUrl &oldUrl : std::as_const(m_srcList)) {
+        QString newName = indexedName(m_newName, index++, m_placeHolder);
+        const QString extension = db.suffixForFileName(oldUrl.path());
+        if (!extension.isEmpty()) {
+            newName += QLatin1Char('.') + extension;
+        }
+
+        QUrl newUrl = oldUrl.adjusted(QUrl::RemoveFilename);
+        newUrl.setPath(newUrl.path() + KIO::encodeFileName(newName));
+        m_destList.append(newUrl);
+    }
+}
+
+bool BatchRenameJobPrivate::canRenameBatch() const
+{
+    if (m_renameBatchFailed || m_srcList.count() < 2 || !KProtocolManager::supportsBatchRenaming(m_srcList.first())) {
+        return false;
+    }
+    // A single worker has to handle all of them
+    const QUrl &first = m_srcList.first();
+    auto sameWorker = [&first](const QUrl &url) {
+        return url.scheme() == first.scheme() && url.authority() == first.authority();
+    };
+    return std::all_of(m_srcList.cbegin(), m_srcList.cend(), sameWorker) && std::all_of(m_destList.cbegin(), m_destList.cend(), sameWorker);
+}
+
+// Whether an item is to take the name of another item of the batch, e.g. when swapping
+// two names. Renaming one by one can't do that, the name is still taken.
+bool BatchRenameJobPrivate::reusesNamesOfBatch() const
+{
+    const QSet<QUrl> sources(m_srcList.cbegin(), m_srcList.cend());
+    for (qsizetype i = 0; i < m_destList.count(); ++i) {
+        const QUrl &dest = m_destList.at(i);
+        if (dest != m_srcList.at(i) && sources.contains(dest)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BatchRenameJobPrivate::renameBatch()
+{
+    Q_Q(BatchRenameJob);
+    KIO_ARGS << m_srcList << m_destList;
+    m_renameBatchJob = SimpleJobPrivate::newJob(m_srcList.first(), CMD_RENAME_BATCH, packedArgs);
+    m_renameBatchJob->setParentJob(q);
+    // The worker reports the number of renamed items as processed size
+    q->connect(m_renameBatchJob, &KJob::processedAmountChanged, q, [this](KJob *, KJob::Unit unit, qulonglong amount) {
+        if (unit == KJob::Bytes) {
+            m_renameBatchProcessed = amount;
+        }
+    });
+    m_oldUrl = m_srcList.first();
+    m_newUrl = m_destList.first();
+    q->addSubjob(m_renameBatchJob);
+}
+
 void BatchRenameJobPrivate::slotStart()
 {
     Q_Q(BatchRenameJob);
 
     if (m_listIterator == m_srcList.constBegin()) { //  emit total
         q->setTotalAmount(KJob::Items, m_srcList.count());
+        if (m_destList.isEmpty()) {
+            createDestinations();
+        }
+        if (canRenameBatch()) {
+            renameBatch();
+            return;
+        }
     }
 
     if (m_listIterator != m_srcList.constEnd()) {
-        QString newName = indexedName(m_newName, m_index, m_placeHolder);
-        const QUrl oldUrl = *m_listIterator;
-        QMimeDatabase db;
-        const QString extension = db.suffixForFileName(oldUrl.path());
-        if (!extension.isEmpty()) {
-            newName += QLatin1Char('.') + extension;
-        }
+        m_oldUrl = *m_listIterator;
+        m_newUrl = m_destList.at(m_listIterator - m_srcList.constBegin());
 
-        m_oldUrl = oldUrl;
-        m_newUrl = oldUrl.adjusted(QUrl::RemoveFilename);
-        m_newUrl.setPath(m_newUrl.path() + KIO::encodeFileName(newName));
-
-        KIO::Job *job = KIO::moveAs(oldUrl, m_newUrl, KIO::HideProgressInfo);
+        KIO::Job *job = KIO::moveAs(m_oldUrl, m_newUrl, KIO::HideProgressInfo);
         job->setParentJob(q);
         q->addSubjob(job);
     } else {
@@ -188,7 +287,7 @@ void BatchRenameJobPrivate::slotReport()
 {
     Q_Q(BatchRenameJob);
 
-    const auto processed = m_listIterator - m_srcList.constBegin();
+    const auto processed = m_listIterator - m_srcList.constBegin() + m_renameBatchProcessed;
 
     q->setProcessedAmount(KJob::Items, processed);
     q->emitPercent(processed, m_srcList.count());
@@ -199,6 +298,38 @@ void BatchRenameJobPrivate::slotReport()
 void BatchRenameJob::slotResult(KJob *job)
 {
     Q_D(BatchRenameJob);
+    if (job == d->m_renameBatchJob) {
+        d->m_renameBatchJob = nullptr;
+        d->m_renameBatchProcessed = 0;
+        if (!job->error()) {
+            removeSubjob(job);
+            for (qsizetype i = 0; i < d->m_srcList.count(); ++i) {
+                Q_EMIT fileRenamed(d->m_srcList.at(i), d->m_destList.at(i));
+            }
+            d->m_listIterator = d->m_srcList.constEnd();
+            d->slotStart();
+            return;
+        }
+
+        // Items the worker couldn't rename back after an error
+        const QString renamed = static_cast<KIO::Job *>(job)->queryMetaData(QStringLiteral("renamed"));
+        if (renamed.isEmpty() && !d->reusesNamesOfBatch()) {
+            // Nothing changed, go one by one: that asks about conflicts and elevated privileges as usual.
+            // Without a ui delegate the first conflict ends the job, with the items before it renamed.
+            removeSubjob(job);
+            d->m_renameBatchFailed = true;
+            d->slotStart();
+            return;
+        }
+        const QStringList indexes = renamed.split(QLatin1Char(','), Qt::SkipEmptyParts);
+        for (const QString &index : indexes) {
+            const qsizetype i = index.toLongLong();
+            if (i >= 0 && i < d->m_srcList.count()) {
+                Q_EMIT fileRenamed(d->m_srcList.at(i), d->m_destList.at(i));
+            }
+        }
+    }
+
     if (job->error()) {
         d->m_reportTimer.stop();
         d->slotReport();
@@ -210,7 +341,6 @@ void BatchRenameJob::slotResult(KJob *job)
 
     Q_EMIT fileRenamed(*d->m_listIterator, d->m_newUrl);
     ++d->m_listIterator;
-    ++d->m_index;
     d->slotStart();
 }
 
@@ -219,4 +349,10 @@ BatchRenameJob *KIO::batchRename(const QList<QUrl> &src, const QString &newName,
     return BatchRenameJobPrivate::newJob(src, newName, index, placeHolder, flags);
 }
 
+BatchRenameJob *KIO::batchRename(const QList<QUrl> &src, const QList<QUrl> &dest, KIO::JobFlags flags)
+{
+    Q_ASSERT(src.count() == dest.count());
+    return BatchRenameJobPrivate::newJob(src, dest, flags);
+}
+
 #include "moc_batchrenamejob.cpp"
@@ -63,11 +63,37 @@ private:
  * @param index The integer(incremented after renaming a file) to add to the base name.
  * @param placeHolder The character(s) which @p index will replace.
  *
+ * If the protocol supports it (see KProtocolManager::supportsBatchRenaming()),
+ * all files are renamed with a single command. Should that command fail without
+ * having renamed anything, e.g. because a new name is taken, the files are renamed
+ * one by one instead, which asks the user about conflicts. Without a ui delegate,
+ * the job then fails at the first conflict, with the files before it renamed.
+ *
  * @return A pointer to the job handling the operation.
  * @since 5.42
  */
 KIOCORE_EXPORT BatchRenameJob *batchRename(const QList<QUrl> &src, const QString &newName, int index, QChar placeHolder, JobFlags flags = DefaultFlags);
 
+/**
+ * Renames each url in @p src to the url at the same position in @p dest.
+ *
+ * If the protocol supports it (see KProtocolManager::supportsBatchRenaming()),
+ * all files are renamed with a single command, which also allows new names
+ * taken by other files of the batch, e.g. to swap the names of two files.
+ * Otherwise the files are renamed one by one, in the given order.
+ *
+ * If the single command fails, the files are renamed one by one as well, like
+ * for the other overload. That is not done when files take over names from
+ * the batch, which can't work one by one; the job fails with the error instead.
+ *
+ * @param src The list of items to rename.
+ * @param dest The new urls, one for each item of @p src.
+ *
+ * @return A pointer to the job handling the operation.
+ * @since 6.0
+ */
+KIOCORE_EXPORT BatchRenameJob *batchRename(const QList<QUrl> &src, const QList<QUrl> &dest, JobFlags flags = DefaultFlags);
+
 }
 
 #endif
@@ -0,0 +1,92 @@
+/*
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "checksumjob.h"
+#include "job.h"
+#include "job_p.h"
+#include <worker_p.h>
+
+using namespace KIO;
+
+class KIO::ChecksumJobPrivate : public SimpleJobPrivate
+{
+public:
+    ChecksumJobPrivate(const QUrl &url, int command, const QByteArray &packedArgs, const QStringList &algorithms)
+        : SimpleJobPrivate(url, command, packedArgs)
+        , m_algorithms(algorithms)
+    {
+    }
+
+    Q_DECLARE_PUBLIC(ChecksumJob)
+
+    static inline ChecksumJob *newJob(const QUrl &url, int command, const QByteArray &packedArgs, const QStringList &algorithms, JobFlags flags)
+    {
+        ChecksumJob *job = new ChecksumJob(*new ChecksumJobPrivate(url, command, packedArgs, algorithms));
+        job->setUiDelegate(KIO::createDefaultJobUiDelegate());
+        if (!(flags & HideProgressInfo)) {
+            KIO::getJobTracker()->registerJob(job);
+        }
+        return job;
+    }
+
+    QStringList m_algorithms;
+    QMap<QString, QString> m_checksums;
+};
+
+ChecksumJob::ChecksumJob(ChecksumJobPrivate &dd)
+    : SimpleJob(dd)
+{
+}
+
+ChecksumJob::~ChecksumJob()
+{
+}
+
+QStringList ChecksumJob::algorithms() const
+{
+    Q_D(const ChecksumJob);
+    return d->m_algorithms;
+}
+
+QMap<QString, QString> ChecksumJob::checksums() const
+{
+    Q_D(const ChecksumJob);
+    return d->m_checksums;
+}
+
+QString ChecksumJob::checksum(const QString &algorithm) const
+{
+    Q_D(const ChecksumJob);
+    return d->m_checksums.value(algorithm);
+}
+
+void ChecksumJob::slotFinished()
+{
+    Q_D(ChecksumJob);
+    // The worker answers with one "checksum-<algorithm>" entry per algorithm it could compute
+    for (const QString &algorithm : std::as_const(d->m_algorithms)) {
+        const QString checksum = queryMetaData(QLatin1String("checksum-") + algorithm);
+        if (!checksum.isEmpty()) {
+            d->m_checksums.insert(algorithm, checksum.toLower());
+        }
+    }
+
+    if (d->m_checksums.isEmpty() && !error()) {
+        setError(KIO::ERR_UNSUPPORTED_ACTION);
+    }
+
+    // Return worker to the scheduler
+    SimpleJob::slotFinished();
+}
+
+ChecksumJob *KIO::checksum(const QUrl &url, const QStringList &algorithms, JobFlags flags)
+{
+    KIO_ARGS << url << algorithms;
+    return ChecksumJobPrivate::newJob(url, CMD_CHECKSUM, packedArgs, algorithms, flags);
+}
+
+#include "moc_checksumjob.cpp"
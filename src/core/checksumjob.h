@@ -0,0 +1,82 @@
+/*
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KIO_CHECKSUMJOB_H
+#define KIO_CHECKSUMJOB_H
+
+#include "kiocore_export.h"
+#include "simplejob.h"
+
+#include <QMap>
+#include <QStringList>
+
+namespace KIO
+{
+class ChecksumJobPrivate;
+/**
+ * @class KIO::ChecksumJob checksumjob.h <KIO/ChecksumJob>
+ *
+ * A KIO job that asks the worker for checksums of a file.
+ *
+ * The worker computes them where the data lives, e.g. the file worker reads
+ * the file once for all requested algorithms, and remote workers can answer
+ * from checksums the server already knows. Nothing is transferred to the
+ * application besides the results.
+ *
+ * @see KIO::checksum()
+ * @since 6.0
+ */
+class KIOCORE_EXPORT ChecksumJob : public SimpleJob
+{
+    Q_OBJECT
+
+public:
+    ~ChecksumJob() override;
+
+    /**
+     * The requested algorithms, as passed to KIO::checksum().
+     */
+    QStringList algorithms() const;
+
+    /**
+     * The checksums that were computed, as lowercase hex strings keyed by algorithm name.
+     * Workers may not support all the requested algorithms, those are missing here.
+     */
+    QMap<QString, QString> checksums() const;
+
+    /**
+     * The checksum for @p algorithm as a lowercase hex string,
+     * or an empty string if the worker didn't provide it.
+     */
+    QString checksum(const QString &algorithm) const;
+
+public:
+    KIOCORE_NO_EXPORT explicit ChecksumJob(ChecksumJobPrivate &dd);
+
+private:
+    void slotFinished() override;
+    Q_DECLARE_PRIVATE(ChecksumJob)
+};
+
+/**
+ * Computes checksums of a file, without transferring its contents.
+ *
+ * Algorithms are given by their lowercase names: "md5", "sha1", "sha224",
+ * "sha256", "sha384" and "sha512". The job fails with ERR_UNSUPPORTED_ACTION
+ * if the worker can't provide any of them.
+ *
+ * @param url the file to compute checksums of
+ * @param algorithms the algorithms to use, in order of preference
+ * @param flags can be HideProgressInfo here
+ * @return the job handling the operation.
+ * @since 6.0
+ */
+KIOCORE_EXPORT ChecksumJob *checksum(const QUrl &url, const QStringList &algorithms, JobFlags flags = DefaultFlags);
+
+}
+
+#endif
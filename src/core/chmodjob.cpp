@@ -18,6 +18,7 @@
 #include "job_p.h"
 #include "jobuidelegatefactory.h"
 #include "kioglobal_p.h"
+#include "kprotocolmanager.h"
 #include "listjob.h"
 
 #include <stack>
@@ -58,7 +59,13 @@ public:
     bool m_bAutoSkipFiles;
     KFileItemList m_lstItems;
     std::stack<ChmodInfo> m_infos;
+    // Changes the current item and everything below it at once, see WorkerBase::chmodRecursive()
+    KIO::SimpleJob *m_chmodRecursiveJob = nullptr;
+    bool m_chmodRecursiveFailed = false;
+    KIO::filesize_t m_processedFiles = 0;
 
+    bool canChmodRecursive(const KFileItem &item) const;
+    void chmodRecursive(const KFileItem &item);
     void chmodNextFile();
     void slotEntries(KIO::Job *, const KIO::UDSEntryList &);
     void processList();
@@ -105,6 +112,10 @@ void ChmodJobPrivate::processList()
     while (!m_lstItems.isEmpty()) {
         const KFileItem item = m_lstItems.first();
         if (!item.isLink()) { // don't do anything with symlinks
+            if (item.isDir() && m_recursive && canChmodRecursive(item)) {
+                chmodRecursive(item);
+                return; // we'll come back later, when this one's finished
+            }
             // File or directory -> remember to chmod
             ChmodInfo info;
             info.url = item.url();
@@ -131,6 +142,7 @@ void ChmodJobPrivate::processList()
             }
         }
         m_lstItems.removeFirst();
+        m_chmodRecursiveFailed = false;
     }
     // qDebug() << "ChmodJob::processList -> going to STATE_CHMODING";
     // We have finished, move on
@@ -138,6 +150,31 @@ void ChmodJobPrivate::processList()
     chmodNextFile();
 }
 
+bool ChmodJobPrivate::canChmodRecursive(const KFileItem &item) const
+{
+    Q_Q(const ChmodJob);
+    // Ownership changes and ACLs stay on the per-file path, which can offer to skip single files
+    return !m_chmodRecursiveFailed && !m_newOwner.isValid() && !m_newGroup.isValid() //
+        && q->queryMetaData(QStringLiteral("ACL_STRING")).isEmpty() //
+        && q->queryMetaData(QStringLiteral("DEFAULT_ACL_STRING")).isEmpty() //
+        && KProtocolManager::canChmodRecursive(item.url());
+}
+
+void ChmodJobPrivate::chmodRecursive(const KFileItem &item)
+{
+    Q_Q(ChmodJob);
+    KIO_ARGS << item.url() << m_permissions << m_mask;
+    m_chmodRecursiveJob = SimpleJobPrivate::newJob(item.url(), CMD_CHMOD_RECURSIVE, packedArgs);
+    m_chmodRecursiveJob->setParentJob(q);
+    // The worker reports the number of changed entries as processed size
+    q->connect(m_chmodRecursiveJob, &KJob::processedAmountChanged, q, [this, q](KJob *, KJob::Unit unit, qulonglong amount) {
+        if (unit == KJob::Bytes) {
+            q->setProcessedAmount(KJob::Files, m_processedFiles + amount);
+        }
+    });
+    q->addSubjob(m_chmodRecursiveJob);
+}
+
 void ChmodJobPrivate::slotEntries(KIO::Job *, const KIO::UDSEntryList &list)
 {
     KIO::UDSEntryList::ConstIterator it = list.begin();
@@ -262,6 +299,18 @@ void ChmodJob::slotResult(KJob *job)
 {
     Q_D(ChmodJob);
     removeSubjob(job);
+    if (job == d->m_chmodRecursiveJob) {
+        d->m_chmodRecursiveJob = nullptr;
+        // Workers that don't implement it after all, or denied access which the per-file
+        // path can retry with elevated privileges: list and change files one by one
+        if (job->error() == ERR_UNSUPPORTED_ACTION || (job->error() == ERR_ACCESS_DENIED && d->m_privilegeExecutionEnabled)) {
+            d->m_chmodRecursiveFailed = true;
+            d->processList();
+            return;
+        }
+        d->m_processedFiles += job->processedAmount(KJob::Bytes);
+        setProcessedAmount(KJob::Files, d->m_processedFiles);
+    }
     if (job->error()) {
         setError(job->error());
         setErrorText(job->errorText());
@@ -272,10 +321,12 @@ void ChmodJob::slotResult(KJob *job)
     switch (d->state) {
     case CHMODJOB_STATE_LISTING:
         d->m_lstItems.removeFirst();
+        d->m_chmodRecursiveFailed = false;
         // qDebug() << "-> processList";
         d->processList();
         return;
     case CHMODJOB_STATE_CHMODING:
+        setProcessedAmount(KJob::Files, ++d->m_processedFiles);
         // qDebug() << "-> chmodNextFile";
         d->chmodNextFile();
         return;
@@ -53,6 +53,12 @@ private:
  * at least one "x" bit before, and for directories.
  * This emulates the behavior of chmod +X.
  *
+ * If the protocol can change directories recursively by itself
+ * (see KProtocolManager::canChmodRecursive()), directories are handed to
+ * the worker in one go instead of being listed and changed file by file,
+ * unless the ownership changes too.
+ * Progress is reported as the number of changed files.
+ *
  * @param lstItems The file items representing several files or directories.
  * @param permissions the permissions we want to set
  * @param mask the bits we are allowed to change.
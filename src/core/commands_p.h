@@ -10,6 +10,8 @@
 
 #include "kiocore_export.h"
 
+#include <QtGlobal>
+
 namespace KIO
 {
 /**
@@ -54,10 +56,25 @@ enum Command {
     CMD_FILESYSTEMFREESPACE = 95,
     CMD_TRUNCATE = 96,
     CMD_SSLERRORANSWER,
+    // The worker reads the commands from the same connection as the Message packets
+    // the job sends, e.g. MSG_DATA during put(). Those start at 100, so newer
+    // commands start at 200 to keep both apart.
+    CMD_READV = 200,
+    CMD_CHECKSUM = 201,
+    CMD_CHMOD_RECURSIVE = 202,
+    CMD_RENAME_BATCH = 203,
     // Add new ones here once a release is done, to avoid breaking binary compatibility.
     // Note that protocol-specific commands shouldn't be added here, but should use special.
 };
 
+/**
+ * @internal
+ * Limits of a single CMD_READV, so that its answer stays a message of reasonable size.
+ * FileJob splits bigger readv() requests, workers may reject them.
+ */
+constexpr int maxReadvRanges = 1024;
+constexpr quint64 maxReadvSize = 512 * 1024;
+
 } // namespace
 
 #endif
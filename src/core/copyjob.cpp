@@ -10,6 +10,7 @@
 
 #include "copyjob.h"
 #include "../utils_p.h"
+#include "checksumjob.h"
 #include "deletejob.h"
 #include "filecopyjob.h"
 #include "global.h"
@@ -324,6 +325,18 @@ public:
     std::set<QString> m_parentDirs;
     bool m_ignoreSourcePermissions = false;
 
+    // See setVerifyChecksums
+    bool m_verifyChecksums = false;
+    // Set once the source of the current file was checksummed, before copying it
+    bool m_sourceChecksummed = false;
+    // Checksums of the source of the current file by algorithm, in order of preference
+    QStringList m_sourceChecksumAlgorithms;
+    QMap<QString, QString> m_sourceChecksums;
+    // Whether the current file is being verified, i.e. the next checksum job is for its copy
+    bool m_verifyingCopy = false;
+    // Whether the source of the current file is being deleted, after its copy was verified
+    bool m_deletingVerifiedSource = false;
+
     void statCurrentSrc();
     void statNextSrc();
 
@@ -338,6 +351,11 @@ public:
 
     void slotResultCopyingFiles(KJob *job);
     void slotResultErrorCopyingFiles(KJob *job);
+    void slotResultChecksum(KIO::ChecksumJob *job);
+    void copyNotVerified(const QList<CopyInfo>::Iterator &it);
+    void verifiedCopyDone(const QList<CopyInfo>::Iterator &it);
+    void slotResultDeletingVerifiedSource(KJob *job);
+    void fileCopyingDone(const QList<CopyInfo>::Iterator &it);
     void processFileRenameDialogResult(const QList<CopyInfo>::Iterator &it, RenameDialog_Result result, const QUrl &newUrl, const QDateTime &destmtime);
 
     //     KIO::Job* linkNextFile( const QUrl& uSource, const QUrl& uDest, bool overwrite );
@@ -506,6 +524,8 @@ void CopyJobPrivate::slotStart()
 
 // For unit test purposes
 KIOCORE_EXPORT bool kio_resolve_local_urls = true;
+// For the unit tests: the checksum algorithms destinations support, if not empty
+KIOCORE_EXPORT QStringList kio_copyjob_dest_checksum_algorithms;
 
 void CopyJobPrivate::slotResultStating(KJob *job)
 {
@@ -1528,6 +1548,15 @@ void CopyJobPrivate::processCreateNextDir(const QList<CopyInfo>::Iterator &it, i
 void CopyJobPrivate::slotResultCopyingFiles(KJob *job)
 {
     Q_Q(CopyJob);
+    if (auto *checksumJob = qobject_cast<KIO::ChecksumJob *>(job)) {
+        slotResultChecksum(checksumJob);
+        return;
+    }
+    if (m_deletingVerifiedSource) {
+        slotResultDeletingVerifiedSource(job);
+        return;
+    }
+
     // The file we were trying to copy:
     QList<CopyInfo>::Iterator it = files.begin();
     if (job->error()) {
@@ -1601,28 +1630,35 @@ void CopyJobPrivate::slotResultCopyingFiles(KJob *job)
             return; // Don't move to next file yet !
         }
 
-        const QUrl finalUrl = finalDestUrl((*it).uSource, (*it).uDest);
-
-        if (m_bCurrentOperationIsLink) {
-            QString target = (m_mode == CopyJob::Link ? (*it).uSource.path() : (*it).linkDest);
-            // required for the undo feature
-            Q_EMIT q->copyingLinkDone(q, (*it).uSource, target, finalUrl);
-        } else {
-            // required for the undo feature
-            Q_EMIT q->copyingDone(q, (*it).uSource, finalUrl, (*it).mtime, false, false);
-            if (m_mode == CopyJob::Move) {
-#ifndef KIO_ANDROID_STUB
-                org::kde::KDirNotify::emitFileMoved((*it).uSource, finalUrl);
-#endif
+        if (m_verifyingCopy) {
+            // Compare the copy with the source before reporting it as done
+            m_incomingMetaData += static_cast<KIO::Job *>(job)->metaData();
+            q->removeSubjob(job);
+            Q_ASSERT(!q->hasSubjobs());
+            if (m_sourceChecksums.isEmpty()) {
+                m_verifyingCopy = false;
+                copyNotVerified(it);
+                return;
             }
-            m_successSrcList.append((*it).uSource);
-            if (m_freeSpace != KIO::invalidFilesize && (*it).size != KIO::invalidFilesize) {
-                m_freeSpace -= (*it).size;
+            // The same algorithms, the destination may only provide some of them
+            QStringList algorithms = m_sourceChecksumAlgorithms;
+            if (!kio_copyjob_dest_checksum_algorithms.isEmpty()) {
+                algorithms.removeIf([](const QString &algorithm) {
+                    return !kio_copyjob_dest_checksum_algorithms.contains(algorithm);
+                });
+                if (algorithms.isEmpty()) {
+                    m_verifyingCopy = false;
+                    copyNotVerified(it);
+                    return;
+                }
             }
+            KIO::ChecksumJob *checksumJob = KIO::checksum((*it).uDest, algorithms, HideProgressInfo);
+            checksumJob->setParentJob(q);
+            q->addSubjob(checksumJob);
+            return; // Don't move to next file yet !
         }
-        // remove from list, to move on to next file
-        files.erase(it);
-        ++m_processedFiles;
+
+        fileCopyingDone(it);
     }
 
     // clear processed size for last file and add it to overall processed size
@@ -1640,6 +1676,143 @@ void CopyJobPrivate::slotResultCopyingFiles(KJob *job)
     copyNextFile();
 }
 
+void CopyJobPrivate::fileCopyingDone(const QList<CopyInfo>::Iterator &it)
+{
+    Q_Q(CopyJob);
+    const QUrl finalUrl = finalDestUrl((*it).uSource, (*it).uDest);
+
+    if (m_bCurrentOperationIsLink) {
+        QString target = (m_mode == CopyJob::Link ? (*it).uSource.path() : (*it).linkDest);
+        // required for the undo feature
+        Q_EMIT q->copyingLinkDone(q, (*it).uSource, target, finalUrl);
+    } else {
+        // required for the undo feature
+        Q_EMIT q->copyingDone(q, (*it).uSource, finalUrl, (*it).mtime, false, false);
+        if (m_mode == CopyJob::Move) {
+#ifndef KIO_ANDROID_STUB
+            org::kde::KDirNotify::emitFileMoved((*it).uSource, finalUrl);
+#endif
+        }
+        m_successSrcList.append((*it).uSource);
+        if (m_freeSpace != KIO::invalidFilesize && (*it).size != KIO::invalidFilesize) {
+            m_freeSpace -= (*it).size;
+        }
+    }
+    // remove from list, to move on to next file
+    files.erase(it);
+    ++m_processedFiles;
+}
+
+void CopyJobPrivate::slotResultChecksum(KIO::ChecksumJob *job)
+{
+    Q_Q(CopyJob);
+    QList<CopyInfo>::Iterator it = files.begin();
+    q->removeSubjob(job);
+    Q_ASSERT(!q->hasSubjobs());
+
+    if (!m_verifyingCopy) {
+        // The source of the file about to be copied. All of its checksums are kept,
+        // the destination may only provide some of them.
+        if (job->error()) {
+            qCDebug(KIO_COPYJOB_DEBUG) << "No checksums for" << (*it).uSource << job->errorString();
+        } else {
+            const QStringList algorithms = job->algorithms();
+            for (const QString &algorithm : algorithms) {
+                const QString checksum = job->checksum(algorithm);
+                if (!checksum.isEmpty()) {
+                    m_sourceChecksumAlgorithms.append(algorithm);
+                    m_sourceChecksums.insert(algorithm, checksum);
+                }
+            }
+        }
+        m_sourceChecksummed = true;
+        processCopyNextFile(it, -1, NoSkipType);
+        return;
+    }
+
+    // The copy of the current file
+    m_verifyingCopy = false;
+    if (job->error() && job->error() != KIO::ERR_UNSUPPORTED_ACTION) {
+        q->setError(job->error());
+        q->setErrorText(job->errorText());
+        q->emitResult();
+        return;
+    }
+    // Compared with the preferred algorithm both sides provide
+    const auto algorithmIt = std::find_if(m_sourceChecksumAlgorithms.cbegin(), m_sourceChecksumAlgorithms.cend(), [job](const QString &algorithm) {
+        return !job->checksum(algorithm).isEmpty();
+    });
+    if (algorithmIt == m_sourceChecksumAlgorithms.cend()) {
+        copyNotVerified(it);
+        return;
+    }
+    if (job->checksum(*algorithmIt) != m_sourceChecksums.value(*algorithmIt)) {
+        qCWarning(KIO_COPYJOB_DEBUG) << "Checksum mismatch between" << (*it).uSource << "and" << (*it).uDest;
+        q->setError(ERR_CHECKSUM_MISMATCH);
+        q->setErrorText((*it).uDest.toDisplayString(QUrl::PreferLocalFile));
+        q->emitResult();
+        return;
+    }
+
+    verifiedCopyDone(it);
+}
+
+void CopyJobPrivate::copyNotVerified(const QList<CopyInfo>::Iterator &it)
+{
+    Q_Q(CopyJob);
+    qCWarning(KIO_COPYJOB_DEBUG) << "No checksum algorithm in common to verify" << (*it).uDest << "against" << (*it).uSource;
+    if (m_mode == CopyJob::Move) {
+        // The source is only removed once its copy is verified, keep both
+        q->setError(ERR_CANNOT_DELETE_ORIGINAL);
+        q->setErrorText((*it).uSource.toDisplayString(QUrl::PreferLocalFile));
+        q->emitResult();
+        return;
+    }
+
+    Q_EMIT q->warning(q, i18n("The copy of %1 could not be verified.", (*it).uSource.toDisplayString(QUrl::PreferLocalFile)));
+    verifiedCopyDone(it);
+}
+
+void CopyJobPrivate::verifiedCopyDone(const QList<CopyInfo>::Iterator &it)
+{
+    Q_Q(CopyJob);
+    if (m_mode == CopyJob::Move) {
+        // The copy is fine, the source can go now
+        m_deletingVerifiedSource = true;
+        KIO::SimpleJob *newjob = KIO::file_delete((*it).uSource, HideProgressInfo);
+        newjob->setParentJob(q);
+        q->addSubjob(newjob);
+        return;
+    }
+
+    fileCopyingDone(it);
+    m_processedSize += m_fileProcessedSize;
+    m_fileProcessedSize = 0;
+    copyNextFile();
+}
+
+void CopyJobPrivate::slotResultDeletingVerifiedSource(KJob *job)
+{
+    Q_Q(CopyJob);
+    QList<CopyInfo>::Iterator it = files.begin();
+    m_deletingVerifiedSource = false;
+
+    if (job->error()) {
+        // Nothing went wrong with the copy, so none of the copy conflict handling applies.
+        // Like a FileCopyJob that can't delete the source of a move, fail with that error.
+        qCDebug(KIO_COPYJOB_DEBUG) << "Couldn't delete" << (*it).uSource << "after verifying its copy";
+        q->Job::slotResult(job); // will set the error and emit result(this)
+        return;
+    }
+
+    q->removeSubjob(job);
+    Q_ASSERT(!q->hasSubjobs());
+    fileCopyingDone(it);
+    m_processedSize += m_fileProcessedSize;
+    m_fileProcessedSize = 0;
+    copyNextFile();
+}
+
 void CopyJobPrivate::slotResultErrorCopyingFiles(KJob *job)
 {
     Q_Q(CopyJob);
@@ -2044,6 +2217,27 @@ void CopyJobPrivate::processCopyNextFile(const QList<CopyInfo>::Iterator &it, in
 
     const QUrl &uSource = (*it).uSource;
     const QUrl &uDest = (*it).uDest;
+
+    const bool copiesContents = m_mode != CopyJob::Link && ((*it).linkDest.isEmpty() || !compareUrls(uSource, uDest));
+    if (m_verifyChecksums && copiesContents && !m_sourceChecksummed) {
+        // Checksum the source first, as moving removes it. Local files can be hashed
+        // with anything, remote ones may only provide the checksums the server stores.
+        QStringList algorithms{QStringLiteral("sha256")};
+        if (!uSource.isLocalFile() || !uDest.isLocalFile()) {
+            algorithms << QStringLiteral("sha1") << QStringLiteral("md5");
+        }
+        m_sourceChecksumAlgorithms.clear();
+        m_sourceChecksums.clear();
+        m_verifyingCopy = false;
+        KIO::ChecksumJob *checksumJob = KIO::checksum(uSource, algorithms, HideProgressInfo);
+        checksumJob->setParentJob(q);
+        q->addSubjob(checksumJob);
+        return;
+    }
+    m_sourceChecksummed = false;
+    // Even without checksums for the source, so that a move doesn't remove it unverified
+    m_verifyingCopy = m_verifyChecksums && copiesContents;
+
     // Do we set overwrite ?
     bool bOverwrite;
     const QString destFile = uDest.path();
@@ -2084,7 +2278,7 @@ void CopyJobPrivate::processCopyNextFile(const QList<CopyInfo>::Iterator &it, in
         // Observer::self()->slotCopying( this, m_currentSrcURL, uDest ); // should be slotLinking perhaps
         m_bCurrentOperationIsLink = true;
         // NOTE: if we are moving stuff, the deletion of the source will be done in slotResultCopyingFiles
-    } else if (m_mode == CopyJob::Move) { // Moving a file
+    } else if (m_mode == CopyJob::Move && !m_verifyingCopy) { // Moving a file
         KIO::FileCopyJob *moveJob = KIO::file_move(uSource, uDest, permissions, flags | HideProgressInfo /*no GUI*/);
         moveJob->setParentJob(q);
         moveJob->setSourceSize((*it).size);
@@ -2096,7 +2290,7 @@ void CopyJobPrivate::processCopyNextFile(const QList<CopyInfo>::Iterator &it, in
         m_currentDestURL = uDest;
         m_bURLDirty = true;
         // Observer::self()->slotMoving( this, uSource, uDest );
-    } else { // Copying a file
+    } else { // Copying a file, or moving one that is verified first (the source is deleted in slotResultChecksum)
         KIO::FileCopyJob *copyJob = KIO::file_copy(uSource, uDest, permissions, flags | HideProgressInfo /*no GUI*/);
         copyJob->setParentJob(q); // in case of rename dialog
         copyJob->setSourceSize((*it).size);
@@ -2601,6 +2795,11 @@ void KIO::CopyJob::setWriteIntoExistingDirectories(bool overwriteAll) // #65926
     d_func()->m_bOverwriteAllDirs = overwriteAll;
 }
 
+void KIO::CopyJob::setVerifyChecksums(bool verify)
+{
+    d_func()->m_verifyChecksums = verify;
+}
+
 CopyJob *KIO::copy(const QUrl &src, const QUrl &dest, JobFlags flags)
 {
     qCDebug(KIO_COPYJOB_DEBUG) << "src=" << src << "dest=" << dest;
@@ -102,6 +102,20 @@ public:
      */
     void setWriteIntoExistingDirectories(bool overwriteAllDirs);
 
+    /**
+     * Verify each copied file by comparing its checksum with the one of its source,
+     * as computed by the workers with KIO::checksum(). The first algorithm in common
+     * is used, e.g. SHA1 when the destination only provides that one. When they differ,
+     * the job fails with ERR_CHECKSUM_MISMATCH.
+     *
+     * When moving, a source file is only removed once its copy has been verified.
+     * If the workers have no algorithm in common, the job fails with
+     * ERR_CANNOT_DELETE_ORIGINAL, leaving both the source and its copy. Copies that
+     * can't be verified are reported with warning() instead.
+     * @since 6.0
+     */
+    void setVerifyChecksums(bool verify);
+
     /**
      * Reimplemented for internal reasons
      */
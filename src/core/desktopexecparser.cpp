@@ -26,8 +26,12 @@
 #include <QDBusConnection>
 #include <QDBusReply>
 #endif
+#include <QCache>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QMutex>
 #include <QProcessEnvironment>
 #include <QStandardPaths>
 #include <QUrl>
@@ -321,6 +325,90 @@ bool KIO::DesktopExecParserPrivate::isUrlSupported(const QUrl &url, const QStrin
     return false;
 }
 
+namespace
+{
+// The parts of resultingArguments() that only depend on the service, not on the URLs
+struct ParsedExec {
+    QDateTime mtime; // of the desktop file
+    QByteArray path; // $PATH when binary was resolved
+    QString binary;
+    QString executableFullPath;
+    QString exec; // with the service macros (%c, %k, %i) expanded
+    bool syntaxError = false;
+    bool hasUrls = false;
+    bool hasSpec = false;
+    bool hasTempFileOption = false;
+    bool isNonKIO = false;
+    QStringList supportedProtocols;
+};
+
+class ParsedExecCache
+{
+public:
+    QMutex mutex;
+    // Keyed by storage id and Exec line, actions share the storage id of their service
+    QCache<QString, ParsedExec> cache{100};
+};
+
+Q_GLOBAL_STATIC(ParsedExecCache, s_parsedExecCache)
+}
+
+static ParsedExec parseExec(const KService &service)
+{
+    ParsedExec parsed;
+    parsed.path = qgetenv("PATH");
+    parsed.binary = KIO::DesktopExecParser::executablePath(service.exec());
+    if (!parsed.binary.isEmpty() && QDir::isRelativePath(parsed.binary)) {
+        parsed.executableFullPath = QStandardPaths::findExecutable(parsed.binary);
+    }
+
+    KRunMX1 mx1(service);
+    parsed.exec = service.exec();
+    parsed.syntaxError = !mx1.expandMacrosShellQuote(parsed.exec);
+    parsed.hasUrls = mx1.hasUrls;
+    parsed.hasSpec = mx1.hasSpec;
+    parsed.hasTempFileOption = service.property<bool>(QStringLiteral("X-KDE-HasTempFileOption"));
+
+    // For non-KIO desktop files with explicit X-KDE-Protocols list, like vlc
+    const QStringList protocols = service.property<QStringList>(QStringLiteral("X-KDE-Protocols"));
+    parsed.isNonKIO = !protocols.isEmpty() && !protocols.contains(QLatin1String("KIO"));
+
+    parsed.supportedProtocols = KIO::DesktopExecParser::supportedProtocols(service);
+    return parsed;
+}
+
+// Launching the same application for many files (e.g. "Open With" on a large
+// selection) parses the same Exec line over and over, so the result is kept for
+// services coming from a desktop file, for as long as that file isn't modified.
+static ParsedExec cachedParseExec(const KService &service)
+{
+    const QString entryPath = service.entryPath();
+    if (entryPath.isEmpty() || service.storageId().isEmpty()) {
+        // A temporary service, or one whose Exec line was modified, e.g. for an action
+        return parseExec(service);
+    }
+
+    const QString key = service.storageId() + QLatin1Char('\n') + service.exec();
+    const QDateTime mtime = QFileInfo(entryPath).lastModified();
+    {
+        QMutexLocker locker(&s_parsedExecCache()->mutex);
+        const ParsedExec *cached = s_parsedExecCache()->cache.object(key);
+        if (cached && cached->mtime == mtime && cached->path == qgetenv("PATH")) {
+            return *cached;
+        }
+    }
+
+    ParsedExec parsed = parseExec(service);
+    parsed.mtime = mtime;
+    // Don't remember a program as missing from $PATH, it may get installed
+    const bool unresolved = !parsed.binary.isEmpty() && QDir::isRelativePath(parsed.binary) && parsed.executableFullPath.isEmpty();
+    if (!parsed.syntaxError && !unresolved) {
+        QMutexLocker locker(&s_parsedExecCache()->mutex);
+        s_parsedExecCache()->cache.insert(key, new ParsedExec(parsed));
+    }
+    return parsed;
+}
+
 QStringList KIO::DesktopExecParser::resultingArguments() const
 {
     QString exec = d->service.exec();
@@ -330,14 +418,16 @@ QStringList KIO::DesktopExecParser::resultingArguments() const
         return QStringList();
     }
 
+    const ParsedExec parsed = cachedParseExec(d->service);
+
     // Extract the name of the binary to execute from the full Exec line, to see if it exists
-    const QString binary = executablePath(exec);
+    const QString &binary = parsed.binary;
     QString executableFullPath;
     if (!binary.isEmpty()) { // skip all this if the Exec line is a complex shell command
         if (QDir::isRelativePath(binary)) {
             // Resolve the executable to ensure that helpers in libexec are found.
             // Too bad for commands that need a shell - they must reside in $PATH.
-            executableFullPath = QStandardPaths::findExecutable(binary);
+            executableFullPath = parsed.executableFullPath;
             if (executableFullPath.isEmpty()) {
                 executableFullPath = QFile::decodeName(KDE_INSTALL_FULL_LIBEXECDIR_KF "/") + binary;
             }
@@ -368,16 +458,17 @@ QStringList KIO::DesktopExecParser::resultingArguments() const
     KRunMX1 mx1(d->service);
     KRunMX2 mx2(d->urls);
 
-    if (!mx1.expandMacrosShellQuote(exec)) { // Error in shell syntax
-        d->m_errorString = i18n("Syntax error in command %1 coming from %2", exec, d->service.entryPath());
+    if (parsed.syntaxError) { // Error in shell syntax
+        d->m_errorString = i18n("Syntax error in command %1 coming from %2", parsed.exec, d->service.entryPath());
         qCWarning(KIO_CORE) << "Syntax error in command" << d->service.exec() << ", service" << d->service.name();
         return QStringList();
     }
+    exec = parsed.exec;
 
     // FIXME: the current way of invoking kioexec disables term and su use
 
     // Check if we need "tempexec" (kioexec in fact)
-    appHasTempFileOption = d->tempFiles && d->service.property<bool>(QStringLiteral("X-KDE-HasTempFileOption"));
+    appHasTempFileOption = d->tempFiles && parsed.hasTempFileOption;
     if (d->tempFiles && !appHasTempFileOption && d->urls.size()) {
         result << kioexecPath() << QStringLiteral("--tempfiles") << exec;
         if (!d->suggestedFileName.isEmpty()) {
@@ -388,12 +479,6 @@ QStringList KIO::DesktopExecParser::resultingArguments() const
         return result;
     }
 
-    // Return true for non-KIO desktop files with explicit X-KDE-Protocols list, like vlc, for the special case below
-    auto isNonKIO = [this]() {
-        const QStringList protocols = d->service.property<QStringList>(QStringLiteral("X-KDE-Protocols"));
-        return !protocols.isEmpty() && !protocols.contains(QLatin1String("KIO"));
-    };
-
     // Check if we need kioexec, or KIOFuse
     bool useKioexec = false;
 #ifndef Q_OS_ANDROID
@@ -405,10 +490,9 @@ QStringList KIO::DesktopExecParser::resultingArguments() const
     QList<MountRequest> requests;
     requests.reserve(d->urls.count());
 
-    const QStringList appSupportedProtocols = supportedProtocols(d->service);
     for (int i = 0; i < d->urls.count(); ++i) {
         const QUrl url = d->urls.at(i);
-        const bool supported = mx1.hasUrls ? d->isUrlSupported(url, appSupportedProtocols) : url.isLocalFile();
+        const bool supported = parsed.hasUrls ? d->isUrlSupported(url, parsed.supportedProtocols) : url.isLocalFile();
         if (!supported) {
             // If FUSE fails, and there is no scheme handler, we'll have to fallback to kioexec
             useKioexec = true;
@@ -419,7 +503,7 @@ QStringList KIO::DesktopExecParser::resultingArguments() const
         // Hence convert URL to KIOFuse equivalent in case there is a password.
         // @see https://pointieststick.com/2018/01/17/videos-on-samba-shares/
         // @see https://bugs.kde.org/show_bug.cgi?id=330192
-        if (!supported || (!url.userName().isEmpty() && url.password().isEmpty() && isNonKIO())) {
+        if (!supported || (!url.userName().isEmpty() && url.password().isEmpty() && parsed.isNonKIO)) {
             requests.push_back({kiofuse_iface.mountUrl(url.toString()), i});
         }
     }
@@ -462,7 +546,7 @@ QStringList KIO::DesktopExecParser::resultingArguments() const
     // Did the user forget to append something like '%f'?
     // If so, then assume that '%f' is the right choice => the application
     // accepts only local files.
-    if (!mx1.hasSpec) {
+    if (!parsed.hasSpec) {
         exec += QLatin1String(" %f");
         mx2.ignFile = true;
     }
@@ -12,12 +12,18 @@
 #include <KConfigGroup>
 #include <QMutex>
 
-#include <QCache>
+#include <QCoreApplication>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QHash>
+#include <QSaveFile>
 #include <QSet>
 #include <QStandardPaths>
+#include <QThreadPool>
+#include <QTimer>
 #include <QUrl>
+#include <QWaitCondition>
 
 using namespace KIO;
 
@@ -61,6 +67,14 @@ static QString iconNameFromUrl(const QUrl &iconUrl)
 
 ////
 
+// How long the list of icon files on disk is trusted before it's refreshed,
+// other processes may have downloaded or removed icons in the meantime.
+// Icons this process writes are added to the list right away.
+static const int s_iconFilesMaxAge = 30 * 1000; // ms
+
+// Delay before writing modified URL->icon associations to disk
+static const int s_syncDelay = 2000; // ms
+
 class KIO::FavIconsCachePrivate
 {
 public:
@@ -68,23 +82,108 @@ public:
         : cacheDir(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QStringLiteral("/favicons/"))
         , config(cacheDir + QStringLiteral("index"))
     {
+        syncTimer.setSingleShot(true);
+        syncTimer.setInterval(s_syncDelay);
     }
 
+    void ensureIndexLoaded();
     QString cachedIconUrlForUrl(const QUrl &url);
+    bool iconFileExists(const QString &fileName);
+    void startIconFilesScan();
+    void sync();
+    bool canDelaySync() const;
 
     const QString cacheDir;
+    QTimer syncTimer;
     QMutex mutex; // protects all the member variables below
     KConfig config;
-    QCache<QString, QString> faviconsCache;
+    bool indexLoaded = false;
+    bool dirty = false;
+    QHash<QString, QString> index; // simplified URL -> icon URL, mirrors the config file
     QSet<QUrl> failedDownloads;
+
+    // File names of the icons in cacheDir, filled by a background scan
+    QSet<QString> iconFiles;
+    QElapsedTimer iconFilesAge; // invalid until the first scan finished
+    QSet<QString> iconFilesAddedDuringScan;
+    bool scanRunning = false;
+    QWaitCondition scanFinished;
 };
 
+void FavIconsCachePrivate::ensureIndexLoaded()
+{
+    Q_ASSERT(!mutex.tryLock());
+    if (indexLoaded) {
+        return;
+    }
+    const QMap<QString, QString> entries = config.group(QString()).entryMap();
+    index.reserve(entries.size());
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        index.insert(it.key(), it.value());
+    }
+    indexLoaded = true;
+}
+
 QString FavIconsCachePrivate::cachedIconUrlForUrl(const QUrl &url)
 {
     Q_ASSERT(!mutex.tryLock());
-    const QString simplifiedUrl = simplifyUrl(url);
-    QString *cachedIconUrl = faviconsCache[simplifiedUrl];
-    return (cachedIconUrl ? *cachedIconUrl : config.group(QString()).readEntry(simplifiedUrl, QString()));
+    ensureIndexLoaded();
+    return index.value(simplifyUrl(url));
+}
+
+bool FavIconsCachePrivate::iconFileExists(const QString &fileName)
+{
+    Q_ASSERT(!mutex.tryLock());
+    if (!iconFilesAge.isValid()) {
+        // No scan result yet, don't wait for it
+        startIconFilesScan();
+        return QFile::exists(cacheDir + fileName);
+    }
+    if (iconFilesAge.hasExpired(s_iconFilesMaxAge)) {
+        startIconFilesScan();
+    }
+    return iconFiles.contains(fileName);
+}
+
+void FavIconsCachePrivate::startIconFilesScan()
+{
+    Q_ASSERT(!mutex.tryLock());
+    if (scanRunning) {
+        return;
+    }
+    scanRunning = true;
+    QThreadPool::globalInstance()->start([this]() {
+        QSet<QString> files;
+        QDir dir(cacheDir);
+        const QStringList entries = dir.entryList({QStringLiteral("*.png")}, QDir::Files);
+        files.reserve(entries.size());
+        for (const QString &entry : entries) {
+            files.insert(entry);
+        }
+
+        QMutexLocker locker(&mutex);
+        iconFiles = std::move(files);
+        iconFiles.unite(iconFilesAddedDuringScan);
+        iconFilesAddedDuringScan.clear();
+        iconFilesAge.start();
+        scanRunning = false;
+        scanFinished.wakeAll();
+    });
+}
+
+void FavIconsCachePrivate::sync()
+{
+    QMutexLocker locker(&mutex);
+    if (dirty) {
+        config.sync();
+        dirty = false;
+    }
+}
+
+bool FavIconsCachePrivate::canDelaySync() const
+{
+    const QCoreApplication *app = QCoreApplication::instance();
+    return app && syncTimer.thread() == app->thread() && !QCoreApplication::closingDown();
 }
 
 FavIconsCache *FavIconsCache::instance()
@@ -96,9 +195,26 @@ FavIconsCache *FavIconsCache::instance()
 FavIconsCache::FavIconsCache()
     : d(new FavIconsCachePrivate)
 {
+    // Icons are set from any thread, and the first one to use the cache may not run an
+    // event loop. The main thread does, so the delayed sync happens there.
+    if (const QCoreApplication *app = QCoreApplication::instance()) {
+        d->syncTimer.moveToThread(app->thread());
+    }
+    connect(&d->syncTimer, &QTimer::timeout, &d->syncTimer, [this]() {
+        d->sync();
+    });
 }
 
-FavIconsCache::~FavIconsCache() = default;
+FavIconsCache::~FavIconsCache()
+{
+    QMutexLocker locker(&d->mutex);
+    while (d->scanRunning) {
+        d->scanFinished.wait(&d->mutex);
+    }
+    if (d->dirty) {
+        d->config.sync();
+    }
+}
 
 QString FavIconsCache::iconForUrl(const QUrl &url)
 {
@@ -114,7 +230,7 @@ QString FavIconsCache::iconForUrl(const QUrl &url)
         icon += url.host();
     }
     icon += QStringLiteral(".png");
-    if (QFile::exists(icon)) {
+    if (d->iconFileExists(icon.mid(d->cacheDir.size()))) {
         return icon;
     }
     return QString();
@@ -142,9 +258,22 @@ void FavIconsCache::setIconForUrl(const QUrl &url, const QUrl &iconUrl)
     QMutexLocker locker(&d->mutex);
     const QString simplifiedUrl = simplifyUrl(url);
     const QString iconUrlStr = iconUrl.url();
-    d->faviconsCache.insert(simplifiedUrl, new QString(iconUrlStr));
+    d->ensureIndexLoaded();
+    auto it = d->index.find(simplifiedUrl);
+    if (it != d->index.end() && *it == iconUrlStr) {
+        return;
+    }
+    d->index.insert(simplifiedUrl, iconUrlStr);
     d->config.group(QString()).writeEntry(simplifiedUrl, iconUrlStr);
-    d->config.sync();
+    // Batch the writes, a page load can set icons for many URLs at once
+    if (!d->dirty) {
+        if (d->canDelaySync()) {
+            d->dirty = true;
+            QMetaObject::invokeMethod(&d->syncTimer, qOverload<>(&QTimer::start), Qt::QueuedConnection);
+        } else {
+            d->config.sync();
+        }
+    }
 }
 
 QString FavIconsCache::cachePathForIconUrl(const QUrl &iconUrl) const
@@ -160,6 +289,30 @@ void FavIconsCache::ensureCacheExists()
     QDir().mkpath(d->cacheDir);
 }
 
+QString FavIconsCache::saveIconFile(const QUrl &iconUrl, const QByteArray &data)
+{
+    ensureCacheExists();
+    const QString localPath = cachePathForIconUrl(iconUrl);
+    QSaveFile saveFile(localPath);
+    if (!saveFile.open(QIODevice::WriteOnly) || saveFile.write(data) != data.size() || !saveFile.commit()) {
+        return QString();
+    }
+    addCachedIconFile(localPath);
+    return localPath;
+}
+
+void FavIconsCache::addCachedIconFile(const QString &localPath)
+{
+    QMutexLocker locker(&d->mutex);
+    if (localPath.startsWith(d->cacheDir)) {
+        const QString fileName = localPath.mid(d->cacheDir.size());
+        d->iconFiles.insert(fileName);
+        if (d->scanRunning) {
+            d->iconFilesAddedDuringScan.insert(fileName);
+        }
+    }
+}
+
 void FavIconsCache::addFailedDownload(const QUrl &url)
 {
     QMutexLocker locker(&d->mutex);
@@ -30,7 +30,10 @@ class KIOCORE_EXPORT FavIconsCache : public QObject
 public:
     static FavIconsCache *instance();
 
-    // Fast cache lookup, used by KIO::favIconForUrl
+    // Fast cache lookup, used by KIO::favIconForUrl.
+    // Which icon files exist is only checked on disk every 30s. Icons written through
+    // saveIconFile() or addCachedIconFile() are found right away, those written or
+    // removed by other processes can be missed for that long.
     QString iconForUrl(const QUrl &url);
 
     // Look for a custom icon URL in the cache, otherwise assemble default host icon URL
@@ -43,6 +46,13 @@ public:
 
     void ensureCacheExists();
 
+    // Writes the PNG @p data as the icon file for @p iconUrl, and adds it to the in-memory index.
+    // Returns the path of the icon file, or an empty string on error.
+    QString saveIconFile(const QUrl &iconUrl, const QByteArray &data);
+
+    // Tell the in-memory index that an icon was written to @p localPath
+    void addCachedIconFile(const QString &localPath);
+
     void addFailedDownload(const QUrl &url);
     void removeFailedDownload(const QUrl &url);
     bool isFailedDownload(const QUrl &url) const;
@@ -324,6 +324,10 @@ void FileCopyJobPrivate::startDataPump()
     if (m_modificationTime.isValid()) {
         m_putJob->setModificationTime(m_modificationTime);
     }
+    // Lets the worker preallocate the destination
+    if (m_sourceSize != (KIO::filesize_t)-1) {
+        m_putJob->addMetaData(QStringLiteral("size"), KIO::number(m_sourceSize));
+    }
 
     // The first thing the put job will tell us is whether we can
     // resume or not (this is always emitted)
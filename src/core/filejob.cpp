@@ -8,24 +8,69 @@
 #include "filejob.h"
 
 #include "job_p.h"
+#include "kprotocolmanager.h"
 #include "worker_p.h"
 
+#include <deque>
+#include <utility>
+
 class KIO::FileJobPrivate : public KIO::SimpleJobPrivate
 {
 public:
-    FileJobPrivate(const QUrl &url, const QByteArray &packedArgs)
+    FileJobPrivate(const QUrl &url, const QByteArray &packedArgs, QIODevice::OpenMode mode)
         : SimpleJobPrivate(url, CMD_OPEN, packedArgs)
         , m_open(false)
         , m_size(0)
+        , m_mode(mode)
     {
     }
 
     bool m_open;
     QString m_mimetype;
     KIO::filesize_t m_size;
+    QIODevice::OpenMode m_mode;
+
+    struct PendingRead {
+        KIO::filesize_t offset;
+        KIO::filesize_t size;
+    };
+    struct PendingReadv {
+        KIO::FileRangeList ranges;
+        bool readAhead; // sent by the job itself rather than by FileJob::readv()
+        quint32 generation;
+        bool continued; // the first range is the rest of the last range of the previous part
+        bool last; // the last part of the request
+    };
+
+    // Read-ahead is built on readv(), which doesn't move the worker's file offset,
+    // so while it is active m_position is tracked here rather than by the worker.
+    int m_readAheadDepth = 0;
+    KIO::filesize_t m_readAheadBlockSize = 0;
+    bool m_sizeKnown = false;
+    bool m_workerOffsetStale = false;
+    KIO::filesize_t m_position = 0; // where the next read() starts
+    KIO::filesize_t m_bufferOffset = 0; // file offset of the first byte in m_buffer
+    KIO::filesize_t m_prefetchEnd = 0; // end of the data requested so far
+    quint32 m_generation = 0;
+    QByteArray m_buffer;
+    std::deque<PendingRead> m_pendingReads;
+    std::deque<PendingReadv> m_pendingReadvs;
+    QList<QByteArray> m_readvChunks; // the answer to a FileJob::readv() sent in several parts
+    std::deque<bool> m_pendingSeeks; // true for seeks sent by the job itself
+
+    bool readAheadActive() const
+    {
+        return m_readAheadDepth > 0 && m_sizeKnown && !(m_mode & QIODevice::WriteOnly);
+    }
+    void sendReadv(const KIO::FileRangeList &ranges, bool readAhead);
+    void sendSeek(KIO::filesize_t offset, bool internal);
+    void resetReadAhead(KIO::filesize_t offset);
+    void fillReadAhead();
+    void serveReads();
 
     void slotRedirection(const QUrl &url);
     void slotData(const QByteArray &data);
+    void slotDataVector(const QList<QByteArray> &chunks);
     void slotMimetype(const QString &mimetype);
     void slotOpen();
     void slotWritten(KIO::filesize_t);
@@ -44,9 +89,9 @@ public:
 
     Q_DECLARE_PUBLIC(FileJob)
 
-    static inline FileJob *newJob(const QUrl &url, const QByteArray &packedArgs)
+    static inline FileJob *newJob(const QUrl &url, const QByteArray &packedArgs, QIODevice::OpenMode mode)
     {
-        FileJob *job = new FileJob(*new FileJobPrivate(url, packedArgs));
+        FileJob *job = new FileJob(*new FileJobPrivate(url, packedArgs, mode));
         job->setUiDelegate(KIO::createDefaultJobUiDelegate());
         return job;
     }
@@ -70,10 +115,62 @@ void FileJob::read(KIO::filesize_t size)
         return;
     }
 
+    if (d->readAheadActive()) {
+        const KIO::filesize_t offset = d->m_position;
+        d->m_pendingReads.push_back({offset, size});
+        d->m_position = qMax(offset, qMin(offset + size, d->m_size));
+        d->m_workerOffsetStale = true;
+        if (size > 0) {
+            d->m_readAheadBlockSize = size;
+        }
+        d->serveReads();
+        return;
+    }
+
     KIO_ARGS << size;
     d->m_worker->send(CMD_READ, packedArgs);
 }
 
+void FileJob::readv(const KIO::FileRangeList &ranges)
+{
+    Q_D(FileJob);
+    if (!d->m_open) {
+        return;
+    }
+
+    d->sendReadv(ranges, false);
+}
+
+void FileJob::setReadAheadDepth(int depth)
+{
+    Q_D(FileJob);
+    const bool wasActive = d->readAheadActive();
+    d->m_readAheadDepth = (depth > 0 && KProtocolManager::supportsVectoredReading(d->m_url)) ? depth : 0;
+
+    if (wasActive && !d->readAheadActive() && d->m_open) {
+        // Hand the reads still waiting for read-ahead data back to the worker,
+        // after moving its file offset to where they start
+        const KIO::filesize_t offset = d->m_pendingReads.empty() ? d->m_position : d->m_pendingReads.front().offset;
+        if (d->m_workerOffsetStale) {
+            d->sendSeek(offset, true);
+            d->m_workerOffsetStale = false;
+        }
+        d->m_position = offset;
+        for (const auto &pendingRead : d->m_pendingReads) {
+            KIO_ARGS << pendingRead.size;
+            d->m_worker->send(CMD_READ, packedArgs);
+        }
+        d->m_pendingReads.clear();
+        d->resetReadAhead(offset);
+    }
+}
+
+int FileJob::readAheadDepth() const
+{
+    Q_D(const FileJob);
+    return d->m_readAheadDepth;
+}
+
 void FileJob::write(const QByteArray &_data)
 {
     Q_D(FileJob);
@@ -91,8 +188,11 @@ void FileJob::seek(KIO::filesize_t offset)
         return;
     }
 
-    KIO_ARGS << KIO::filesize_t(offset);
-    d->m_worker->send(CMD_SEEK, packedArgs);
+    if (d->readAheadActive()) {
+        d->m_position = offset;
+        d->m_workerOffsetStale = false;
+    }
+    d->sendSeek(offset, false);
 }
 
 void FileJob::truncate(KIO::filesize_t length)
@@ -127,13 +227,172 @@ KIO::filesize_t FileJob::size()
     return d->m_size;
 }
 
+void FileJobPrivate::sendReadv(const KIO::FileRangeList &ranges, bool readAhead)
+{
+    // Workers reject bigger requests, so split them, also within a range if needed
+    KIO::FileRangeList part;
+    KIO::filesize_t partSize = 0;
+    bool continued = false;
+    auto sendPart = [&](bool last) {
+        KIO_ARGS << part;
+        m_worker->send(CMD_READV, packedArgs);
+        m_pendingReadvs.push_back({part, readAhead, m_generation, continued, last});
+        part.clear();
+        partSize = 0;
+    };
+
+    for (auto [offset, length] : ranges) {
+        bool partlySent = false;
+        for (;;) {
+            if (part.size() == maxReadvRanges || partSize == maxReadvSize) {
+                sendPart(false);
+                continued = partlySent;
+            }
+            const KIO::filesize_t pieceLength = qMin(length, maxReadvSize - partSize);
+            part.append({offset, pieceLength});
+            partSize += pieceLength;
+            offset += pieceLength;
+            length -= pieceLength;
+            if (length == 0) {
+                break;
+            }
+            partlySent = true;
+        }
+    }
+    sendPart(true);
+}
+
+void FileJobPrivate::sendSeek(KIO::filesize_t offset, bool internal)
+{
+    KIO_ARGS << KIO::filesize_t(offset);
+    m_worker->send(CMD_SEEK, packedArgs);
+    m_pendingSeeks.push_back(internal);
+}
+
+void FileJobPrivate::resetReadAhead(KIO::filesize_t offset)
+{
+    // Answers to readv() requests sent before this are dropped on arrival
+    ++m_generation;
+    m_buffer.clear();
+    m_bufferOffset = offset;
+    m_prefetchEnd = offset;
+}
+
+void FileJobPrivate::fillReadAhead()
+{
+    if (!readAheadActive() || m_readAheadBlockSize == 0) {
+        return;
+    }
+
+    KIO::filesize_t base = m_bufferOffset;
+    KIO::filesize_t limit = base;
+    if (!m_pendingReads.empty()) {
+        const PendingRead &read = m_pendingReads.front();
+        base = qMax(base, read.offset);
+        limit = read.offset + read.size;
+    }
+    limit = qMin(qMax(limit, base + m_readAheadDepth * m_readAheadBlockSize), m_size);
+
+    KIO::FileRangeList ranges;
+    while (m_prefetchEnd < limit) {
+        const KIO::filesize_t length = qMin(m_readAheadBlockSize, limit - m_prefetchEnd);
+        ranges.append({m_prefetchEnd, length});
+        m_prefetchEnd += length;
+    }
+    if (!ranges.isEmpty()) {
+        sendReadv(ranges, true);
+    }
+}
+
+void FileJobPrivate::serveReads()
+{
+    Q_Q(FileJob);
+    while (!m_pendingReads.empty()) {
+        const PendingRead read = m_pendingReads.front();
+        const KIO::filesize_t end = qMin(read.offset + read.size, m_size);
+        if (read.offset >= end) {
+            // EOD, or a read of 0 bytes
+            m_pendingReads.pop_front();
+            Q_EMIT q->data(q, QByteArray());
+            continue;
+        }
+
+        if (read.offset < m_bufferOffset || read.offset > m_prefetchEnd) {
+            // Outside of the read-ahead window, e.g. after a seek
+            resetReadAhead(read.offset);
+        } else if (read.offset > m_bufferOffset && read.offset <= m_bufferOffset + m_buffer.size()) {
+            // Skipped over by a forward seek
+            m_buffer.remove(0, read.offset - m_bufferOffset);
+            m_bufferOffset = read.offset;
+        }
+
+        if (m_bufferOffset + m_buffer.size() < end) {
+            break; // Wait for more data
+        }
+
+        const QByteArray chunk = m_buffer.left(end - m_bufferOffset);
+        m_buffer.remove(0, chunk.size());
+        m_bufferOffset = end;
+        m_pendingReads.pop_front();
+        Q_EMIT q->data(q, chunk);
+    }
+
+    fillReadAhead();
+}
+
 // Worker sends data
 void FileJobPrivate::slotData(const QByteArray &_data)
 {
     Q_Q(FileJob);
+    if (!readAheadActive()) {
+        m_position += _data.size();
+    }
     Q_EMIT q_func()->data(q, _data);
 }
 
+void FileJobPrivate::slotDataVector(const QList<QByteArray> &chunks)
+{
+    Q_Q(FileJob);
+    if (m_pendingReadvs.empty()) {
+        return;
+    }
+    const PendingReadv readv = m_pendingReadvs.front();
+    m_pendingReadvs.pop_front();
+
+    if (!readv.readAhead) {
+        for (qsizetype i = 0; i < readv.ranges.size(); ++i) {
+            if (i == 0 && readv.continued && !m_readvChunks.isEmpty()) {
+                m_readvChunks.last().append(chunks.value(i));
+            } else {
+                m_readvChunks.append(chunks.value(i));
+            }
+        }
+        if (readv.last) {
+            Q_EMIT q->dataVector(q, std::exchange(m_readvChunks, {}));
+        }
+        return;
+    }
+
+    if (readv.generation != m_generation) {
+        return; // The read-ahead window moved since this was requested
+    }
+
+    for (qsizetype i = 0; i < readv.ranges.size(); ++i) {
+        const auto &[offset, length] = readv.ranges.at(i);
+        const QByteArray chunk = chunks.value(i);
+        if (offset == m_bufferOffset + m_buffer.size()) {
+            m_buffer.append(chunk);
+        }
+        if (KIO::filesize_t(chunk.size()) < length) {
+            // The file shrank since it was opened
+            m_size = offset + chunk.size();
+            break;
+        }
+    }
+
+    serveReads();
+}
+
 void FileJobPrivate::slotRedirection(const QUrl &url)
 {
     Q_Q(FileJob);
@@ -151,6 +410,17 @@ void FileJobPrivate::slotMimetype(const QString &type)
 void FileJobPrivate::slotPosition(KIO::filesize_t pos)
 {
     Q_Q(FileJob);
+    if (!m_pendingSeeks.empty()) {
+        const bool internal = m_pendingSeeks.front();
+        m_pendingSeeks.pop_front();
+        if (internal) {
+            return;
+        }
+    }
+
+    if (!readAheadActive()) {
+        m_position = pos;
+    }
     Q_EMIT q->position(q, pos);
 }
 
@@ -163,6 +433,7 @@ void FileJobPrivate::slotTruncated(KIO::filesize_t length)
 void FileJobPrivate::slotTotalSize(KIO::filesize_t t_size)
 {
     m_size = t_size;
+    m_sizeKnown = true;
     Q_Q(FileJob);
     q->setTotalAmount(KJob::Bytes, m_size);
 }
@@ -201,6 +472,10 @@ void FileJobPrivate::start(Worker *worker)
         slotData(ba);
     });
 
+    q->connect(worker, &KIO::WorkerInterface::dataVector, q, [this](const QList<QByteArray> &chunks) {
+        slotDataVector(chunks);
+    });
+
     q->connect(worker, &KIO::WorkerInterface::redirection, q, [this](const QUrl &url) {
         slotRedirection(url);
     });
@@ -240,7 +515,7 @@ FileJob *KIO::open(const QUrl &url, QIODevice::OpenMode mode)
 {
     // Send decoded path and encoded query
     KIO_ARGS << url << mode;
-    return FileJobPrivate::newJob(url, packedArgs);
+    return FileJobPrivate::newJob(url, packedArgs, mode);
 }
 
 #include "moc_filejob.cpp"
@@ -49,6 +49,51 @@ public:
      */
     void read(KIO::filesize_t size);
 
+    /**
+     * This function reads several ranges of the file at once and returns
+     * them via a single dataVector() signal, which avoids one round trip to
+     * the worker per range.
+     *
+     * Unlike read(), this does not use or change the current file offset.
+     * Large requests are sent to the worker in several parts, but still
+     * answered with a single dataVector() signal.
+     *
+     * On error the dataVector() signal is not emitted. To catch errors please
+     * connect to the result() signal.
+     *
+     * Only available if the protocol supports it, see
+     * KProtocolManager::supportsVectoredReading().
+     *
+     * @param ranges the (offset, length) pairs to read
+     * @since 6.0
+     */
+    void readv(const KIO::FileRangeList &ranges);
+
+    /**
+     * Sets how many blocks read() keeps requested ahead of the current
+     * file offset.
+     *
+     * With a depth greater than 0, read() requests are answered from a
+     * read-ahead buffer that is refilled with readv() in the background,
+     * using the size of the latest read() as block size. This hides the
+     * round trip to the worker for sequential readers such as media players.
+     * The data() and position() signals are emitted as without read-ahead.
+     *
+     * Read-ahead is only used for files opened read-only, whose size is
+     * known and whose protocol supports vectored reading; otherwise read()
+     * behaves as usual. It is best set from a slot connected to open().
+     *
+     * @param depth the number of blocks to read ahead, 0 (the default) disables read-ahead
+     * @since 6.0
+     */
+    void setReadAheadDepth(int depth);
+
+    /**
+     * @return the read-ahead depth set with setReadAheadDepth()
+     * @since 6.0
+     */
+    int readAheadDepth() const;
+
     /**
      * This function attempts to write all the bytes in \p data to the URL
      * passed to KIO::open() and returns the bytes written received via the
@@ -117,6 +162,19 @@ Q_SIGNALS:
      */
     void data(KIO::Job *job, const QByteArray &data);
 
+    /**
+     * Data from the worker has arrived. Emitted after readv(), with one
+     * chunk per requested range, in the same order.
+     *
+     * A chunk is shorter than requested if its range extends past the end
+     * of the file.
+     *
+     * @param job the job that emitted this signal
+     * @param data the data read for each range
+     * @since 6.0
+     */
+    void dataVector(KIO::Job *job, const QList<QByteArray> &data);
+
     /**
      * Signals the file is a redirection.
      * Follow this url manually to reach data
@@ -8,6 +8,7 @@
 
 #include "forwardingworkerbase.h"
 #include "../utils_p.h"
+#include "forwardingworkerbase_p.h"
 
 #include "deletejob.h"
 #include "job.h"
@@ -36,6 +37,21 @@ public:
 
     bool internalRewriteUrl(const QUrl &url, QUrl &newURL);
 
+    // listDir() rewrites every entry against the same two URLs, so the parts
+    // that don't depend on the entry are computed once per listing instead of
+    // going through QUrl for each entry.
+    struct ListingRewrite {
+        bool active = false;
+        ListingUrlRewriter urlRewriter;
+        QString processedPathPrefix; // processed path ending with '/', empty for local or http(s) URLs
+        QString localPathPrefix; // local path ending with '/', empty if not local
+    };
+    ListingRewrite m_listing;
+    QMimeDatabase m_mimeDb;
+
+    void beginListingRewrite();
+    void endListingRewrite();
+
     void connectJob(Job *job);
     void connectSimpleJob(SimpleJob *job);
     void connectListJob(ListJob *job);
@@ -95,6 +111,32 @@ bool ForwardingWorkerBasePrivate::internalRewriteUrl(const QUrl &url, QUrl &newU
     return result;
 }
 
+void ForwardingWorkerBasePrivate::beginListingRewrite()
+{
+    m_listing = {};
+    m_listing.active = true;
+    m_listing.urlRewriter = ListingUrlRewriter(m_requestedURL);
+
+    if (m_processedURL.isLocalFile()) {
+        const QString localPath = m_processedURL.toLocalFile();
+        if (!localPath.isEmpty()) {
+            m_listing.localPathPrefix = Utils::slashAppended(localPath);
+        }
+    } else {
+        // Same special cases as QMimeDatabase::mimeTypeForUrl()
+        const QString scheme = m_processedURL.scheme();
+        const QString processedPath = m_processedURL.path();
+        if (!scheme.startsWith(QLatin1String("http")) && scheme != QLatin1String("mailto") && !processedPath.isEmpty()) {
+            m_listing.processedPathPrefix = Utils::slashAppended(processedPath);
+        }
+    }
+}
+
+void ForwardingWorkerBasePrivate::endListingRewrite()
+{
+    m_listing = {};
+}
+
 void ForwardingWorkerBase::adjustUDSEntry(KIO::UDSEntry &entry, UDSEntryCreationMode creationMode) const
 {
     const bool listing = (creationMode == UDSEntryCreationInListDir);
@@ -102,8 +144,36 @@ void ForwardingWorkerBase::adjustUDSEntry(KIO::UDSEntry &entry, UDSEntryCreation
 
     const QString name = entry.stringValue(KIO::UDSEntry::UDS_NAME);
     QString mimetype = entry.stringValue(KIO::UDSEntry::UDS_MIME_TYPE);
-    QUrl url;
     const QString urlStr = entry.stringValue(KIO::UDSEntry::UDS_URL);
+
+    if (listing && d->m_listing.active) {
+        // Fast path: string concatenation against the per-listing prefixes
+        QString newUrlStr;
+        if (urlStr.isEmpty() || d->m_listing.urlRewriter.rewrite(urlStr, newUrlStr)) {
+            if (!urlStr.isEmpty()) {
+                entry.replace(KIO::UDSEntry::UDS_URL, newUrlStr);
+            }
+            const bool haveMimeType = !mimetype.isEmpty();
+            const bool isLocal = !d->m_listing.localPathPrefix.isEmpty();
+            if (!haveMimeType && urlStr.isEmpty() && (isLocal || !d->m_listing.processedPathPrefix.isEmpty())) {
+                mimetype = isLocal ? d->m_mimeDb.mimeTypeForFile(d->m_listing.localPathPrefix + name).name()
+                                   : d->m_mimeDb.mimeTypeForFile(d->m_listing.processedPathPrefix + name, QMimeDatabase::MatchExtension).name();
+                entry.replace(KIO::UDSEntry::UDS_MIME_TYPE, mimetype);
+            } else if (!haveMimeType) {
+                QUrl new_url(d->m_processedURL);
+                new_url.setPath(Utils::concatPaths(new_url.path(), urlStr.isEmpty() ? name : QUrl(urlStr).fileName()));
+                entry.replace(KIO::UDSEntry::UDS_MIME_TYPE, d->m_mimeDb.mimeTypeForUrl(new_url).name());
+            }
+            if (isLocal) {
+                entry.replace(KIO::UDSEntry::UDS_LOCAL_PATH, d->m_listing.localPathPrefix + name);
+            } else if (d->m_processedURL.isLocalFile()) {
+                entry.replace(KIO::UDSEntry::UDS_LOCAL_PATH, Utils::concatPaths(d->m_processedURL.toLocalFile(), name));
+            }
+            return;
+        }
+    }
+
+    QUrl url;
     const bool url_found = !urlStr.isEmpty();
     if (url_found) {
         url = QUrl(urlStr);
@@ -125,8 +195,7 @@ void ForwardingWorkerBase::adjustUDSEntry(KIO::UDSEntry &entry, UDSEntryCreation
             new_url.setPath(Utils::concatPaths(new_url.path(), name));
         }
 
-        QMimeDatabase db;
-        mimetype = db.mimeTypeForUrl(new_url).name();
+        mimetype = d->m_mimeDb.mimeTypeForUrl(new_url).name();
 
         entry.replace(KIO::UDSEntry::UDS_MIME_TYPE, mimetype);
 
@@ -208,7 +277,10 @@ WorkerResult ForwardingWorkerBase::listDir(const QUrl &url)
         KIO::ListJob *job = KIO::listDir(new_url, KIO::HideProgressInfo);
         d->connectListJob(job);
 
-        return d->loopResult();
+        d->beginListingRewrite();
+        const WorkerResult result = d->loopResult();
+        d->endListingRewrite();
+        return result;
     }
     return WorkerResult::fail(KIO::ERR_DOES_NOT_EXIST, url.toDisplayString());
 }
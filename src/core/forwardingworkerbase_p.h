@@ -0,0 +1,84 @@
+/*
+    This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KIO_FORWARDINGWORKERBASE_P_H
+#define KIO_FORWARDINGWORKERBASE_P_H
+
+#include "../utils_p.h"
+
+#include <QString>
+#include <QUrl>
+
+namespace KIO
+{
+/**
+ * @internal
+ * Rewrites the UDS_URL of the entries listed by ForwardingWorkerBase::listDir(),
+ * which all get the requested URL as prefix.
+ *
+ * The result is the same as setting the file name of the entry's URL on the
+ * requested URL and calling QUrl::toString(), without parsing and serializing
+ * a whole QUrl for every entry.
+ */
+class ListingUrlRewriter
+{
+public:
+    ListingUrlRewriter() = default;
+
+    explicit ListingUrlRewriter(const QUrl &requestedUrl)
+    {
+        const QString requestedPath = requestedUrl.path();
+        if (!requestedPath.isEmpty() && !requestedUrl.hasQuery() && !requestedUrl.hasFragment()) {
+            QUrl prefix(requestedUrl);
+            prefix.setPath(Utils::slashAppended(requestedPath));
+            m_prefix = prefix.toString();
+        }
+    }
+
+    /**
+     * Returns false if the URLs can't be rewritten this way, e.g. if the requested
+     * URL has a query, in which case QUrl has to be used.
+     */
+    bool isValid() const
+    {
+        return !m_prefix.isEmpty();
+    }
+
+    bool rewrite(const QString &urlStr, QString &newUrlStr) const
+    {
+        if (m_prefix.isEmpty()) {
+            return false;
+        }
+
+        // The last path segment of urlStr, i.e. QUrl(urlStr).fileName() without the parsing
+        qsizetype end = urlStr.indexOf(QLatin1Char('?'));
+        const qsizetype hash = urlStr.indexOf(QLatin1Char('#'));
+        if (end == -1 || (hash != -1 && hash < end)) {
+            end = hash;
+        }
+        if (end == -1) {
+            end = urlStr.size();
+        }
+        const qsizetype slash = end > 0 ? urlStr.lastIndexOf(QLatin1Char('/'), end - 1) : -1;
+        if (slash == -1) {
+            return false;
+        }
+
+        // Encoded like toString() encodes it as part of the whole URL
+        QUrl fileName;
+        fileName.setPath(QUrl::fromPercentEncoding(QStringView(urlStr).sliced(slash + 1, end - slash - 1).toUtf8()));
+        newUrlStr = m_prefix + fileName.path(QUrl::PrettyDecoded);
+        return true;
+    }
+
+private:
+    QString m_prefix; // the requested URL ending with '/', as toString() returns it
+};
+
+}
+
+#endif
@@ -10,6 +10,8 @@
 #include "kiocore_export.h"
 
 #include <QFile> // for QFile::Permissions
+#include <QList>
+#include <QPair>
 #include <QString>
 
 #include <KJob>
@@ -38,6 +40,15 @@ typedef qlonglong fileoffset_t;
 /// 64-bit file size
 typedef qulonglong filesize_t;
 
+/**
+ * A byte range within a file, given as (offset, length).
+ * @see KIO::FileJob::readv()
+ * @since 6.0
+ */
+typedef QPair<KIO::filesize_t, KIO::filesize_t> FileRange;
+/// A list of byte ranges, see FileRange. @since 6.0
+typedef QList<FileRange> FileRangeList;
+
 /**
  * Converts @p size from bytes to the string representation.
  *
@@ -217,6 +228,14 @@ enum Error {
      * @since 5.100
      */
     ERR_TRASH_FILE_TOO_LARGE = KJob::UserDefinedError + 79,
+
+    /**
+     * A copied file doesn't have the same checksum as its source.
+     * Used by CopyJob when verifying copies, see CopyJob::setVerifyChecksums().
+     *
+     * @since 6.0
+     */
+    ERR_CHECKSUM_MISMATCH = KJob::UserDefinedError + 80,
 };
 
 /**
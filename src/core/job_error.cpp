@@ -256,6 +256,9 @@ KIOCORE_EXPORT QString KIO::buildErrorString(int errorCode, const QString &error
     case KIO::ERR_TRASH_FILE_TOO_LARGE:
         result = i18n("File is too large to be trashed.");
         break;
+    case KIO::ERR_CHECKSUM_MISMATCH:
+        result = xi18nc("@info", "The copy of <filename>%1</filename> does not match the original.", errorText);
+        break;
     default:
         result = i18n("Unknown error code %1\n%2\nPlease send a full bug report at https://bugs.kde.org.", errorCode, errorText);
         break;
@@ -1266,6 +1269,16 @@ KIOCORE_EXPORT QByteArray KIO::rawErrorDetail(int errorCode, const QString &erro
         solutions << i18n("Reformat the destination drive to use a filesystem that supports files that large.");
         break;
 
+    case KIO::ERR_CHECKSUM_MISMATCH:
+        errorName = xi18nc("@info", "Copy of <filename>%1</filename> is damaged", errorText);
+        description = xi18nc("@info",
+                             "The checksum of the copy of <filename>%1</filename> differs from the original's,"
+                             " the data was altered while being transferred or written.",
+                             errorText);
+        causes << i18n("The storage medium or the network connection may be faulty.");
+        solutions << i18n("Try copying the file again.");
+        break;
+
     default:
         // fall back to the plain error...
         errorName = i18n("Undocumented Error");
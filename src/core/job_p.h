@@ -273,6 +273,9 @@ public:
     bool m_internalSuspended;
     bool m_errorPage;
     QByteArray staticData;
+    // An oversized buffer from dataReq() and how much of it was sent already
+    QByteArray m_splitData;
+    qsizetype m_splitDataOffset = 0;
     QUrl m_redirectionURL;
     QList<QUrl> m_redirectionList;
     QString m_mimetype;
@@ -281,6 +284,11 @@ public:
     QPointer<QIODevice> m_outgoingDataSource;
     QMetaObject::Connection m_readChannelFinishedConnection;
 
+    // Chunks the worker allows us to send without waiting for a request
+    int m_dataCredit = 0;
+    bool m_sentLastChunk = false;
+    bool m_sendingDataCredit = false;
+
     /**
      * Flow control. Suspend data processing from the worker.
      */
@@ -305,6 +313,18 @@ public:
     virtual void slotDataReqFromDevice();
     void slotIODeviceClosed();
     void slotIODeviceClosedBeforeStart();
+    /**
+     * @internal
+     * Called when the worker grants @p chunks more chunks of credit,
+     * replacing one dataReq() per chunk.
+     */
+    void slotDataCredit(int chunks);
+    /**
+     * @internal
+     * Sends data ahead while there is credit left and data is available
+     * right away.
+     */
+    void sendDataCredit();
     void slotPostRedirection();
 
     Q_DECLARE_PUBLIC(TransferJob)
@@ -44,6 +44,23 @@ Q_LOGGING_CATEGORY(KIO_CORE_DIRLISTER, "kf.kio.core.dirlister", QtWarningMsg)
 
 QThreadStorage<KCoreDirListerCache> s_kDirListerCache;
 
+// Sets the details to list beyond the default ones, if any
+static void addListDetails(KIO::ListJob *job, const QUrl &url, bool withMimeType)
+{
+    KIO::StatDetails details = KIO::StatDefaultDetails;
+    if (withMimeType) {
+        details |= KIO::StatMimeType;
+    }
+    // The device ids let KFileItem::isSlow() look up the filesystem type once per device.
+    // It only does that for local files, other workers would send them for nothing.
+    if (url.isLocalFile()) {
+        details |= KIO::StatInode;
+    }
+    if (withMimeType || url.isLocalFile()) {
+        job->addMetaData(QStringLiteral("details"), QString::number(details));
+    }
+}
+
 KCoreDirListerCache::KCoreDirListerCache()
     : itemsCached(10)
     , // keep the last 10 directories around
@@ -196,9 +213,7 @@ bool KCoreDirListerCache::listDir(KCoreDirLister *lister, const QUrl &dirUrl, bo
             }
 
             KIO::ListJob *job = KIO::listDir(_url, KIO::HideProgressInfo);
-            if (lister->requestMimeTypeWhileListing()) {
-                job->addMetaData(QStringLiteral("details"), QString::number(KIO::StatDefaultDetails | KIO::StatMimeType));
-            }
+            addListDetails(job, _url, lister->requestMimeTypeWhileListing());
             runningListJobs.insert(job, KIO::UDSEntryList());
 
             lister->jobStarted(job);
@@ -661,9 +676,7 @@ void KCoreDirListerCache::updateDirectory(const QUrl &_dir)
         return lister->requestMimeTypeWhileListing();
     });
 
-    if (requestFromListers || requestFromholders) {
-        job->addMetaData(QStringLiteral("details"), QString::number(KIO::StatDefaultDetails | KIO::StatMimeType));
-    }
+    addListDetails(job, dir, requestFromListers || requestFromholders);
 
     connect(job, &KIO::ListJob::entries, this, &KCoreDirListerCache::slotUpdateEntries);
     connect(job, &KJob::result, this, &KCoreDirListerCache::slotUpdateResult);
@@ -863,7 +863,9 @@ bool KFileItemPrivate::isSlow() const
     if (m_slow == SlowUnknown) {
         const QString path = localPath();
         if (!path.isEmpty()) {
-            const KFileSystemType::Type fsType = KFileSystemType::fileSystemType(path);
+            // The device id of a symlink isn't the one of its target
+            const qint64 deviceId = m_bLink ? -1 : m_entry.numberValue(KIO::UDSEntry::UDS_DEVICE_ID, -1);
+            const KFileSystemType::Type fsType = KIOPrivate::fileSystemType(path, deviceId);
             m_slow = (fsType == KFileSystemType::Nfs || fsType == KFileSystemType::Smb) ? Slow : Fast;
         } else {
             m_slow = Slow;
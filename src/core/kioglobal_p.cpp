@@ -7,8 +7,17 @@
 
 #include "kioglobal_p.h"
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
 #include <QStandardPaths>
 
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
 using LocationMap = QMap<QString, QString>;
 
 static QMap<QString, QString> standardLocationsMap()
@@ -50,3 +59,82 @@ QString KIOPrivate::iconForStandardPath(const QString &localDirectory)
     static auto map = standardLocationsMap();
     return map.value(localDirectory, QString());
 }
+
+namespace
+{
+// Filesystem type of each device, so that the items of a mount don't look it up again.
+// Device ids get reused by other filesystems after unmounting, so the cache is
+// dropped whenever the mounts change.
+class FileSystemTypeCache
+{
+public:
+    ~FileSystemTypeCache()
+    {
+#ifdef Q_OS_LINUX
+        if (m_mountsFd != -1) {
+            ::close(m_mountsFd);
+        }
+#endif
+    }
+
+    KFileSystemType::Type type(qint64 deviceId, const QString &path)
+    {
+        QMutexLocker locker(&m_mutex);
+        dropIfMountsChanged();
+        const auto it = m_types.constFind(deviceId);
+        if (it != m_types.cend()) {
+            return it.value();
+        }
+        // Can block on network mounts, don't hold up other threads meanwhile
+        locker.unlock();
+        const KFileSystemType::Type type = KFileSystemType::fileSystemType(path);
+        locker.relock();
+        m_types.insert(deviceId, type);
+        return type;
+    }
+
+private:
+    void dropIfMountsChanged()
+    {
+        // Checked once per interval rather than for every item
+        if (m_lastCheck.isValid() && !m_lastCheck.hasExpired(s_checkInterval)) {
+            return;
+        }
+        m_lastCheck.start();
+#ifdef Q_OS_LINUX
+        // The kernel flags the mount table as changed to poll() since the last poll(), or since opening it
+        if (m_mountsFd == -1) {
+            m_mountsFd = ::open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC);
+        }
+        if (m_mountsFd != -1) {
+            pollfd pfd{m_mountsFd, POLLPRI, 0};
+            if (::poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLERR | POLLPRI))) {
+                m_types.clear();
+            }
+            return;
+        }
+#endif
+        // No cheap way to be told about (un)mounts, don't keep the types for long
+        m_types.clear();
+    }
+
+    static constexpr int s_checkInterval = 1000; // ms
+
+    QMutex m_mutex;
+    QHash<qint64, KFileSystemType::Type> m_types;
+    QElapsedTimer m_lastCheck;
+#ifdef Q_OS_LINUX
+    int m_mountsFd = -1;
+#endif
+};
+}
+
+Q_GLOBAL_STATIC(FileSystemTypeCache, s_fileSystemTypes)
+
+KFileSystemType::Type KIOPrivate::fileSystemType(const QString &path, qint64 deviceId)
+{
+    if (deviceId == -1) {
+        return KFileSystemType::fileSystemType(path);
+    }
+    return s_fileSystemTypes()->type(deviceId, path);
+}
@@ -11,6 +11,7 @@
 #include "kiocore_export.h"
 #include <qplatformdefs.h>
 
+#include <KFileSystemType>
 #include <KUser>
 
 #ifdef Q_OS_WIN
@@ -117,6 +118,11 @@ KIOCORE_EXPORT bool changeOwnership(const QString &file, KUserId newOwner, KGrou
 /** Returns an icon name for a standard path,
  * e.g. folder-pictures for any path in QStandardPaths::PicturesLocation */
 QString iconForStandardPath(const QString &localDirectory);
+
+/** Returns the type of the filesystem @p path is on, like KFileSystemType::fileSystemType().
+ * If @p deviceId, the st_dev of @p path, is known, the type is only looked up once per
+ * device, until the mounts change. */
+KIOCORE_EXPORT KFileSystemType::Type fileSystemType(const QString &path, qint64 deviceId = -1);
 }
 
 #endif // KIO_KIOGLOBAL_P_H
@@ -41,11 +41,14 @@ KProtocolInfoPrivate::KProtocolInfoPrivate(const QString &name, const QString &e
     m_supportsMoving = json.value(QStringLiteral("moving")).toBool();
     m_supportsOpening = json.value(QStringLiteral("opening")).toBool();
     m_supportsTruncating = json.value(QStringLiteral("truncating")).toBool();
+    m_supportsVectoredReading = json.value(QStringLiteral("vectoredReading")).toBool();
+    m_supportsBatchRenaming = json.value(QStringLiteral("batchRenaming")).toBool();
     m_canCopyFromFile = json.value(QStringLiteral("copyFromFile")).toBool();
     m_canCopyToFile = json.value(QStringLiteral("copyToFile")).toBool();
     m_canRenameFromFile = json.value(QStringLiteral("renameFromFile")).toBool();
     m_canRenameToFile = json.value(QStringLiteral("renameToFile")).toBool();
     m_canDeleteRecursive = json.value(QStringLiteral("deleteRecursive")).toBool();
+    m_canChmodRecursive = json.value(QStringLiteral("chmodRecursive")).toBool();
 
     // default is "FromURL"
     const QString fnu = json.value(QStringLiteral("fileNameUsedForCopying")).toString();
@@ -39,6 +39,8 @@ public:
     bool m_supportsMoving : 1;
     bool m_supportsOpening : 1;
     bool m_supportsTruncating : 1;
+    bool m_supportsVectoredReading : 1;
+    bool m_supportsBatchRenaming : 1;
     bool m_determineMimetypeFromExtension : 1;
     bool m_canCopyFromFile : 1;
     bool m_canCopyToFile : 1;
@@ -46,6 +48,7 @@ public:
     bool m_canRenameFromFile : 1;
     bool m_canRenameToFile : 1;
     bool m_canDeleteRecursive : 1;
+    bool m_canChmodRecursive : 1;
     bool m_supportsPermissions : 1;
     QString m_defaultMimetype;
     QString m_icon;
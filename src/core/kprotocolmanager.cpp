@@ -796,6 +796,26 @@ bool KProtocolManager::supportsTruncating(const QUrl &url)
     return prot->m_supportsTruncating;
 }
 
+bool KProtocolManager::supportsVectoredReading(const QUrl &url)
+{
+    KProtocolInfoPrivate *prot = findProtocol(url);
+    if (!prot) {
+        return false;
+    }
+
+    return prot->m_supportsVectoredReading;
+}
+
+bool KProtocolManager::supportsBatchRenaming(const QUrl &url)
+{
+    KProtocolInfoPrivate *prot = findProtocol(url);
+    if (!prot) {
+        return false;
+    }
+
+    return prot->m_supportsBatchRenaming;
+}
+
 bool KProtocolManager::canCopyFromFile(const QUrl &url)
 {
     KProtocolInfoPrivate *prot = findProtocol(url);
@@ -846,6 +866,16 @@ bool KProtocolManager::canDeleteRecursive(const QUrl &url)
     return prot->m_canDeleteRecursive;
 }
 
+bool KProtocolManager::canChmodRecursive(const QUrl &url)
+{
+    KProtocolInfoPrivate *prot = findProtocol(url);
+    if (!prot) {
+        return false;
+    }
+
+    return prot->m_canChmodRecursive;
+}
+
 KProtocolInfo::FileNameUsedForCopying KProtocolManager::fileNameUsedForCopying(const QUrl &url)
 {
     KProtocolInfoPrivate *prot = findProtocol(url);
@@ -224,6 +224,32 @@ public:
      */
     static bool supportsTruncating(const QUrl &url);
 
+    /**
+     * Returns whether several ranges of an opened file can be read at once
+     * with FileJob::readv(), which is also what FileJob read-ahead relies on.
+     *
+     * This corresponds to the "vectoredReading=" field in the protocol description file.
+     * Valid values for this field are "true" or "false" (default).
+     *
+     * @param url the url to check
+     * @return true if the protocol supports vectored reading
+     * @since 6.0
+     */
+    static bool supportsVectoredReading(const QUrl &url);
+
+    /**
+     * Returns whether the protocol can rename many files with a single command,
+     * see WorkerBase::renameBatch(). If not, KIO::batchRename() renames them one by one.
+     *
+     * This corresponds to the "batchRenaming=" field in the protocol description file.
+     * Valid values for this field are "true" or "false" (default).
+     *
+     * @param url the url to check
+     * @return true if the protocol supports batch renaming
+     * @since 6.0
+     */
+    static bool supportsBatchRenaming(const QUrl &url);
+
     /**
      * Returns whether the protocol can copy files/objects directly from the
      * filesystem itself. If not, the application will read files from the
@@ -293,6 +319,20 @@ public:
      */
     static bool canDeleteRecursive(const QUrl &url);
 
+    /**
+     * Returns whether the protocol can recursively change permissions of directories
+     * by itself, see WorkerBase::chmodRecursive(). If not (the usual case) then
+     * KIO::chmod() will list the directory and change files one by one.
+     *
+     * This corresponds to the "chmodRecursive=" field in the protocol description file.
+     * Valid values for this field are "true" or "false" (default).
+     *
+     * @param url the url to check
+     * @return true if the protocol can change permissions of a directory tree by itself.
+     * @since 6.0
+     */
+    static bool canChmodRecursive(const QUrl &url);
+
     /**
      * This setting defines the strategy to use for generating a filename, when
      * copying a file or directory to another directory. By default the destination
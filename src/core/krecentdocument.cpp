@@ -12,17 +12,24 @@
 
 #include <QCoreApplication>
 #include <QDir>
-#include <QDomDocument>
+#include <QHash>
 #include <QLockFile>
 #include <QMimeDatabase>
+#include <QMutex>
 #include <QRegularExpression>
 #include <QSaveFile>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
 #include <QXmlStreamWriter>
 
 #include <KConfigGroup>
 #include <KService>
 #include <KSharedConfig>
 
+#include <algorithm>
+#include <utility>
+
 static QString xbelPath()
 {
     return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/recently-used.xbel");
@@ -107,69 +114,97 @@ static const QLatin1String ownerAttribute("owner");
 static const QLatin1String ownerValue("http://freedesktop.org");
 static const QLatin1String typeAttribute("type");
 
-static bool removeOldestEntries(int &maxEntries)
+static const QRegularExpression &hiddenFileRegex()
 {
-    QFile input(xbelPath());
-    if (!input.exists()) {
-        return true;
-    }
+    static const QRegularExpression regex(QStringLiteral("/\\."));
+    return regex;
+}
 
-    // Won't help for GTK applications and whatnot, but we can be good citizens ourselves
-    QLockFile lockFile(xbelPath() + QLatin1String(".lock"));
-    lockFile.setStaleLockTime(0);
-    if (!lockFile.tryLock(100)) { // give it 100ms
-        qCWarning(KIO_CORE) << "Failed to lock recently used";
-        return false;
+// One URL to add, with all the applications that opened it since the last write
+struct PendingBookmark {
+    QUrl url;
+    KRecentDocument::RecentDocumentGroups groups;
+    QList<std::pair<QString, int>> applications; // desktop entry name, number of adds
+    bool found = false;
+};
+
+struct PendingBookmarks {
+    QStringList order; // encoded URLs, in order of addition
+    QHash<QString, PendingBookmark> bookmarks;
+
+    void add(const QUrl &url, const QString &desktopEntryName, const KRecentDocument::RecentDocumentGroups &groups)
+    {
+        const QString href = QString::fromLatin1(url.toEncoded());
+        auto it = bookmarks.find(href);
+        if (it == bookmarks.end()) {
+            order.append(href);
+            it = bookmarks.insert(href, PendingBookmark{url, groups, {}});
+        } else {
+            // Most recent last, like the file
+            order.removeOne(href);
+            order.append(href);
+            if (!groups.isEmpty()) {
+                it->groups = groups;
+            }
+        }
+        auto appIt = std::find_if(it->applications.begin(), it->applications.end(), [&desktopEntryName](const auto &app) {
+            return app.first == desktopEntryName;
+        });
+        if (appIt == it->applications.end()) {
+            it->applications.append({desktopEntryName, 1});
+        } else {
+            ++appIt->second;
+        }
     }
 
-    if (!input.open(QIODevice::ReadOnly)) {
-        qCWarning(KIO_CORE) << "Failed to open existing recently used" << input.errorString();
-        return false;
+    bool isEmpty() const
+    {
+        return order.isEmpty();
     }
+};
 
-    QDomDocument document;
-    document.setContent(&input);
-    input.close();
-
-    auto xbelTags = document.elementsByTagName(xbelTag);
-    if (xbelTags.length() != 1) {
-        qCWarning(KIO_CORE) << "Invalid Xbel file" << input.errorString();
-        return false;
-    }
-    auto xbelElement = document.elementsByTagName(xbelTag).item(0);
-    auto bookmarkList = xbelElement.childNodes();
-    if (bookmarkList.length() <= maxEntries) {
-        return true;
-    }
-
-    QMultiMap<QDateTime, QDomNode> bookmarksByModifiedDate;
-    for (int i = 0; i < bookmarkList.length(); ++i) {
-        const auto node = bookmarkList.item(i);
-        const auto modifiedString = node.attributes().namedItem(modifiedAttribute);
-        const auto modifiedTime = QDateTime::fromString(modifiedString.nodeValue(), Qt::ISODate);
-
-        bookmarksByModifiedDate.insert(modifiedTime, node);
-    }
+// Returns the positions (in document order) of the existing bookmarks to drop
+// so that at most maxEntries remain once @p pending is written.
+static QSet<int> bookmarksToPrune(const QByteArray &content, const PendingBookmarks &pending, int maxEntries, bool ignoreHidden)
+{
+    struct Existing {
+        int position;
+        QDateTime modified;
+    };
+    QList<Existing> candidates;
+    int position = 0;
 
-    int i = 0;
-    // entries are traversed in ascending key order
-    for (auto entry = bookmarksByModifiedDate.keyValueBegin(); entry != bookmarksByModifiedDate.keyValueEnd(); ++entry) {
-        // only keep the maxEntries last nodes
-        if (bookmarksByModifiedDate.size() - i > maxEntries) {
-            xbelElement.removeChild(entry->second);
+    QXmlStreamReader xml(content);
+    while (!xml.atEnd() && !xml.hasError()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement || xml.qualifiedName() != bookmarkTag) {
+            continue;
+        }
+        const QXmlStreamAttributes attributes = xml.attributes();
+        const auto href = attributes.value(hrefAttribute);
+        const bool hidden = ignoreHidden && hiddenFileRegex().match(href).hasMatch();
+        // Hidden ones are dropped anyway and the pending ones become the newest
+        if (!hidden && !pending.bookmarks.contains(href.toString())) {
+            candidates.append({position, QDateTime::fromString(attributes.value(modifiedAttribute).toString(), Qt::ISODate)});
         }
-        ++i;
+        ++position;
     }
 
-    if (input.open(QIODevice::WriteOnly) && input.write(document.toByteArray(2)) != -1) {
-        input.close();
-        return true;
+    QSet<int> pruned;
+    const qsizetype excess = candidates.size() + pending.order.size() - maxEntries;
+    if (excess <= 0) {
+        return pruned;
     }
-    input.close();
-    return false;
+    // Stable, so that of equally old entries the first ones in the file go first
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Existing &a, const Existing &b) {
+        return a.modified < b.modified;
+    });
+    for (qsizetype i = 0; i < std::min(excess, candidates.size()); ++i) {
+        pruned.insert(candidates.at(i).position);
+    }
+    return pruned;
 }
 
-static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentDocument::RecentDocumentGroups groups, int maxEntries, bool ignoreHidden)
+static bool writeXbel(PendingBookmarks pending, int maxEntries, bool ignoreHidden)
 {
     if (!QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation))) {
         qCWarning(KIO_CORE) << "Could not create GenericDataLocation";
@@ -189,12 +224,22 @@ static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentD
     if (input.open(QIODevice::ReadOnly)) {
         existingContent = input.readAll();
     } else if (!input.exists()) { // That it doesn't exist is a very uncommon case
+        if (pending.isEmpty()) {
+            return true;
+        }
         qCDebug(KIO_CORE) << input.fileName() << "does not exist, creating new";
     } else {
         qCWarning(KIO_CORE) << "Failed to open existing recently used" << input.errorString();
         return false;
     }
 
+    // More new URLs than allowed entries, keep the most recent ones
+    while (pending.order.size() > maxEntries) {
+        pending.bookmarks.remove(pending.order.takeFirst());
+    }
+
+    const QSet<int> pruned = bookmarksToPrune(existingContent, pending, maxEntries, ignoreHidden);
+
     QXmlStreamReader xml(existingContent);
 
     xml.readNextStartElement();
@@ -223,10 +268,9 @@ static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentD
     output.writeNamespace(QStringLiteral("http://www.freedesktop.org/standards/desktop-bookmarks"), QStringLiteral("bookmark"));
     output.writeNamespace(QStringLiteral("http://www.freedesktop.org/standards/shared-mime-info"), QStringLiteral("mime"));
 
-    const QString newUrl = QString::fromLatin1(url.toEncoded());
     const QString currentTimestamp = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs).chopped(1) + QStringLiteral("000Z");
 
-    auto addApplicationTag = [&output, desktopEntryName, currentTimestamp, url]() {
+    auto addApplicationTag = [&output, &currentTimestamp](const QUrl &url, const QString &desktopEntryName, int count) {
         output.writeEmptyElement(applicationBookmarkTag);
         output.writeAttribute(nameAttribute, desktopEntryName);
         auto service = KService::serviceByDesktopName(desktopEntryName);
@@ -249,14 +293,13 @@ static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentD
         }
         output.writeAttribute(execAttribute, exec);
         output.writeAttribute(modifiedAttribute, currentTimestamp);
-        output.writeAttribute(countAttribute, QStringLiteral("1"));
+        output.writeAttribute(countAttribute, QString::number(count));
     };
 
-    bool foundExistingApp = false;
-    bool inRightBookmark = false;
-    bool foundMatchingBookmark = false;
+    PendingBookmark *rightBookmark = nullptr;
+    QSet<QString> foundApps;
     bool firstBookmark = true;
-    int nbEntries = 0;
+    int bookmarkPosition = 0;
     while (!xml.atEnd() && !xml.hasError()) {
         if (xml.readNext() == QXmlStreamReader::EndElement && xml.name() == xbelTag) {
             break;
@@ -267,20 +310,23 @@ static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentD
             QXmlStreamAttributes attributes = xml.attributes();
 
             if (tagName == bookmarkTag) {
-                foundExistingApp = false;
+                foundApps.clear();
                 firstBookmark = false;
 
                 const auto hrefValue = attributes.value(hrefAttribute);
-                inRightBookmark = hrefValue == newUrl;
+                auto it = pending.bookmarks.find(hrefValue.toString());
+                rightBookmark = it != pending.bookmarks.end() ? &it.value() : nullptr;
+                const bool isPruned = pruned.contains(bookmarkPosition++);
 
-                // remove hidden files if some were added by GTK
-                if (ignoreHidden && QRegularExpression(QStringLiteral("/\\.")).match(hrefValue).hasMatch()) {
+                // remove hidden files if some were added by GTK, and the oldest entries above maxEntries
+                if (isPruned || (ignoreHidden && hiddenFileRegex().match(hrefValue).hasMatch())) {
+                    rightBookmark = nullptr;
                     xml.skipCurrentElement();
                     break;
                 }
 
-                if (inRightBookmark) {
-                    foundMatchingBookmark = true;
+                if (rightBookmark) {
+                    rightBookmark->found = true;
 
                     QXmlStreamAttributes newAttributes;
                     for (const QXmlStreamAttribute &old : attributes) {
@@ -296,29 +342,33 @@ static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentD
                     newAttributes.append(visitedAttribute, currentTimestamp);
                     attributes = newAttributes;
                 }
-
-                nbEntries += 1;
             }
 
-            else if (inRightBookmark && tagName == applicationBookmarkTag && attributes.value(nameAttribute) == desktopEntryName) {
-                // case found right bookmark and same application
-                const int count = attributes.value(countAttribute).toInt();
+            else if (rightBookmark && tagName == applicationBookmarkTag) {
+                const auto name = attributes.value(nameAttribute);
+                auto app = std::find_if(rightBookmark->applications.cbegin(), rightBookmark->applications.cend(), [&name](const auto &application) {
+                    return application.first == name;
+                });
+                if (app != rightBookmark->applications.cend()) {
+                    // case found right bookmark and same application
+                    const int count = attributes.value(countAttribute).toInt();
 
-                QXmlStreamAttributes newAttributes;
-                for (const QXmlStreamAttribute &old : std::as_const(attributes)) {
-                    if (old.name() == countAttribute) {
-                        continue;
-                    }
-                    if (old.name() == modifiedAttribute) {
-                        continue;
+                    QXmlStreamAttributes newAttributes;
+                    for (const QXmlStreamAttribute &old : std::as_const(attributes)) {
+                        if (old.name() == countAttribute) {
+                            continue;
+                        }
+                        if (old.name() == modifiedAttribute) {
+                            continue;
+                        }
+                        newAttributes.append(old);
                     }
-                    newAttributes.append(old);
-                }
-                newAttributes.append(modifiedAttribute, currentTimestamp);
-                newAttributes.append(countAttribute, QString::number(count + 1));
-                attributes = newAttributes;
+                    newAttributes.append(modifiedAttribute, currentTimestamp);
+                    newAttributes.append(countAttribute, QString::number(count + app->second));
+                    attributes = newAttributes;
 
-                foundExistingApp = true;
+                    foundApps.insert(app->first);
+                }
             }
 
             output.writeStartElement(tagName.toString());
@@ -327,9 +377,13 @@ static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentD
         }
         case QXmlStreamReader::EndElement: {
             const QStringView tagName = xml.qualifiedName();
-            if (tagName == applicationsBookmarkTag && inRightBookmark && !foundExistingApp) {
-                // add an application to the applications already known for the bookmark
-                addApplicationTag();
+            if (tagName == applicationsBookmarkTag && rightBookmark) {
+                // add the applications not already known for the bookmark
+                for (const auto &[name, count] : std::as_const(rightBookmark->applications)) {
+                    if (!foundApps.contains(name)) {
+                        addApplicationTag(rightBookmark->url, name, count);
+                    }
+                }
             }
             output.writeEndElement();
             break;
@@ -345,30 +399,36 @@ static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentD
             output.writeComment(xml.text().toString());
             break;
         case QXmlStreamReader::EndDocument:
-            qCWarning(KIO_CORE) << "Malformed, got end document before end of xbel" << xml.tokenString() << url;
+            qCWarning(KIO_CORE) << "Malformed, got end document before end of xbel" << xml.tokenString();
             return false;
         default:
-            qCWarning(KIO_CORE) << "unhandled token" << xml.tokenString() << url;
+            qCWarning(KIO_CORE) << "unhandled token" << xml.tokenString();
             break;
         }
     }
 
-    if (!foundMatchingBookmark) {
+    QMimeDatabase mimeDb;
+    for (const QString &href : std::as_const(pending.order)) {
+        const PendingBookmark &bookmark = pending.bookmarks[href];
+        if (bookmark.found) {
+            continue;
+        }
+
         // must create new bookmark tag
         if (firstBookmark) {
             output.writeCharacters(QStringLiteral("\n"));
+            firstBookmark = false;
         }
         output.writeCharacters(QStringLiteral("  "));
         output.writeStartElement(bookmarkTag);
 
-        output.writeAttribute(hrefAttribute, newUrl);
+        output.writeAttribute(hrefAttribute, href);
         output.writeAttribute(addedAttribute, currentTimestamp);
         output.writeAttribute(modifiedAttribute, currentTimestamp);
         output.writeAttribute(visitedAttribute, currentTimestamp);
 
         {
-            QMimeDatabase mimeDb;
-            const auto fileMime = mimeDb.mimeTypeForUrl(url).name();
+            const auto fileMime = mimeDb.mimeTypeForUrl(bookmark.url).name();
 
             output.writeStartElement(infoTag);
             output.writeStartElement(metadataTag);
@@ -378,12 +438,10 @@ static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentD
             output.writeAttribute(typeAttribute, fileMime);
 
             // write groups metadata
-            if (groups.isEmpty()) {
-                groups = groupsForMimeType(fileMime);
-            }
+            const KRecentDocument::RecentDocumentGroups groups = bookmark.groups.isEmpty() ? groupsForMimeType(fileMime) : bookmark.groups;
             if (!groups.isEmpty()) {
                 output.writeStartElement(bookmarkGroups);
-                for (const auto &group : std::as_const(groups)) {
+                for (const auto &group : groups) {
                     output.writeTextElement(bookmarkGroup, stringForRecentDocumentGroup(group));
                 }
                 // bookmarkGroups
@@ -392,7 +450,9 @@ static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentD
 
             {
                 output.writeStartElement(applicationsBookmarkTag);
-                addApplicationTag();
+                for (const auto &[name, count] : bookmark.applications) {
+                    addApplicationTag(bookmark.url, name, count);
+                }
                 // end applicationsBookmarkTag
                 output.writeEndElement();
             }
@@ -413,14 +473,85 @@ static bool addToXbel(const QUrl &url, const QString &desktopEntryName, KRecentD
     // end document
     output.writeEndDocument();
 
-    if (outputFile.commit()) {
-        lockFile.unlock();
-        // tolerate 10 more entries than threshold to limit overhead of cleaning old data
-        return nbEntries - maxEntries > 10 || removeOldestEntries(maxEntries);
-    }
-    return false;
+    return outputFile.commit();
 }
 
+// Adds are collected and written in one pass over the file, shortly after the
+// last one, when called from a thread running an event loop. Otherwise (e.g.
+// command line tools) there's nothing to deliver the timer, so write right away.
+class RecentDocumentWriter
+{
+public:
+    static RecentDocumentWriter *instance()
+    {
+        static RecentDocumentWriter s_writer;
+        return &s_writer;
+    }
+
+    void add(const QUrl &url, const QString &desktopEntryName, const KRecentDocument::RecentDocumentGroups &groups, int maxEntries, bool ignoreHidden)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_pending.isEmpty() && (m_maxEntries != maxEntries || m_ignoreHidden != ignoreHidden)) {
+            flushLocked();
+        }
+        m_pending.add(url, desktopEntryName, groups);
+        m_maxEntries = maxEntries;
+        m_ignoreHidden = ignoreHidden;
+
+        QCoreApplication *app = QCoreApplication::instance();
+        if (!app || QThread::currentThread() != app->thread() || QThread::currentThread()->loopLevel() == 0) {
+            flushLocked();
+            return;
+        }
+        if (!m_timer) {
+            m_timer = new QTimer(app);
+            m_timer->setSingleShot(true);
+            m_timer->setInterval(s_writeDelay);
+            QObject::connect(m_timer, &QTimer::timeout, app, [this]() {
+                flush();
+            });
+            QObject::connect(app, &QCoreApplication::aboutToQuit, app, [this]() {
+                flush();
+            });
+            qAddPostRoutine([]() {
+                RecentDocumentWriter::instance()->flush();
+            });
+        }
+        m_timer->start();
+    }
+
+    void flush()
+    {
+        QMutexLocker locker(&m_mutex);
+        flushLocked();
+    }
+
+    void discard()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending = {};
+    }
+
+private:
+    static constexpr int s_writeDelay = 500; // ms
+
+    void flushLocked()
+    {
+        if (m_pending.isEmpty()) {
+            return;
+        }
+        if (!writeXbel(std::exchange(m_pending, {}), m_maxEntries, m_ignoreHidden)) {
+            qCWarning(KIO_CORE) << "Failed to add to recently used bookmark file";
+        }
+    }
+
+    QMutex m_mutex;
+    PendingBookmarks m_pending;
+    int m_maxEntries = 0;
+    bool m_ignoreHidden = true;
+    QTimer *m_timer = nullptr;
+};
+
 static QMap<QUrl, QDateTime> xbelRecentlyUsedList()
 {
     QMap<QUrl, QDateTime> ret;
@@ -473,6 +604,7 @@ static QMap<QUrl, QDateTime> xbelRecentlyUsedList()
 
 QList<QUrl> KRecentDocument::recentUrls()
 {
+    RecentDocumentWriter::instance()->flush();
     QMap<QUrl, QDateTime> documents = xbelRecentlyUsedList();
 
     QList<QUrl> ret = documents.keys();
@@ -519,17 +651,24 @@ void KRecentDocument::add(const QUrl &url, const QString &desktopEntryName, KRec
         clear();
         return;
     }
-    if (ignoreHidden && QRegularExpression(QStringLiteral("/\\.")).match(url.toLocalFile()).hasMatch()) {
+    if (ignoreHidden && hiddenFileRegex().match(url.toLocalFile()).hasMatch()) {
         return;
     }
 
-    if (!addToXbel(url, desktopEntryName, groups, maxEntries, ignoreHidden)) {
-        qCWarning(KIO_CORE) << "Failed to add to recently used bookmark file";
-    }
+    RecentDocumentWriter::instance()->add(url, desktopEntryName, groups, maxEntries, ignoreHidden);
+}
+
+bool KRecentDocument::clearEntriesOldestEntries(int maxEntries)
+{
+    RecentDocumentWriter::instance()->flush();
+    KConfigGroup config = KSharedConfig::openConfig()->group(QStringLiteral("RecentDocuments"));
+    const bool ignoreHidden = config.readEntry(QStringLiteral("IgnoreHidden"), true);
+    return writeXbel(PendingBookmarks(), maxEntries, ignoreHidden);
 }
 
 void KRecentDocument::clear()
 {
+    RecentDocumentWriter::instance()->discard();
     QFile(xbelPath()).remove();
 }
 
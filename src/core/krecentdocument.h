@@ -80,6 +80,10 @@ public:
     /**
      * Add a new item to the Recent Document menu.
      *
+     * When called from a thread running an event loop, the recently used file
+     * is updated shortly afterwards, together with the other documents added
+     * in the meantime.
+     *
      * @param url The url to add.
      */
     static void add(const QUrl &url);
@@ -99,6 +103,11 @@ public:
     /// @since 5.93
     static void add(const QUrl &url, const QString &desktopEntryName, KRecentDocument::RecentDocumentGroups groups);
 
+    /**
+     * Remove the oldest entries so that at most @p maxEntries remain.
+     *
+     * @return false if the recently used file couldn't be updated
+     */
     static bool clearEntriesOldestEntries(int maxEntries);
 
     /**
@@ -16,6 +16,7 @@
 #include "../utils_p.h"
 
 #include <QDebug>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QHostInfo>
@@ -40,7 +41,7 @@ KSambaSharePrivate::KSambaSharePrivate(KSambaShare *parent)
     , skipUserShare(false)
 {
     setUserSharePath();
-    data = parse(getNetUserShareInfo());
+    loadShares();
 }
 
 KSambaSharePrivate::~KSambaSharePrivate()
@@ -65,11 +66,41 @@ bool KSambaSharePrivate::isSambaInstalled()
 
 void KSambaSharePrivate::setUserSharePath()
 {
-    const QString rawString = testparmParamValue(QStringLiteral("usershare path"));
+    // Both parameters from a single testparm run, it's slow enough to run once per KSambaShare
+    const QStringList args{
+        QStringLiteral("-d0"),
+        QStringLiteral("-s"),
+        QStringLiteral("-v"),
+        QStringLiteral("--section-name"),
+        QStringLiteral("global"),
+    };
+    const QHash<QString, QString> globals = parseTestparmDump(runTestparm(args));
+
+    const QString rawString = globals.value(QStringLiteral("usershare path"));
     const QFileInfo fileInfo(rawString);
     if (fileInfo.isDir()) {
         userSharePath = rawString;
+        // Samba ignores the usershare files then, and so do we
+        skipUserShare = globals.value(QStringLiteral("usershare max shares")) == QLatin1String("0");
+    }
+}
+
+QHash<QString, QString> KSambaSharePrivate::parseTestparmDump(const QByteArray &dump)
+{
+    // "\tusershare path = /var/lib/samba/usershares", below a "[global]" line
+    QHash<QString, QString> values;
+    const QList<QByteArray> lines = dump.split('\n');
+    for (const QByteArray &line : lines) {
+        const int equalsPos = line.indexOf('=');
+        if (equalsPos == -1 || line.trimmed().startsWith('[')) {
+            continue;
+        }
+        const QString name = QString::fromLocal8Bit(line.left(equalsPos).trimmed());
+        if (!name.isEmpty()) {
+            values.insert(name, QString::fromLocal8Bit(line.mid(equalsPos + 1).trimmed()));
+        }
     }
+    return values;
 }
 
 int KSambaSharePrivate::runProcess(const QString &progName, const QStringList &args, QByteArray &stdOut, QByteArray &stdErr)
@@ -94,13 +125,6 @@ int KSambaSharePrivate::runProcess(const QString &progName, const QStringList &a
 
 QString KSambaSharePrivate::testparmParamValue(const QString &parameterName)
 {
-    if (!isSambaInstalled()) {
-        return QString();
-    }
-
-    QByteArray stdErr;
-    QByteArray stdOut;
-
     const QStringList args{
         QStringLiteral("-d0"),
         QStringLiteral("-s"),
@@ -108,6 +132,18 @@ QString KSambaSharePrivate::testparmParamValue(const QString &parameterName)
         parameterName,
     };
 
+    return QString::fromLocal8Bit(runTestparm(args).trimmed());
+}
+
+QByteArray KSambaSharePrivate::runTestparm(const QStringList &args)
+{
+    if (!isSambaInstalled()) {
+        return QByteArray();
+    }
+
+    QByteArray stdErr;
+    QByteArray stdOut;
+
     runProcess(QStringLiteral("testparm"), args, stdOut, stdErr);
 
     // TODO: parse and process error messages.
@@ -150,14 +186,10 @@ QString KSambaSharePrivate::testparmParamValue(const QString &parameterName)
         }
     }
 
-    if (!stdOut.isEmpty()) {
-        return QString::fromLocal8Bit(stdOut.trimmed());
-    }
-
-    return QString();
+    return stdOut;
 }
 
-QByteArray KSambaSharePrivate::getNetUserShareInfo()
+QByteArray KSambaSharePrivate::getNetUserShareInfo(const QString &shareName)
 {
     if (skipUserShare || !isSambaInstalled()) {
         return QByteArray();
@@ -166,10 +198,13 @@ QByteArray KSambaSharePrivate::getNetUserShareInfo()
     QByteArray stdOut;
     QByteArray stdErr;
 
-    const QStringList args{
+    QStringList args{
         QStringLiteral("usershare"),
         QStringLiteral("info"),
     };
+    if (!shareName.isEmpty()) {
+        args << shareName;
+    }
 
     runProcess(QStringLiteral("net"), args, stdOut, stdErr);
 
@@ -190,6 +225,95 @@ QByteArray KSambaSharePrivate::getNetUserShareInfo()
     return stdOut;
 }
 
+void KSambaSharePrivate::loadShares()
+{
+    bool changed = false;
+    if (!updateFromUserShareDir(&changed)) {
+        data = parse(getNetUserShareInfo());
+        updatePathIndex();
+    }
+}
+
+void KSambaSharePrivate::updatePathIndex()
+{
+    sharesByPath.clear();
+    for (auto it = data.cbegin(); it != data.cend(); ++it) {
+        sharesByPath[it.value().path()].append(it.key());
+    }
+}
+
+// Reads the shares straight from the files 'net usershare' keeps in the usershare
+// directory. Only the files that changed since the last call are read again.
+// Returns false if the directory can't be read, 'net usershare info' has to be asked then.
+bool KSambaSharePrivate::updateFromUserShareDir(bool *changed)
+{
+    *changed = false;
+    if (skipUserShare || userSharePath.isEmpty()) {
+        return false;
+    }
+    const QDir dir(userSharePath);
+    if (!dir.isReadable()) {
+        return false;
+    }
+
+    const QFileInfoList entries = dir.entryInfoList(QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot);
+    QHash<QString, UserShareFile> files;
+    files.reserve(entries.size());
+    for (const QFileInfo &info : entries) {
+        // 'net usershare add' writes to a temporary file first, which isn't named like a share
+        const QString fileName = info.fileName();
+        if (!isShareNameValid(fileName)) {
+            continue;
+        }
+
+        UserShareFile file;
+        file.lastModified = info.lastModified();
+        file.size = info.size();
+        const auto it = userShareFiles.constFind(fileName);
+        if (it != userShareFiles.cend() && it->lastModified == file.lastModified && it->size == file.size) {
+            file.share = it->share;
+            files.insert(fileName, file);
+            continue;
+        }
+
+        std::optional<KSambaShareData> share;
+        QFile shareFile(info.filePath());
+        if (shareFile.open(QIODevice::ReadOnly)) {
+            share = parseUserShareFile(shareFile.readAll(), fileName);
+        }
+        if (!share) {
+            // E.g. an ACL with users only Samba can look up
+            const QMap<QString, KSambaShareData> shares = parse(getNetUserShareInfo(fileName));
+            if (shares.contains(fileName)) {
+                share = shares.value(fileName);
+            }
+        }
+        // Broken files are remembered as well, so that they aren't retried until they change
+        if (share) {
+            file.share = *share;
+        }
+        files.insert(fileName, file);
+        *changed = true;
+    }
+
+    // Nothing new or modified, so the entries only differ if files were removed
+    if (!*changed && files.size() != userShareFiles.size()) {
+        *changed = true;
+    }
+    userShareFiles = files;
+
+    if (*changed) {
+        data.clear();
+        for (const UserShareFile &file : std::as_const(userShareFiles)) {
+            if (!file.share.name().isEmpty()) {
+                data.insert(file.share.name(), file.share);
+            }
+        }
+        updatePathIndex();
+    }
+    return true;
+}
+
 QStringList KSambaSharePrivate::shareNames() const
 {
     return data.keys();
@@ -198,11 +322,14 @@ QStringList KSambaSharePrivate::shareNames() const
 QStringList KSambaSharePrivate::sharedDirs() const
 {
     QStringList dirs;
+    dirs.reserve(sharesByPath.size());
 
+    // In the order of the share names, like before there was an index
     QMap<QString, KSambaShareData>::ConstIterator i;
     for (i = data.constBegin(); i != data.constEnd(); ++i) {
-        if (!dirs.contains(i.value().path())) {
-            dirs << i.value().path();
+        const QString path = i.value().path();
+        if (sharesByPath.value(path).constFirst() == i.key()) {
+            dirs << path;
         }
     }
 
@@ -218,11 +345,10 @@ QList<KSambaShareData> KSambaSharePrivate::getSharesByPath(const QString &path)
 {
     QList<KSambaShareData> shares;
 
-    QMap<QString, KSambaShareData>::ConstIterator i;
-    for (i = data.constBegin(); i != data.constEnd(); ++i) {
-        if (i.value().path() == path) {
-            shares << i.value();
-        }
+    const QStringList names = sharesByPath.value(path);
+    shares.reserve(names.size());
+    for (const QString &name : names) {
+        shares << data.value(name);
     }
 
     return shares;
@@ -237,20 +363,14 @@ bool KSambaSharePrivate::isShareNameValid(const QString &name) const
 
 bool KSambaSharePrivate::isDirectoryShared(const QString &path) const
 {
-    QMap<QString, KSambaShareData>::ConstIterator i;
-    for (i = data.constBegin(); i != data.constEnd(); ++i) {
-        if (i.value().path() == path) {
-            return true;
-        }
-    }
-
-    return false;
+    return sharesByPath.contains(path);
 }
 
 bool KSambaSharePrivate::isShareNameAvailable(const QString &name) const
 {
-    // Samba does not allow to name a share with a user name registered in the system
-    return (!KUser::allUserNames().contains(name) && !data.contains(name));
+    // Samba does not allow to name a share with a user name registered in the system.
+    // Looks up just this name, listing all users is slow with big LDAP or sssd directories.
+    return (!data.contains(name) && !KUser(name).isValid());
 }
 
 KSambaShareData::UserShareError KSambaSharePrivate::isPathValid(const QString &path) const
@@ -349,6 +469,7 @@ KSambaShareData::UserShareError KSambaSharePrivate::add(const KSambaShareData &s
         // KSambaShareDataPrivate will be created and added to data when the share
         // definition changes on-disk and we re-parse the data.
         data.insert(shareData.name(), shareData);
+        updatePathIndex();
     }
 
     return (ret == 0) ? KSambaShareData::UserShareOk : KSambaShareData::UserShareSystemError;
@@ -439,12 +560,99 @@ QMap<QString, KSambaShareData> KSambaSharePrivate::parse(const QByteArray &users
     return shares;
 }
 
+// The usershare files store the ACL with SIDs, while 'net usershare info' shows the names.
+// Only the SIDs that can be mapped without asking Samba are handled here.
+std::optional<QString> KSambaSharePrivate::aclFromSids(const QString &sidAcl)
+{
+    QString acl;
+    const QStringList entries = sidAcl.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (const QString &entry : entries) {
+        const qsizetype colon = entry.lastIndexOf(QLatin1Char(':'));
+        if (colon < 0) {
+            return std::nullopt;
+        }
+        const QStringView sid = QStringView(entry).left(colon);
+        bool ok = false;
+        if (sid == QLatin1String("S-1-1-0")) {
+            acl += QLatin1String("Everyone");
+#ifndef Q_OS_WIN
+        } else if (sid.startsWith(QLatin1String("S-1-22-1-"))) {
+            const KUser user(static_cast<K_UID>(sid.mid(9).toUInt(&ok)));
+            if (!ok || !user.isValid()) {
+                return std::nullopt;
+            }
+            acl += QLatin1String("Unix User\\") + user.loginName();
+        } else if (sid.startsWith(QLatin1String("S-1-22-2-"))) {
+            const KUserGroup group(static_cast<K_GID>(sid.mid(9).toUInt(&ok)));
+            if (!ok || !group.isValid()) {
+                return std::nullopt;
+            }
+            acl += QLatin1String("Unix Group\\") + group.name();
+#endif
+        } else {
+            return std::nullopt;
+        }
+        acl += QStringView(entry).mid(colon);
+        acl += QLatin1Char(',');
+    }
+    return acl;
+}
+
+std::optional<KSambaShareData> KSambaSharePrivate::parseUserShareFile(const QByteArray &fileData, const QString &shareName)
+{
+    KSambaShareData shareData;
+    // 'net usershare info' lists the shares by file name, not by the "sharename" entry
+    shareData.dd->name = shareName;
+
+    const QList<QByteArray> lines = fileData.split('\n');
+    for (const QByteArray &line : lines) {
+        // Skips the "#VERSION" header
+        if (line.trimmed().isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        const qsizetype separator = line.indexOf('=');
+        if (separator < 0) {
+            return std::nullopt;
+        }
+        const QByteArray key = line.left(separator);
+        const QString value = QString::fromUtf8(line.mid(separator + 1)).trimmed();
+
+        if (key == "path") {
+            shareData.dd->path = Utils::trailingSlashRemoved(value);
+        } else if (key == "comment") {
+            shareData.dd->comment = value;
+        } else if (key == "usershare_acl") {
+            const std::optional<QString> acl = aclFromSids(value);
+            if (!acl) {
+                return std::nullopt;
+            }
+            shareData.dd->acl = *acl;
+        } else if (key == "guest_ok") {
+            shareData.dd->guestPermission = value;
+        }
+    }
+
+    if (shareData.path().isEmpty()) {
+        return std::nullopt;
+    }
+    return shareData;
+}
+
 void KSambaSharePrivate::slotFileChange(const QString &path)
 {
-    if (path != userSharePath) {
+    // Depending on the backend KDirWatch reports the directory or the changed file
+    if (path != userSharePath && QFileInfo(path).absolutePath() != Utils::trailingSlashRemoved(userSharePath)) {
+        return;
+    }
+    bool changed = true;
+    if (!updateFromUserShareDir(&changed)) {
+        data = parse(getNetUserShareInfo());
+        updatePathIndex();
+        changed = true;
+    }
+    if (!changed) {
         return;
     }
-    data = parse(getNetUserShareInfo());
     qCDebug(KIO_CORE) << "reloading data; path changed:" << path;
     Q_Q(KSambaShare);
     Q_EMIT q->changed();
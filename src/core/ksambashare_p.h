@@ -8,8 +8,12 @@
 #ifndef ksambashare_p_h
 #define ksambashare_p_h
 
+#include <QDateTime>
+#include <QHash>
 #include <QMap>
 
+#include <optional>
+
 #include "ksambasharedata.h"
 
 class QString;
@@ -26,8 +30,13 @@ public:
 
     static int runProcess(const QString &progName, const QStringList &args, QByteArray &stdOut, QByteArray &stdErr);
     static QString testparmParamValue(const QString &parameterName);
+    static QByteArray runTestparm(const QStringList &args);
+    static QHash<QString, QString> parseTestparmDump(const QByteArray &dump);
 
-    QByteArray getNetUserShareInfo();
+    QByteArray getNetUserShareInfo(const QString &shareName = QString());
+    void loadShares();
+    void updatePathIndex();
+    bool updateFromUserShareDir(bool *changed);
     QStringList shareNames() const;
     QStringList sharedDirs() const;
     KSambaShareData getShareByName(const QString &shareName) const;
@@ -44,6 +53,8 @@ public:
     KSambaShareData::UserShareError add(const KSambaShareData &shareData);
     KSambaShareData::UserShareError remove(const KSambaShareData &shareName);
     static QMap<QString, KSambaShareData> parse(const QByteArray &usershareData);
+    static std::optional<KSambaShareData> parseUserShareFile(const QByteArray &fileData, const QString &shareName);
+    static std::optional<QString> aclFromSids(const QString &sidAcl);
 
     void slotFileChange(const QString &path);
 
@@ -51,7 +62,17 @@ private:
     KSambaShare *const q_ptr;
     Q_DECLARE_PUBLIC(KSambaShare)
 
+    // A file in the usershare directory, with the share read from it
+    struct UserShareFile {
+        QDateTime lastModified;
+        qint64 size = 0;
+        KSambaShareData share;
+    };
+
     QMap<QString, KSambaShareData> data;
+    QHash<QString, UserShareFile> userShareFiles;
+    // Share names by path, in the order of data
+    QHash<QString, QStringList> sharesByPath;
     QString smbConf;
     QString userSharePath;
     bool skipUserShare;
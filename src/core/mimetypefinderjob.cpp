@@ -15,10 +15,54 @@
 #include <KLocalizedString>
 #include <KProtocolManager>
 
+#include <QCache>
 #include <QMimeDatabase>
+#include <QMutex>
 #include <QTimer>
 #include <QUrl>
 
+namespace
+{
+// Only this much of a file is downloaded to determine its MIME type,
+// it matches how much QMimeDatabase looks at for magic rules
+constexpr int s_sniffSize = 16 * 1024;
+
+// The MIME types determined by downloading the start of a file, so that opening
+// the same file again doesn't need another get(). Entries are validated against
+// the size and modification time from the stat() that is done anyway.
+class SniffedMimeTypeCache
+{
+public:
+    QString lookup(const QUrl &url, long long mtime, KIO::filesize_t size)
+    {
+        QMutexLocker locker(&m_mutex);
+        const Entry *entry = m_cache.object(url);
+        if (entry && entry->mtime == mtime && entry->size == size) {
+            return entry->mimeType;
+        }
+        return QString();
+    }
+
+    void insert(const QUrl &url, long long mtime, KIO::filesize_t size, const QString &mimeType)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cache.insert(url, new Entry{mimeType, mtime, size});
+    }
+
+private:
+    struct Entry {
+        QString mimeType;
+        long long mtime;
+        KIO::filesize_t size;
+    };
+
+    QMutex m_mutex;
+    QCache<QUrl, Entry> m_cache{200};
+};
+
+Q_GLOBAL_STATIC(SniffedMimeTypeCache, s_sniffedMimeTypes)
+}
+
 class KIO::MimeTypeFinderJobPrivate
 {
 public:
@@ -38,6 +82,11 @@ public:
     QString m_suggestedFileName;
     bool m_followRedirections = true;
     bool m_authPrompts = true;
+
+    // Set from the stat result if the sniffed MIME type can be cached
+    QUrl m_cacheUrl;
+    long long m_mtime = -1;
+    KIO::filesize_t m_size = 0;
 };
 
 KIO::MimeTypeFinderJob::MimeTypeFinderJob(const QUrl &url, QObject *parent)
@@ -121,7 +170,7 @@ void KIO::MimeTypeFinderJobPrivate::statFile()
 {
     Q_ASSERT(m_mimeTypeName.isEmpty());
 
-    constexpr auto statFlags = KIO::StatBasic | KIO::StatResolveSymlink | KIO::StatMimeType;
+    constexpr auto statFlags = KIO::StatBasic | KIO::StatTime | KIO::StatResolveSymlink | KIO::StatMimeType;
 
     KIO::StatJob *job = KIO::stat(m_url, KIO::StatJob::SourceSide, statFlags, KIO::HideProgressInfo);
     if (!m_authPrompts) {
@@ -166,6 +215,19 @@ void KIO::MimeTypeFinderJobPrivate::statFile()
             m_mimeTypeName = QStringLiteral("inode/directory");
             q->emitResult();
         } else { // It's a file
+            // Seen before, unchanged?
+            const long long mtime = entry.numberValue(KIO::UDSEntry::UDS_MODIFICATION_TIME, -1);
+            if (mtime != -1 && m_suggestedFileName.isEmpty()) {
+                m_cacheUrl = m_url;
+                m_mtime = mtime;
+                m_size = entry.numberValue(KIO::UDSEntry::UDS_SIZE, 0);
+                m_mimeTypeName = s_sniffedMimeTypes()->lookup(m_cacheUrl, m_mtime, m_size);
+                if (!m_mimeTypeName.isEmpty()) {
+                    q->emitResult();
+                    return;
+                }
+            }
+
             // Start the timer. Once we get the timer event this
             // protocol server is back in the pool and we can reuse it.
             // This gives better performance than starting a new worker
@@ -201,6 +263,8 @@ void KIO::MimeTypeFinderJobPrivate::scanFileWithGet()
     // qDebug() << this << "Scanning file" << url;
 
     KIO::TransferJob *job = KIO::get(m_url, KIO::NoReload /*reload*/, KIO::HideProgressInfo);
+    // We only need the start of the file, don't wait for a large download
+    job->addMetaData(QStringLiteral("range-end"), QString::number(s_sniffSize - 1));
     if (!m_authPrompts) {
         job->addMetaData(QStringLiteral("no-auth-prompt"), QStringLiteral("true"));
     }
@@ -241,6 +305,10 @@ void KIO::MimeTypeFinderJobPrivate::scanFileWithGet()
             m_mimeTypeName = mime.name();
         }
 
+        if (!m_cacheUrl.isEmpty() && m_cacheUrl == m_url && !m_mimeTypeName.isEmpty()) {
+            s_sniffedMimeTypes()->insert(m_cacheUrl, m_mtime, m_size, m_mimeTypeName);
+        }
+
         if (m_suggestedFileName.isEmpty()) {
             m_suggestedFileName = job->queryMetaData(QStringLiteral("content-disposition-filename"));
         }
@@ -15,6 +15,9 @@
 #include <qplatformdefs.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <tuple>
+#include <utility>
 #ifdef Q_OS_WIN
 #include <process.h>
 #endif
@@ -146,6 +149,18 @@ public:
 #endif
     bool m_rootEntryListed = false;
 
+    // Credit based flow control for data sent by the job, see dataReq()
+    int dataCreditWindow = -1; // in chunks, 0 for one MSG_DATA_REQ per chunk, -1 until negotiated
+    int dataCreditOutstanding = 0; // chunks granted to the job but not received yet
+    QList<QByteArray> earlyData; // chunks that arrived while waiting for another answer
+
+    void resetDataCredit()
+    {
+        dataCreditWindow = -1;
+        dataCreditOutstanding = 0;
+        earlyData.clear();
+    }
+
     bool m_confirmationAsked;
     QSet<QString> m_tempAuths;
     QString m_warningTitle;
@@ -344,7 +359,10 @@ void SlaveBase::dispatchLoop()
             ret = d->appConnection.read(&cmd, data);
 
             if (ret != -1) {
-                if (d->inOpenLoop) {
+                if (cmd == MSG_DATA) {
+                    // Sent ahead within a credit window the previous command didn't use up, e.g. after an error
+                    qCDebug(KIO_CORE) << "Dropping" << data.size() << "bytes of data sent ahead";
+                } else if (d->inOpenLoop) {
                     dispatchOpenCommand(cmd, data);
                 } else {
                     dispatch(cmd, data);
@@ -496,13 +514,31 @@ void SlaveBase::data(const QByteArray &data)
     send(MSG_DATA, data);
 }
 
+// Upper bound for the number of chunks the job may send ahead
+static const int s_maxDataCreditWindow = 16;
+
 void SlaveBase::dataReq()
 {
     // sendMetaData();
     if (d->needSendCanResume) {
         canResume(0);
     }
-    send(MSG_DATA_REQ);
+
+    if (d->dataCreditWindow == -1) {
+        // Jobs that can send ahead say how far, older ones don't and get one MSG_DATA_REQ per chunk
+        d->dataCreditWindow = std::clamp(metaData(QStringLiteral("DataCreditWindow")).toInt(), 0, s_maxDataCreditWindow);
+    }
+    if (d->dataCreditWindow == 0) {
+        send(MSG_DATA_REQ);
+        return;
+    }
+
+    // Top the window up once half of it is used, rather than for every chunk
+    if (d->dataCreditOutstanding <= d->dataCreditWindow / 2) {
+        KIO_DATA << static_cast<qint32>(d->dataCreditWindow - d->dataCreditOutstanding);
+        send(MSG_DATA_CREDIT, data);
+        d->dataCreditOutstanding = d->dataCreditWindow;
+    }
 }
 
 void SlaveBase::opened()
@@ -538,6 +574,7 @@ void SlaveBase::error(int _errid, const QString &_text)
     }
 
     d->m_state = d->ErrorCalled;
+    d->resetDataCredit();
     mIncomingMetaData.clear(); // Clear meta data
     d->rebuildConfig();
     mOutgoingMetaData.clear();
@@ -598,6 +635,7 @@ void SlaveBase::finished()
     }
 
     d->m_state = d->FinishedCalled;
+    d->resetDataCredit();
     mIncomingMetaData.clear(); // Clear meta data
     d->rebuildConfig();
     sendMetaData();
@@ -868,6 +906,12 @@ KIOCORE_EXPORT QString unsupportedActionErrorString(const QString &protocol, int
         return i18n("Changing the ownership of files is not supported with protocol %1.", protocol);
     case CMD_OPEN:
         return i18n("Opening files is not supported with protocol %1.", protocol);
+    case CMD_CHECKSUM:
+        return i18n("Computing checksums is not supported with protocol %1.", protocol);
+    case CMD_CHMOD_RECURSIVE:
+        return i18n("Changing the attributes of folders recursively is not supported with protocol %1.", protocol);
+    case CMD_RENAME_BATCH:
+        return i18n("Renaming several files at once is not supported with protocol %1.", protocol);
     default:
         return i18n("Protocol %1 does not support action %2.", protocol, cmd);
     } /*end switch*/
@@ -1082,6 +1126,9 @@ int SlaveBase::waitForAnswer(int expected1, int expected2, QByteArray &data, int
         }
         if (isSubCommand(cmd)) {
             dispatch(cmd, data);
+        } else if (cmd == MSG_DATA && d->dataCreditOutstanding > 0) {
+            // Sent ahead within the credit window, keep it for readData()
+            d->earlyData.append(data);
         } else {
             qFatal("Fatal Error: Got cmd %d, while waiting for an answer!", cmd);
         }
@@ -1090,8 +1137,18 @@ int SlaveBase::waitForAnswer(int expected1, int expected2, QByteArray &data, int
 
 int SlaveBase::readData(QByteArray &buffer)
 {
-    int result = waitForAnswer(MSG_DATA, 0, buffer);
+    int result;
+    if (!d->earlyData.isEmpty()) {
+        buffer = d->earlyData.takeFirst();
+        result = buffer.size();
+    } else {
+        result = waitForAnswer(MSG_DATA, 0, buffer);
+    }
     // qDebug() << "readData: length = " << result << " ";
+    if (d->dataCreditOutstanding > 0) {
+        // An empty chunk ends the transfer, the job won't use the rest of the window
+        d->dataCreditOutstanding = result > 0 ? d->dataCreditOutstanding - 1 : 0;
+    }
     return result;
 }
 
@@ -1341,6 +1398,47 @@ void SlaveBase::dispatch(int command, const QByteArray &data)
         d->m_state = d->Idle;
         break;
     }
+    case CMD_CHECKSUM: {
+        QStringList algorithms;
+        stream >> url >> algorithms;
+
+        std::pair<QUrl, QStringList> args(url, algorithms);
+        void *data = static_cast<void *>(&args);
+
+        d->m_state = d->InsideMethod;
+        virtual_hook(Checksum, data);
+        d->verifyState("checksum()");
+        d->m_state = d->Idle;
+        break;
+    }
+    case CMD_CHMOD_RECURSIVE: {
+        int permissions;
+        int mask;
+        stream >> url >> permissions >> mask;
+
+        std::tuple<QUrl, int, int> args(url, permissions, mask);
+        void *data = static_cast<void *>(&args);
+
+        d->m_state = d->InsideMethod;
+        virtual_hook(ChmodRecursive, data);
+        d->verifyState("chmodRecursive()");
+        d->m_state = d->Idle;
+        break;
+    }
+    case CMD_RENAME_BATCH: {
+        QList<QUrl> sources;
+        QList<QUrl> destinations;
+        stream >> sources >> destinations;
+
+        std::pair<QList<QUrl>, QList<QUrl>> args(sources, destinations);
+        void *data = static_cast<void *>(&args);
+
+        d->m_state = d->InsideMethod;
+        virtual_hook(RenameBatch, data);
+        d->verifyState("renameBatch()");
+        d->m_state = d->Idle;
+        break;
+    }
     default: {
         // Some command we don't understand.
         // Just ignore it, it may come from some future version of KIO.
@@ -1387,6 +1485,13 @@ void SlaveBase::dispatchOpenCommand(int command, const QByteArray &data)
         virtual_hook(Truncate, data);
         break;
     }
+    case CMD_READV: {
+        KIO::FileRangeList ranges;
+        stream >> ranges;
+        void *data = static_cast<void *>(&ranges);
+        virtual_hook(ReadV, data);
+        break;
+    }
     case CMD_NONE:
         break;
     case CMD_CLOSE:
@@ -1494,6 +1599,22 @@ void SlaveBase::virtual_hook(int id, void *data)
         error(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(protocolName(), CMD_TRUNCATE));
         break;
     }
+    case ReadV: {
+        error(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(protocolName(), CMD_READV));
+        break;
+    }
+    case Checksum: {
+        error(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(protocolName(), CMD_CHECKSUM));
+        break;
+    }
+    case ChmodRecursive: {
+        error(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(protocolName(), CMD_CHMOD_RECURSIVE));
+        break;
+    }
+    case RenameBatch: {
+        error(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(protocolName(), CMD_RENAME_BATCH));
+        break;
+    }
     }
 }
 
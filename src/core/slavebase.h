@@ -943,6 +943,10 @@ protected:
         AppConnectionMade = 0,
         GetFileSystemFreeSpace = 1, // KF6 TODO: Turn into a virtual method
         Truncate = 2, // KF6 TODO: Turn into a virtual method
+        ReadV = 3, // only implemented by WorkerBase
+        Checksum = 4, // only implemented by WorkerBase
+        ChmodRecursive = 5, // only implemented by WorkerBase
+        RenameBatch = 6, // only implemented by WorkerBase
     };
     virtual void virtual_hook(int id, void *data);
 
@@ -12,9 +12,13 @@
 #include <QDebug>
 #include <kurlauthorized.h>
 
+#include <algorithm>
+
 using namespace KIO;
 
 static const int MAX_READ_BUF_SIZE = (64 * 1024); // 64 KB at a time seems reasonable...
+// How many chunks the worker may let us send before it asks for more, see SlaveBase::dataReq()
+static const int s_dataCreditWindow = 8;
 
 TransferJob::TransferJob(TransferJobPrivate &dd)
     : SimpleJob(dd)
@@ -178,9 +182,13 @@ void TransferJob::sendAsyncData(const QByteArray &dataForWorker)
             KIO::filesize_t size = processedAmount(KJob::Bytes) + dataForWorker.size();
             setProcessedAmount(KJob::Bytes, size);
         }
+        if (dataForWorker.isEmpty()) {
+            d->m_sentLastChunk = true;
+        }
     }
 
     d->m_extraFlags &= ~JobPrivate::EF_TransferJobNeedData;
+    d->sendDataCredit();
 }
 
 QString TransferJob::mimetype() const
@@ -201,23 +209,37 @@ void TransferJob::slotDataReq()
 
     d->m_extraFlags |= JobPrivate::EF_TransferJobNeedData;
 
-    if (!d->staticData.isEmpty()) {
-        dataForWorker = d->staticData;
-        d->staticData.clear();
-    } else {
-        Q_EMIT dataReq(this, dataForWorker);
+    // The last slice of the split buffer was written out by the previous call
+    if (d->m_splitDataOffset == d->m_splitData.size()) {
+        d->m_splitData.clear();
+        d->m_splitDataOffset = 0;
+    }
 
-        if (d->m_extraFlags & JobPrivate::EF_TransferJobAsync) {
-            return;
+    // Otherwise, carry on with the remainder of an oversized buffer
+    if (d->m_splitData.isEmpty()) {
+        if (!d->staticData.isEmpty()) {
+            dataForWorker = d->staticData;
+            d->staticData.clear();
+        } else {
+            Q_EMIT dataReq(this, dataForWorker);
+
+            if (d->m_extraFlags & JobPrivate::EF_TransferJobAsync) {
+                return;
+            }
         }
     }
 
     static const int max_size = 14 * 1024 * 1024;
-    if (dataForWorker.size() > max_size) {
-        // qDebug() << "send" << dataForWorker.size() / 1024 / 1024 << "MB of data in TransferJob::dataReq. This needs to be split, which requires a copy. Fix
-        // the application.";
-        d->staticData = QByteArray(dataForWorker.data() + max_size, dataForWorker.size() - max_size);
-        dataForWorker.truncate(max_size);
+    if (d->m_splitData.isEmpty() && dataForWorker.size() > max_size) {
+        d->m_splitData = std::move(dataForWorker);
+    }
+    if (!d->m_splitData.isEmpty()) {
+        // Send the buffer in slices that point into it, rather than copying the
+        // remainder every time. Sending a slice copies it into the socket buffer,
+        // m_splitData is only released once the last one is out.
+        const qsizetype size = std::min<qsizetype>(d->m_splitData.size() - d->m_splitDataOffset, max_size);
+        dataForWorker = QByteArray::fromRawData(d->m_splitData.constData() + d->m_splitDataOffset, size);
+        d->m_splitDataOffset += size;
     }
 
     sendAsyncData(dataForWorker);
@@ -248,6 +270,7 @@ void TransferJobPrivate::internalResume()
     if (m_worker && !q_func()->isSuspended()) {
         m_worker->resume();
     }
+    sendDataCredit();
 }
 
 bool TransferJob::doResume()
@@ -258,6 +281,8 @@ bool TransferJob::doResume()
     }
     if (d->m_internalSuspended) {
         d->internalSuspend();
+    } else {
+        d->sendDataCredit();
     }
     return true;
 }
@@ -300,6 +325,23 @@ void TransferJobPrivate::start(Worker *worker)
     } else {
         q->connect(worker, &WorkerInterface::dataReq, q, &TransferJob::slotDataReq);
     }
+    // A QIODevice that is read asynchronously feeds the worker at its own pace
+    const bool handlesDataCredit = !(m_outgoingDataSource && (m_extraFlags & JobPrivate::EF_TransferJobAsync));
+    if (handlesDataCredit) {
+        q->connect(worker, &WorkerInterface::dataCredit, q, [this](int chunks) {
+            slotDataCredit(chunks);
+        });
+    }
+    m_dataCredit = 0;
+    m_sentLastChunk = false;
+    m_splitData.clear();
+    m_splitDataOffset = 0;
+
+    // Let the worker grant credit instead of requesting every chunk, unless the application said otherwise.
+    // Only for uploads, and only if the credit is used: a worker honouring it would wait for data otherwise.
+    if (m_command == CMD_PUT && handlesDataCredit && !m_outgoingMetaData.contains(QStringLiteral("DataCreditWindow"))) {
+        m_outgoingMetaData.insert(QStringLiteral("DataCreditWindow"), QString::number(s_dataCreditWindow));
+    }
 
     q->connect(worker, &WorkerInterface::redirection, q, &TransferJob::slotRedirection);
 
@@ -357,6 +399,33 @@ void TransferJobPrivate::slotDataReqFromDevice()
     q->sendAsyncData(dataForWorker);
 }
 
+void TransferJobPrivate::slotDataCredit(int chunks)
+{
+    m_dataCredit += chunks;
+    sendDataCredit();
+}
+
+void TransferJobPrivate::sendDataCredit()
+{
+    Q_Q(TransferJob);
+    if (m_sendingDataCredit) {
+        return; // sendAsyncData() called from within the loop below
+    }
+    m_sendingDataCredit = true;
+    // Stop while suspended: FileCopyJob suspends the put job once its buffer is
+    // drained, asking it for more would return an empty chunk, ending the upload.
+    while (m_dataCredit > 0 && m_worker && !m_sentLastChunk && !m_internalSuspended && !q->isSuspended()
+           && !(m_extraFlags & JobPrivate::EF_TransferJobNeedData)) {
+        --m_dataCredit;
+        if (m_outgoingDataSource) {
+            slotDataReqFromDevice();
+        } else {
+            q->slotDataReq();
+        }
+    }
+    m_sendingDataCredit = false;
+}
+
 void TransferJobPrivate::slotIODeviceClosedBeforeStart()
 {
     m_closedBeforeStart = true;
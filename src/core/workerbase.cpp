@@ -102,6 +102,11 @@ void WorkerBase::data(const QByteArray &data)
     d->bridge.data(data);
 }
 
+void WorkerBase::dataVector(const QList<QByteArray> &chunks)
+{
+    d->bridge.dataVector(chunks);
+}
+
 void WorkerBase::dataReq()
 {
     d->bridge.dataReq();
@@ -254,6 +259,11 @@ WorkerResult WorkerBase::seek(KIO::filesize_t)
     return WorkerResult::fail(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(d->protocolName(), CMD_SEEK));
 }
 
+WorkerResult WorkerBase::readv(const KIO::FileRangeList &)
+{
+    return WorkerResult::fail(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(d->protocolName(), CMD_READV));
+}
+
 WorkerResult WorkerBase::truncate(KIO::filesize_t)
 {
     return WorkerResult::fail(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(d->protocolName(), CMD_TRUNCATE));
@@ -314,6 +324,21 @@ WorkerResult WorkerBase::fileSystemFreeSpace(const QUrl &)
     return WorkerResult::fail(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(d->protocolName(), CMD_FILESYSTEMFREESPACE));
 }
 
+WorkerResult WorkerBase::checksum(const QUrl &, const QStringList &)
+{
+    return WorkerResult::fail(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(d->protocolName(), CMD_CHECKSUM));
+}
+
+WorkerResult WorkerBase::chmodRecursive(const QUrl &, int, int)
+{
+    return WorkerResult::fail(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(d->protocolName(), CMD_CHMOD_RECURSIVE));
+}
+
+WorkerResult WorkerBase::renameBatch(const QList<QUrl> &, const QList<QUrl> &)
+{
+    return WorkerResult::fail(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(d->protocolName(), CMD_RENAME_BATCH));
+}
+
 void WorkerBase::worker_status()
 {
     workerStatus(QString(), false);
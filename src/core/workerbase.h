@@ -13,6 +13,7 @@
 #include "udsentry.h"
 // Qt
 #include <QByteArray>
+#include <QStringList>
 // Std
 #include <memory>
 
@@ -109,6 +110,16 @@ public:
      */
     void data(const QByteArray &data);
 
+    /**
+     * Sends the answer to a readv() request to the job, one chunk per
+     * requested range and in the same order. A chunk shorter than the
+     * requested length means the range extends past the end of the file.
+     *
+     * @param chunks the data read for each range
+     * @since 6.0
+     */
+    void dataVector(const QList<QByteArray> &chunks);
+
     /**
      * Asks for data from the job.
      * @see readData
@@ -434,6 +445,15 @@ public:
      * @see KIO::FileJob::read()
      */
     Q_REQUIRED_RESULT virtual WorkerResult seek(KIO::filesize_t offset);
+    /**
+     * readv, i.e.\ read several ranges of the opened file at once.
+     * Answer with a single dataVector() call. Unlike read(), this must not
+     * change the current file offset.
+     * @param ranges the (offset, length) pairs to read
+     * @see KIO::FileJob::readv()
+     * @since 6.0
+     */
+    Q_REQUIRED_RESULT virtual WorkerResult readv(const KIO::FileRangeList &ranges);
     /**
      * truncate
      * @param size size to truncate the file to
@@ -540,6 +560,31 @@ public:
      */
     Q_REQUIRED_RESULT virtual WorkerResult rename(const QUrl &src, const QUrl &dest, JobFlags flags);
 
+    /**
+     * Renames each url in @p src to the url at the same position in @p dest.
+     *
+     * Existing files must not be overwritten, except by items of the same batch
+     * that move away themselves: chains and cycles such as swapping two names
+     * have to be handled, in whatever order works. Either everything is renamed,
+     * or nothing: if an item fails, rename back the ones done so far before
+     * returning its error. Should that fail too, list the positions of the items
+     * that are still renamed in the "renamed" metadata, separated by commas, and
+     * fail with ERR_WORKER_DEFINED listing the items left under a temporary name, if any.
+     *
+     * Report progress with processedSize(), counting renamed items rather than bytes.
+     *
+     * If nothing was renamed, BatchRenameJob renames the items one by one with
+     * rename() after an error, which lets the user resolve conflicts.
+     *
+     * This is only invoked if the worker specifies batchRenaming=true in its protocol file.
+     * The worker emits ERR_FILE_ALREADY_EXIST, ERR_DIR_ALREADY_EXIST, ERR_ACCESS_DENIED or ERR_CANNOT_RENAME
+     *
+     * @see KIO::batchRename()
+     * @see KProtocolManager::supportsBatchRenaming()
+     * @since 6.0
+     */
+    Q_REQUIRED_RESULT virtual WorkerResult renameBatch(const QList<QUrl> &src, const QList<QUrl> &dest);
+
     /**
      * Creates a symbolic link named @p dest, pointing to @p target, which
      * may be a relative or an absolute path.
@@ -561,6 +606,25 @@ public:
      */
     Q_REQUIRED_RESULT virtual WorkerResult chown(const QUrl &url, const QString &owner, const QString &group);
 
+    /**
+     * Change permissions on the directory @p url and everything below it, as
+     * KIO::chmod() with recursive set to true would. The bits in @p mask are
+     * taken from @p permissions, the other ones are kept. Below @p url, "x" bits
+     * are only changed on directories and on files that had one already (chmod +X).
+     * Symlinks are left alone, and entries are changed before the directory
+     * containing them.
+     *
+     * Report progress with processedSize(), counting the changed entries
+     * rather than bytes.
+     *
+     * This is only invoked if the worker specifies chmodRecursive=true in its protocol file.
+     * The worker emits ERR_DOES_NOT_EXIST, ERR_ACCESS_DENIED or ERR_CANNOT_CHMOD
+     *
+     * @see KProtocolManager::canChmodRecursive()
+     * @since 6.0
+     */
+    Q_REQUIRED_RESULT virtual WorkerResult chmodRecursive(const QUrl &url, int permissions, int mask);
+
     /**
      * Sets the modification time for @url.
      * For instance this is what CopyJob uses to set mtime on dirs at the end of a copy.
@@ -630,6 +694,21 @@ public:
      */
     Q_REQUIRED_RESULT virtual WorkerResult fileSystemFreeSpace(const QUrl &url);
 
+    /**
+     * Computes checksums of the file at @p url, without sending its contents.
+     *
+     * Answer with setMetaData("checksum-<algorithm>", hex) for each of the
+     * requested algorithms you can provide, e.g. "checksum-sha256". Skip the
+     * others, the job fails only if none are provided. Computing several
+     * digests should read the data only once.
+     *
+     * @param url the file to compute checksums of
+     * @param algorithms lowercase algorithm names, e.g. "md5" or "sha256", in order of preference
+     * @see KIO::checksum()
+     * @since 6.0
+     */
+    Q_REQUIRED_RESULT virtual WorkerResult checksum(const QUrl &url, const QStringList &algorithms);
+
     /**
      * Called to get the status of the worker. Worker should respond
      * by calling workerStatus(...)
@@ -14,6 +14,12 @@
 
 #include <commands_p.h>
 #include <slavebase.h>
+#include <workerinterface_p.h>
+
+#include <QDataStream>
+
+#include <tuple>
+#include <utility>
 
 namespace KIO
 {
@@ -182,6 +188,15 @@ public:
         mIncomingMetaData = metaData;
     }
 
+    void dataVector(const QList<QByteArray> &chunks)
+    {
+        sendMetaData();
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream << chunks;
+        send(MSG_DATA_VECTOR, data);
+    }
+
     WorkerBase *base = nullptr;
 
 protected:
@@ -197,6 +212,24 @@ protected:
         case SlaveBase::Truncate:
             maybeError(base->truncate(*static_cast<KIO::filesize_t *>(data)));
             return;
+        case SlaveBase::ReadV:
+            maybeError(base->readv(*static_cast<KIO::FileRangeList *>(data)));
+            return;
+        case SlaveBase::Checksum: {
+            const auto *args = static_cast<std::pair<QUrl, QStringList> *>(data);
+            finalize(base->checksum(args->first, args->second));
+            return;
+        }
+        case SlaveBase::ChmodRecursive: {
+            const auto *args = static_cast<std::tuple<QUrl, int, int> *>(data);
+            finalize(base->chmodRecursive(std::get<0>(*args), std::get<1>(*args), std::get<2>(*args)));
+            return;
+        }
+        case SlaveBase::RenameBatch: {
+            const auto *args = static_cast<std::pair<QList<QUrl>, QList<QUrl>> *>(data);
+            finalize(base->renameBatch(args->first, args->second));
+            return;
+        }
         }
 
         maybeError(WorkerResult::fail(ERR_UNSUPPORTED_ACTION, unsupportedActionErrorString(protocolName(), id)));
@@ -116,9 +116,19 @@ bool WorkerInterface::dispatch(int _cmd, const QByteArray &rawdata)
     case MSG_DATA:
         Q_EMIT data(rawdata);
         break;
+    case MSG_DATA_VECTOR: {
+        QList<QByteArray> chunks;
+        stream >> chunks;
+        Q_EMIT dataVector(chunks);
+        break;
+    }
     case MSG_DATA_REQ:
         Q_EMIT dataReq();
         break;
+    case MSG_DATA_CREDIT:
+        stream >> i;
+        Q_EMIT dataCredit(i);
+        break;
     case MSG_OPENED:
         Q_EMIT open();
         break;
@@ -66,6 +66,8 @@ enum Message {
     MSG_HOST_INFO_REQ,
     MSG_PRIVILEGE_EXEC,
     MSG_WORKER_STATUS,
+    MSG_DATA_VECTOR,
+    MSG_DATA_CREDIT,
     // add new ones here once a release is done, to avoid breaking binary compatibility
 };
 
@@ -109,7 +111,9 @@ Q_SIGNALS:
     ///////////
 
     void data(const QByteArray &);
+    void dataVector(const QList<QByteArray> &);
     void dataReq();
+    void dataCredit(int chunks);
     void error(int, const QString &);
     void connected();
     void finished();
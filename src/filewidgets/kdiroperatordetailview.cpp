@@ -89,6 +89,9 @@ bool KDirOperatorDetailView::event(QEvent *event)
         headerView->setSectionResizeMode(2, QHeaderView::ResizeToContents);
         headerView->setStretchLastSection(false);
         headerView->setSectionsMovable(false);
+        // Sizes and dates are about as wide everywhere, measuring the visible rows
+        // is enough and doesn't ask the delegate for thousands of size hints
+        headerView->setResizeContentsPrecision(0);
 
         setColumnHidden(KDirModel::Size, m_hideDetailColumns);
         setColumnHidden(KDirModel::ModifiedTime, m_hideDetailColumns);
@@ -15,6 +15,10 @@
 #include <KFileItemDelegate>
 #include <KIconLoader>
 
+// Items get sizes of their own, so huge directories can't use uniformItemSizes.
+// They are laid out in batches instead, and the first ones show up right away.
+static const int s_layoutBatchSize = 250;
+
 KDirOperatorIconView::KDirOperatorIconView(QWidget *parent, QStyleOptionViewItem::Position aDecorationPosition)
     : QListView(parent)
 {
@@ -22,6 +26,8 @@ KDirOperatorIconView::KDirOperatorIconView(QWidget *parent, QStyleOptionViewItem
     setResizeMode(QListView::Adjust);
     setSpacing(0);
     setMovement(QListView::Static);
+    setLayoutMode(QListView::Batched);
+    setBatchSize(s_layoutBatchSize);
     setDragDropMode(QListView::DragOnly);
     setVerticalScrollMode(QListView::ScrollPerPixel);
     setHorizontalScrollMode(QListView::ScrollPerPixel);
@@ -52,6 +58,33 @@ void KDirOperatorIconView::resizeEvent(QResizeEvent *event)
     updateLayout();
 }
 
+void KDirOperatorIconView::scrollTo(const QModelIndex &index, ScrollHint hint)
+{
+    QListView::scrollTo(index, hint);
+
+    // An item the batched layout didn't get to yet has no position, QListView does
+    // nothing then. Try again once the layout is done, e.g. for the current item
+    // selected right after listing a huge directory.
+    if (index.isValid() && layoutMode() == QListView::Batched && rectForIndex(index).isEmpty()) {
+        pendingScrollIndex = index;
+        pendingScrollHint = hint;
+    } else {
+        pendingScrollIndex = QPersistentModelIndex();
+    }
+}
+
+void KDirOperatorIconView::updateGeometries()
+{
+    QListView::updateGeometries();
+
+    // Called when the batched layout is done, among others
+    if (pendingScrollIndex.isValid() && !rectForIndex(pendingScrollIndex).isEmpty()) {
+        const QModelIndex index = pendingScrollIndex;
+        pendingScrollIndex = QPersistentModelIndex();
+        QListView::scrollTo(index, pendingScrollHint);
+    }
+}
+
 void KDirOperatorIconView::initViewItemOption(QStyleOptionViewItem *option) const
 {
     QListView::initViewItemOption(option);
@@ -9,6 +9,7 @@
 #define KDIROPERATORICONVIEW_P_H
 
 #include <QListView>
+#include <QPersistentModelIndex>
 
 /**
  * Default icon view for KDirOperator using
@@ -21,6 +22,7 @@ public:
     KDirOperatorIconView(QWidget *parent = nullptr, QStyleOptionViewItem::Position decorationPosition = QStyleOptionViewItem::Position::Top);
     ~KDirOperatorIconView() override;
     void setDecorationPosition(QStyleOptionViewItem::Position decorationPosition);
+    void scrollTo(const QModelIndex &index, ScrollHint hint = EnsureVisible) override;
 
 protected:
     void initViewItemOption(QStyleOptionViewItem *option) const override;
@@ -28,12 +30,16 @@ protected:
     void mousePressEvent(QMouseEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
+    void updateGeometries() override;
 
 protected
     Q_SLOT : void updateLayout();
 
 private:
     QStyleOptionViewItem::Position decorationPosition;
+    // Scrolled to before the batched layout got to it
+    QPersistentModelIndex pendingScrollIndex;
+    ScrollHint pendingScrollHint = EnsureVisible;
 };
 
 #endif // KDIROPERATORICONVIEW_P_H
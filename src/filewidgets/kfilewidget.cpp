@@ -66,6 +66,7 @@
 #include <QLoggingCategory>
 #include <QMenu>
 #include <QMimeDatabase>
+#include <QPointer>
 #include <QPushButton>
 #include <QScreen>
 #include <QSplitter>
@@ -111,6 +112,7 @@ public:
     void updateLocationWhatsThis();
     void updateAutoSelectExtension();
     void initPlacesPanel();
+    void setPlacesViewModel();
     void setPlacesViewSplitterSizes();
     void initGUI();
     void readViewConfig();
@@ -248,6 +250,8 @@ public:
     QTimer m_filterDelayTimer;
 
     KFilePlacesModel *m_model = nullptr;
+    // whether m_model is this widget's own rather than the shared one
+    bool m_ownPlacesModel = false;
 
     // whether or not the _user_ has checked the above box
     bool m_autoSelectExtChecked = false;
@@ -373,10 +377,7 @@ KFileWidget::KFileWidget(const QUrl &_startDir, QWidget *parent)
 
     addAction(goToNavigatorAction);
 
-    KUrlComboBox *pathCombo = d->m_urlNavigator->editor();
-    KUrlCompletion *pathCompletionObj = new KUrlCompletion(KUrlCompletion::DirCompletion);
-    pathCombo->setCompletionObject(pathCompletionObj);
-    pathCombo->setAutoDeleteCompletionObject(true);
+    // The editor of the URL navigator comes with a directory completion already
 
     connect(d->m_urlNavigator, &KUrlNavigator::urlChanged, this, [this](const QUrl &url) {
         d->enterUrl(url);
@@ -421,11 +422,20 @@ KFileWidget::KFileWidget(const QUrl &_startDir, QWidget *parent)
     // to stat it.
     bool statRes = false;
     if (filename.isEmpty()) {
-        KIO::StatJob *statJob = KIO::stat(startDir, KIO::HideProgressInfo);
-        KJobWidgets::setWindow(statJob, this);
-        statRes = statJob->exec();
-        // qDebug() << "stat of" << startDir << "-> statRes" << statRes << "isDir" << statJob->statResult().isDir();
-        if (!statRes || !statJob->statResult().isDir()) {
+        bool isDir = false;
+        if (startDir.isLocalFile()) {
+            // No need to wait for a worker, so the listing starts right away
+            const QFileInfo info(startDir.toLocalFile());
+            statRes = info.exists();
+            isDir = info.isDir();
+        } else {
+            KIO::StatJob *statJob = KIO::stat(startDir, KIO::HideProgressInfo);
+            KJobWidgets::setWindow(statJob, this);
+            statRes = statJob->exec();
+            isDir = statRes && statJob->statResult().isDir();
+        }
+        // qDebug() << "stat of" << startDir << "-> statRes" << statRes << "isDir" << isDir;
+        if (!statRes || !isDir) {
             filename = startDir.fileName();
             startDir = startDir.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash);
             // qDebug() << "statJob -> startDir" << startDir << "filename" << filename;
@@ -1030,6 +1040,17 @@ static QString escapeDoubleQuotes(QString &&path)
     return path;
 }
 
+// All the file widgets of the process show the same places. Building the model
+// enumerates the Solid devices and parses the bookmarks, so it's done only once.
+static KFilePlacesModel *sharedPlacesModel()
+{
+    static QPointer<KFilePlacesModel> model;
+    if (!model) {
+        model = new KFilePlacesModel(qApp);
+    }
+    return model;
+}
+
 void KFileWidgetPrivate::initDirOpWidgets()
 {
     m_opsWidget = new QWidget(q);
@@ -1037,7 +1058,7 @@ void KFileWidgetPrivate::initDirOpWidgets()
     m_opsWidgetLayout->setContentsMargins(0, 0, 0, 0);
     m_opsWidgetLayout->setSpacing(0);
 
-    m_model = new KFilePlacesModel(q);
+    m_model = sharedPlacesModel();
 
     // Don't pass "startDir" (KFileWidget constructor 1st arg) to the
     // KUrlNavigator at this stage: it may also contain a file name which
@@ -1373,7 +1394,7 @@ void KFileWidgetPrivate::initPlacesPanel()
     m_placesDock->setTitleBarWidget(new KDEPrivate::KFileWidgetDockTitleBar(m_placesDock));
 
     m_placesView = new KFilePlacesView(m_placesDock);
-    m_placesView->setModel(m_model);
+    setPlacesViewModel();
     m_placesView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
 
     m_placesView->setObjectName(QStringLiteral("url bar"));
@@ -1381,11 +1402,6 @@ void KFileWidgetPrivate::initPlacesPanel()
         enterUrl(url);
     });
 
-    QObject::connect(qobject_cast<KFilePlacesModel *>(m_placesView->model()), &KFilePlacesModel::errorMessage, q, [this](const QString &errorMessage) {
-        m_messageWidget->setText(errorMessage);
-        m_messageWidget->animatedShow();
-    });
-
     // need to set the current url of the urlbar manually (not via urlEntered()
     // here, because the initial url of KDirOperator might be the same as the
     // one that will be set later (and then urlEntered() won't be emitted).
@@ -1416,6 +1432,35 @@ void KFileWidgetPrivate::setPlacesViewSplitterSizes()
     }
 }
 
+// Whether the active window is the one of @p widget, or a dialog opened from it
+static bool isInActiveWindow(QWidget *widget)
+{
+    for (QWidget *window = QApplication::activeWindow(); window; window = window->parentWidget()) {
+        if (window->window() == widget->window()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void KFileWidgetPrivate::setPlacesViewModel()
+{
+    if (KFilePlacesModel *oldModel = qobject_cast<KFilePlacesModel *>(m_placesView->model())) {
+        QObject::disconnect(oldModel, &KFilePlacesModel::errorMessage, q, nullptr);
+    }
+    m_placesView->setModel(m_model);
+
+    QObject::connect(m_model, &KFilePlacesModel::errorMessage, q, [this](const QString &errorMessage) {
+        // The errors of the shared model come from what the user did in one of the widgets,
+        // only that one shows them
+        if (!m_ownPlacesModel && !isInActiveWindow(q)) {
+            return;
+        }
+        m_messageWidget->setText(errorMessage);
+        m_messageWidget->animatedShow();
+    });
+}
+
 void KFileWidgetPrivate::initGUI()
 {
     delete m_boxLayout; // deletes all sub layouts
@@ -2887,6 +2932,15 @@ void KFileWidget::setViewMode(KFile::FileView mode)
 
 void KFileWidget::setSupportedSchemes(const QStringList &schemes)
 {
+    // The shared places model lists the places of all schemes
+    if (!d->m_ownPlacesModel && !schemes.isEmpty()) {
+        d->m_model = new KFilePlacesModel(this);
+        d->m_ownPlacesModel = true;
+        d->m_urlNavigator->setPlacesModel(d->m_model);
+        if (d->m_placesView) {
+            d->setPlacesViewModel();
+        }
+    }
     d->m_model->setSupportedSchemes(schemes);
     d->m_ops->setSupportedSchemes(schemes);
     d->m_urlNavigator->setSupportedSchemes(schemes);
@@ -33,16 +33,20 @@
 #include <KLocalizedString>
 #include <KMessageBox>
 #include <KMessageWidget>
+#include <KSharedDataCache>
 #include <KShell>
 
 #include <QActionGroup>
+#include <QDataStream>
 #include <QDebug>
 #include <QDialog>
 #include <QDialogButtonBox>
 #include <QDir>
+#include <QFileInfo>
 #include <QLabel>
 #include <QLineEdit>
 #include <QList>
+#include <QLocale>
 #include <QMenu>
 #include <QMimeDatabase>
 #include <QPushButton>
@@ -83,6 +87,7 @@ public:
         , filesParsed(false)
         , templatesList(nullptr)
         , templatesVersion(0)
+        , templatesCache(QStringLiteral("kio_newfilemenu_templates"), 512 * 1024)
     {
     }
 
@@ -97,6 +102,12 @@ public:
      */
     void parseFiles();
 
+    /**
+     * Fills templatesList from the cache, if @p stamp matches the one the entries
+     * were stored with. Otherwise remembers @p key and @p stamp for parseFiles().
+     */
+    bool readCache(const QString &key, const QByteArray &stamp);
+
     enum EntryType {
         Unknown = 0, // Not parsed, i.e. we don't know
         LinkToTemplate, // A desktop file that points to a file or dir to copy
@@ -135,8 +146,56 @@ public:
      * to templatesVersion before showing up
      */
     int templatesVersion;
+
+    /**
+     * The parsed templates, shared by all processes so that only the first
+     * one parses the desktop files.
+     */
+    KSharedDataCache templatesCache;
+    QString cacheKey;
+    QByteArray cacheStamp;
 };
 
+// Part of the cache key, to be increased whenever the format of the cached entries changes,
+// e.g. when Entry gets a new member
+static const int s_templatesCacheVersion = 1;
+
+static QDataStream &operator<<(QDataStream &stream, const KNewFileMenuSingleton::Entry &entry)
+{
+    // mimeType is only determined when filling the menu
+    return stream << entry.text << entry.filePath << entry.templatePath << entry.icon << qint32(entry.entryType) << entry.comment;
+}
+
+static QDataStream &operator>>(QDataStream &stream, KNewFileMenuSingleton::Entry &entry)
+{
+    qint32 entryType;
+    stream >> entry.text >> entry.filePath >> entry.templatePath >> entry.icon >> entryType >> entry.comment;
+    entry.entryType = static_cast<KNewFileMenuSingleton::EntryType>(entryType);
+    return stream;
+}
+
+bool KNewFileMenuSingleton::readCache(const QString &key, const QByteArray &stamp)
+{
+    QByteArray data;
+    if (templatesCache.find(key, &data)) {
+        QDataStream stream(data);
+        stream.setVersion(QDataStream::Qt_6_0);
+        QByteArray cachedStamp;
+        EntryList entries;
+        stream >> cachedStamp >> entries;
+        if (stream.status() == QDataStream::Ok && cachedStamp == stamp) {
+            *templatesList = entries;
+            filesParsed = true;
+            cacheStamp.clear();
+            return true;
+        }
+    }
+
+    cacheKey = key;
+    cacheStamp = stamp;
+    return false;
+}
+
 void KNewFileMenuSingleton::parseFiles()
 {
     // qDebug();
@@ -191,6 +250,15 @@ void KNewFileMenuSingleton::parseFiles()
                         << "entryType=" << templ.entryType
                         << "templatePath=" << templ.templatePath;*/
     }
+
+    if (!cacheStamp.isEmpty()) {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << cacheStamp << *templatesList;
+        templatesCache.insert(cacheKey, data);
+        cacheStamp.clear();
+    }
 }
 
 Q_GLOBAL_STATIC(KNewFileMenuSingleton, kNewMenuGlobals)
@@ -992,6 +1060,20 @@ static QStringList getTemplateFilePaths(const QStringList &templates)
     return files;
 }
 
+// Changes whenever a template directory or file is added, removed or modified
+static QByteArray templatesStamp(const QStringList &dirs, const QStringList &files)
+{
+    QByteArray stamp;
+    QDataStream stream(&stamp, QIODevice::WriteOnly);
+    for (const QStringList *paths : {&dirs, &files}) {
+        stream << *paths;
+        for (const QString &path : *paths) {
+            stream << QFileInfo(path).lastModified().toMSecsSinceEpoch();
+        }
+    }
+    return stamp;
+}
+
 void KNewFileMenuPrivate::slotFillTemplates()
 {
     KNewFileMenuSingleton *instance = kNewMenuGlobals();
@@ -1024,6 +1106,13 @@ void KNewFileMenuPrivate::slotFillTemplates()
     };
     files.erase(std::remove_if(files.begin(), files.end(), removeFunc), files.end());
 
+    // Names and comments are translated
+    const QString cacheKey = QStringLiteral("templates-v%1-").arg(s_templatesCacheVersion) + QLocale().uiLanguages().join(QLatin1Char(':'));
+    if (instance->readCache(cacheKey, templatesStamp(templates, files))) {
+        ++instance->templatesVersion;
+        return;
+    }
+
     std::vector<EntryInfo> uniqueEntries;
 
     for (const QString &file : files) {
@@ -1390,7 +1479,6 @@ void KNewFileMenu::checkUpToDate()
         if (!s->templatesList) { // No templates list up to now
             s->templatesList = new KNewFileMenuSingleton::EntryList;
             d->slotFillTemplates();
-            s->parseFiles();
         }
 
         // This might have been already done for other popupmenus,
@@ -85,6 +85,12 @@ public:
      */
     void appendWidget(QWidget *widget, int stretch = 0);
 
+    /**
+     * Creates the places selector for \a placesModel, without
+     * adding it to the layout.
+     */
+    void createPlacesSelector(KFilePlacesModel *placesModel);
+
     /**
      * This slot is connected to the clicked signal of the navigation bar button. It calls switchView().
      * Moreover, if switching from "editable" mode to the breadcrumb view, it calls applyUncommittedUrl().
@@ -217,16 +223,7 @@ KUrlNavigatorPrivate::KUrlNavigatorPrivate(const QUrl &url, KUrlNavigator *qq, K
     q->setAutoFillBackground(false);
 
     if (placesModel != nullptr) {
-        m_placesSelector = new KUrlNavigatorPlacesSelector(q, placesModel);
-        q->connect(m_placesSelector, &KUrlNavigatorPlacesSelector::placeActivated, q, &KUrlNavigator::setLocationUrl);
-        q->connect(m_placesSelector, &KUrlNavigatorPlacesSelector::tabRequested, q, &KUrlNavigator::tabRequested);
-
-        auto updateContentFunc = [this]() {
-            updateContent();
-        };
-        q->connect(placesModel, &KFilePlacesModel::rowsInserted, q, updateContentFunc);
-        q->connect(placesModel, &KFilePlacesModel::rowsRemoved, q, updateContentFunc);
-        q->connect(placesModel, &KFilePlacesModel::dataChanged, q, updateContentFunc);
+        createPlacesSelector(placesModel);
     }
 
     // create scheme combo
@@ -284,6 +281,21 @@ KUrlNavigatorPrivate::KUrlNavigatorPrivate(const QUrl &url, KUrlNavigator *qq, K
     });
 }
 
+void KUrlNavigatorPrivate::createPlacesSelector(KFilePlacesModel *placesModel)
+{
+    m_placesSelector = new KUrlNavigatorPlacesSelector(q, placesModel);
+    q->connect(m_placesSelector, &KUrlNavigatorPlacesSelector::placeActivated, q, &KUrlNavigator::setLocationUrl);
+    q->connect(m_placesSelector, &KUrlNavigatorPlacesSelector::tabRequested, q, &KUrlNavigator::tabRequested);
+
+    // Bound to the selector, so that replacing the model disconnects them
+    auto updateContentFunc = [this]() {
+        updateContent();
+    };
+    q->connect(placesModel, &KFilePlacesModel::rowsInserted, m_placesSelector, updateContentFunc);
+    q->connect(placesModel, &KFilePlacesModel::rowsRemoved, m_placesSelector, updateContentFunc);
+    q->connect(placesModel, &KFilePlacesModel::dataChanged, m_placesSelector, updateContentFunc);
+}
+
 void KUrlNavigatorPrivate::appendWidget(QWidget *widget, int stretch)
 {
     m_layout->insertWidget(m_layout->count() - 1, widget, stretch);
@@ -1047,6 +1059,22 @@ bool KUrlNavigator::isPlacesSelectorVisible() const
     return d->m_showPlacesSelector;
 }
 
+void KUrlNavigator::setPlacesModel(KFilePlacesModel *placesModel)
+{
+    // Without a places selector yet, it's shown like when passing the model to the constructor
+    const bool showPlacesSelector = d->m_placesSelector == nullptr || d->m_showPlacesSelector;
+    delete d->m_placesSelector;
+    d->m_placesSelector = nullptr;
+
+    d->m_showPlacesSelector = placesModel != nullptr && showPlacesSelector;
+    if (placesModel != nullptr) {
+        d->createPlacesSelector(placesModel);
+        d->m_layout->insertWidget(0, d->m_placesSelector);
+        d->m_placesSelector->setVisible(d->m_showPlacesSelector);
+    }
+    d->updateContent();
+}
+
 QUrl KUrlNavigator::uncommittedUrl() const
 {
     KUriFilterData filteredData(d->m_pathBox->currentText().trimmed());
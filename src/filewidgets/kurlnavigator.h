@@ -229,6 +229,14 @@ public:
     /** @return True, if the places selector is visible. */
     bool isPlacesSelectorVisible() const;
 
+    /**
+     * Replaces the model for the places which are selectable inside
+     * the places selector. If it is 0, no places selector is displayed.
+     * @see KUrlNavigator(KFilePlacesModel *, const QUrl &, QWidget *)
+     * @since 6.0
+     */
+    void setPlacesModel(KFilePlacesModel *placesModel);
+
     /**
      * @return The currently entered, but not accepted URL.
      *         It is possible that the returned URL is not valid.
@@ -1,2 +1,4 @@
 #cmakedefine01 HAVE_X11
 #cmakedefine01 HAVE_WAYLAND
+#cmakedefine01 HAVE_PIDFD_OPEN
+#cmakedefine01 HAVE_POSIX_SPAWN_ADDCHDIR
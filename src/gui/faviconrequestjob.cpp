@@ -21,7 +21,6 @@
 #include <QFileInfo>
 #include <QImage>
 #include <QImageReader>
-#include <QSaveFile>
 #include <QStandardPaths>
 #include <QUrl>
 
@@ -146,15 +145,16 @@ void FavIconRequestJob::slotResult(KJob *job)
             ir.setScaledSize(desired);
             const QImage img = ir.read();
             if (!img.isNull()) {
-                cache->ensureCacheExists();
-                const QString localPath = cache->cachePathForIconUrl(iconUrl);
-                qCDebug(FAVICONS_LOG) << "Saving image to" << localPath;
-                QSaveFile saveFile(localPath);
-                if (saveFile.open(QIODevice::WriteOnly) && img.save(&saveFile, "PNG") && saveFile.commit()) {
-                    d->m_iconFile = localPath;
-                } else {
+                QByteArray png;
+                QBuffer pngBuffer(&png);
+                pngBuffer.open(QIODevice::WriteOnly);
+                img.save(&pngBuffer, "PNG");
+                // The cache writes it, so that it knows about it right away
+                qCDebug(FAVICONS_LOG) << "Saving image to" << cache->cachePathForIconUrl(iconUrl);
+                d->m_iconFile = cache->saveIconFile(iconUrl, png);
+                if (d->m_iconFile.isEmpty()) {
                     setError(KIO::ERR_CANNOT_WRITE);
-                    setErrorText(i18n("Error saving image to %1", localPath));
+                    setErrorText(i18n("Error saving image to %1", cache->cachePathForIconUrl(iconUrl)));
                 }
             } else {
                 qCDebug(FAVICONS_LOG) << "QImageReader read() returned a null image";
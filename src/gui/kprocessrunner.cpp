@@ -35,7 +35,9 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QGuiApplication>
+#include <QHash>
 #include <QProcess>
+#include <QSocketNotifier>
 #include <QStandardPaths>
 #include <QString>
 #include <QTimer>
@@ -47,8 +49,51 @@
 #include "shellapi.h" // Must be included after "windows.h"
 #endif
 
+#if HAVE_PIDFD_OPEN
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char **environ;
+#endif
+
 static int s_instanceCount = 0; // for the unittest
 
+// Looking up an executable walks all of $PATH, which adds up when launching
+// many applications at once. Only successful lookups are remembered, so that
+// newly installed programs are still found, and everything is forgotten when
+// $PATH changes.
+static QString findExecutableCached(const QString &executable)
+{
+    static QByteArray cachedPath;
+    static QHash<QString, QString> cache;
+
+    const QByteArray path = qgetenv("PATH");
+    if (path != cachedPath) {
+        cache.clear();
+        cachedPath = path;
+    }
+
+    auto it = cache.constFind(executable);
+    if (it != cache.cend() && QFileInfo(it.value()).isExecutable()) {
+        return it.value();
+    }
+
+    const QString found = QStandardPaths::findExecutable(executable);
+    if (found.isEmpty()) {
+        cache.remove(executable);
+    } else {
+        cache.insert(executable, found);
+    }
+    return found;
+}
+
 KProcessRunner::KProcessRunner()
     : m_process{new KProcess}
 {
@@ -182,7 +227,7 @@ KProcessRunner *KProcessRunner::fromExecutable(const QString &executable,
                                                const QString &workingDirectory,
                                                const QProcessEnvironment &environment)
 {
-    const QString actualExec = QStandardPaths::findExecutable(executable);
+    const QString actualExec = findExecutableCached(executable);
     if (actualExec.isEmpty()) {
         qCWarning(KIO_GUI) << "Could not find an executable named:" << executable;
         return {};
@@ -333,6 +378,10 @@ void KProcessRunner::init(const KService::Ptr &service, const QString &serviceEn
 
 void ForkingProcessRunner::startProcess()
 {
+    if (spawnProcess()) {
+        return;
+    }
+
     connect(m_process.get(), &QProcess::finished, this, &ForkingProcessRunner::slotProcessExited);
     connect(m_process.get(), &QProcess::started, this, &ForkingProcessRunner::slotProcessStarted, Qt::QueuedConnection);
     connect(m_process.get(), &QProcess::errorOccurred, this, &ForkingProcessRunner::slotProcessError);
@@ -344,12 +393,174 @@ bool ForkingProcessRunner::waitForStarted(int timeout)
     if (m_process->state() == QProcess::NotRunning && m_waitingForXdgToken) {
         QEventLoop loop;
         QObject::connect(m_process.get(), &QProcess::stateChanged, &loop, &QEventLoop::quit);
+        QObject::connect(this, &KProcessRunner::processStarted, &loop, &QEventLoop::quit);
         QTimer::singleShot(timeout, &loop, &QEventLoop::quit);
         loop.exec();
     }
+    if (m_spawnedPid) {
+        return true; // posix_spawn() only returns once the process is running
+    }
     return m_process->waitForStarted(timeout);
 }
 
+// QProcess forks the application, which is costly for a large GUI process
+// even with copy-on-write. posix_spawn() uses vfork semantics on Linux, the
+// child shares our memory until it calls exec. We then learn about the
+// process exiting through a pidfd, so no SIGCHLD handler is involved.
+// Returns false if the process should be started through QProcess instead.
+bool ForkingProcessRunner::spawnProcess()
+{
+#if HAVE_PIDFD_OPEN
+    static const bool s_havePidFd = [] {
+        const int fd = syscall(SYS_pidfd_open, getpid(), 0);
+        if (fd < 0) {
+            return false;
+        }
+        ::close(fd);
+        return true;
+    }();
+    if (!s_havePidFd) {
+        return false;
+    }
+
+    const QStringList program = m_process->program();
+    if (program.isEmpty()) {
+        return false;
+    }
+    QString executable = program.first();
+    if (!executable.contains(QLatin1Char('/'))) {
+        executable = findExecutableCached(executable);
+        if (executable.isEmpty()) {
+            return false; // let QProcess report the error
+        }
+    }
+
+    const QString workingDirectory = m_process->workingDirectory();
+#if !HAVE_POSIX_SPAWN_ADDCHDIR
+    if (!workingDirectory.isEmpty()) {
+        return false;
+    }
+#endif
+
+    // Keep the encoded strings alive until posix_spawn() returns
+    const QByteArray encodedExecutable = QFile::encodeName(executable);
+    QList<QByteArray> encodedArgs;
+    encodedArgs.reserve(program.size());
+    for (const QString &arg : program) {
+        encodedArgs.append(arg.toLocal8Bit());
+    }
+    std::vector<char *> argv;
+    argv.reserve(encodedArgs.size() + 1);
+    for (QByteArray &arg : encodedArgs) {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    // Same as QProcess, an empty environment means inheriting ours
+    QList<QByteArray> encodedEnv;
+    std::vector<char *> envp;
+    const QProcessEnvironment environment = m_process->processEnvironment();
+    if (!environment.isEmpty()) {
+        const QStringList envList = environment.toStringList();
+        encodedEnv.reserve(envList.size());
+        for (const QString &entry : envList) {
+            encodedEnv.append(entry.toLocal8Bit());
+        }
+        envp.reserve(encodedEnv.size() + 1);
+        for (QByteArray &entry : encodedEnv) {
+            envp.push_back(entry.data());
+        }
+        envp.push_back(nullptr);
+    }
+
+    // Like QProcess, the application gets a pipe as stdin that stays open while it runs,
+    // rather than our stdin. Its output is forwarded like KProcess does.
+    int stdinPipe[2];
+    if (pipe2(stdinPipe, O_CLOEXEC) == -1) {
+        return false;
+    }
+
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+    posix_spawn_file_actions_adddup2(&fileActions, stdinPipe[0], STDIN_FILENO);
+#if HAVE_POSIX_SPAWN_ADDCHDIR
+    const QByteArray encodedWorkingDirectory = QFile::encodeName(workingDirectory);
+    if (!workingDirectory.isEmpty()) {
+        posix_spawn_file_actions_addchdir_np(&fileActions, encodedWorkingDirectory.constData());
+    }
+#endif
+
+    // Don't pass on our blocked or ignored signals
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t signals;
+    sigemptyset(&signals);
+    posix_spawnattr_setsigmask(&attributes, &signals);
+    sigfillset(&signals);
+    sigdelset(&signals, SIGKILL);
+    sigdelset(&signals, SIGSTOP);
+    posix_spawnattr_setsigdefault(&attributes, &signals);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    pid_t pid = 0;
+    const int ret = posix_spawn(&pid, encodedExecutable.constData(), &fileActions, &attributes, argv.data(), envp.empty() ? environ : envp.data());
+    posix_spawn_file_actions_destroy(&fileActions);
+    posix_spawnattr_destroy(&attributes);
+    ::close(stdinPipe[0]);
+
+    if (ret != 0) {
+        ::close(stdinPipe[1]);
+        const QString errorString = QString::fromLocal8Bit(strerror(ret));
+        qCDebug(KIO_GUI) << name() << "posix_spawn failed:" << errorString;
+        emitDelayedError(i18n("Could not start the program '%1': %2", program.first(), errorString));
+        return true;
+    }
+
+    m_spawnedPid = pid;
+    m_stdinFd = stdinPipe[1];
+    m_pidFd = syscall(SYS_pidfd_open, pid, 0);
+    if (m_pidFd >= 0) {
+        m_exitNotifier = new QSocketNotifier(m_pidFd, QSocketNotifier::Read, this);
+        connect(m_exitNotifier, &QSocketNotifier::activated, this, &ForkingProcessRunner::slotSpawnedProcessExited);
+    } else {
+        qCWarning(KIO_GUI) << "Could not watch process" << pid << "for" << name() << strerror(errno);
+    }
+
+    // Like QProcess::started, queued so that the caller can connect to processStarted first
+    QMetaObject::invokeMethod(this, &ForkingProcessRunner::slotProcessStarted, Qt::QueuedConnection);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ForkingProcessRunner::slotSpawnedProcessExited()
+{
+#if HAVE_PIDFD_OPEN
+    m_exitNotifier->setEnabled(false);
+
+    int status = 0;
+    pid_t ret;
+    do {
+        ret = waitpid(static_cast<pid_t>(m_spawnedPid), &status, 0);
+    } while (ret == -1 && errno == EINTR);
+
+    ::close(m_pidFd);
+    m_pidFd = -1;
+    ::close(m_stdinFd);
+    m_stdinFd = -1;
+
+    if (ret == -1) {
+        // E.g. SIGCHLD is ignored, so the child was reaped already
+        slotProcessExited(0, QProcess::NormalExit);
+    } else if (WIFEXITED(status)) {
+        slotProcessExited(WEXITSTATUS(status), QProcess::NormalExit);
+    } else {
+        slotProcessExited(WIFSIGNALED(status) ? WTERMSIG(status) : 0, QProcess::CrashExit);
+    }
+#endif
+}
+
 void ForkingProcessRunner::slotProcessError(QProcess::ProcessError errorCode)
 {
     // E.g. the process crashed.
@@ -361,7 +572,7 @@ void ForkingProcessRunner::slotProcessError(QProcess::ProcessError errorCode)
 
 void ForkingProcessRunner::slotProcessStarted()
 {
-    setPid(m_process->processId());
+    setPid(m_spawnedPid ? m_spawnedPid : m_process->processId());
 }
 
 void KProcessRunner::setPid(qint64 pid)
@@ -506,4 +717,18 @@ ForkingProcessRunner::ForkingProcessRunner()
 {
 }
 
+ForkingProcessRunner::~ForkingProcessRunner()
+{
+#if HAVE_PIDFD_OPEN
+    // Unlike QProcess we don't kill the application, it just isn't watched anymore
+    if (m_pidFd >= 0) {
+        delete m_exitNotifier;
+        ::close(m_pidFd);
+    }
+    if (m_stdinFd >= 0) {
+        ::close(m_stdinFd);
+    }
+#endif
+}
+
 #include "moc_kprocessrunner_p.cpp"
@@ -20,6 +20,8 @@
 #include <QObject>
 #include <memory>
 
+class QSocketNotifier;
+
 namespace KIOGuiPrivate
 {
 /**
@@ -168,6 +170,7 @@ class ForkingProcessRunner : public KProcessRunner
 
 public:
     explicit ForkingProcessRunner();
+    ~ForkingProcessRunner() override;
 
     void startProcess() override;
     bool waitForStarted(int timeout) override;
@@ -176,6 +179,16 @@ protected Q_SLOTS:
     void slotProcessExited(int, QProcess::ExitStatus);
     void slotProcessError(QProcess::ProcessError error);
     virtual void slotProcessStarted();
+
+private:
+    bool spawnProcess();
+    void slotSpawnedProcessExited();
+
+    // Set when the process was started with posix_spawn() rather than by m_process
+    qint64 m_spawnedPid = 0;
+    int m_pidFd = -1;
+    int m_stdinFd = -1; // our end of the application's stdin
+    QSocketNotifier *m_exitNotifier = nullptr;
 };
 
 #endif
@@ -14,6 +14,7 @@
 #include "jobuidelegatefactory.h"
 #include "kiogui_debug.h"
 #include "openorexecutefileinterface.h"
+#include "openurljob_timing_debug.h"
 #include "openwithhandlerinterface.h"
 #include "untrustedprogramhandlerinterface.h"
 
@@ -29,14 +30,36 @@
 #include <KProtocolManager>
 #include <KSharedConfig>
 #include <QDesktopServices>
+#include <QElapsedTimer>
+#include <QFuture>
 #include <QHostInfo>
 #include <QMimeDatabase>
 #include <QOperatingSystemVersion>
+#include <QtConcurrentRun>
 #include <mimetypefinderjob.h>
 
+#include <memory>
+
 // For unit test purposes, to test both code paths in externalBrowser()
 KIOGUI_EXPORT bool openurljob_force_use_browserapp_kdeglobals = false;
 
+namespace
+{
+// What we need to know from the filesystem about local executables and .desktop files.
+// Gathered in a thread, since the file may be on a slow mount.
+struct LocalFileChecks {
+    bool hasExecuteBit = false;
+    // For .desktop files
+    bool hasTypeEntry = false;
+    bool isLink = false;
+    QString linkUrl;
+    QString lastOpenedWith;
+    // Type=Application or Type=Service. KService is only created from it on the
+    // job's thread, it may not be used from another one.
+    std::shared_ptr<KDesktopFile> serviceDesktopFile;
+};
+}
+
 class KIO::OpenUrlJobPrivate
 {
 public:
@@ -49,6 +72,8 @@ public:
 
     void emitAccessDenied();
     void runUrlWithMimeType();
+    void startPhase();
+    void endPhase(const char *phase);
     QString externalBrowser() const;
     bool runExternalBrowser(const QString &exe);
     void useSchemeHandler();
@@ -64,8 +89,11 @@ public:
     bool m_showOpenOrExecuteDialog = false;
     bool m_externalBrowserEnabled = true;
     bool m_followRedirections = true;
+    LocalFileChecks m_localFileChecks;
+    QElapsedTimer m_phaseTimer;
 
 private:
+    void runUrlWithMimeTypeHelper(const QMimeType &mimeType);
     void executeCommand();
     void handleBinaries(const QMimeType &mimeType);
     void handleBinariesHelper(const QString &localPath, bool isNativeBinary);
@@ -139,6 +167,8 @@ void KIO::OpenUrlJob::setFollowRedirections(bool b)
 
 void KIO::OpenUrlJob::start()
 {
+    d->startPhase();
+
     if (!d->m_url.isValid() || d->m_url.scheme().isEmpty()) {
         const QString error = !d->m_url.isValid() ? d->m_url.errorString() : d->m_url.toDisplayString();
         setError(KIO::ERR_MALFORMED_URL);
@@ -280,6 +310,7 @@ void KIO::OpenUrlJobPrivate::useSchemeHandler()
 
 void KIO::OpenUrlJobPrivate::startService(const KService::Ptr &service, const QList<QUrl> &urls)
 {
+    startPhase();
     KIO::ApplicationLauncherJob *job = new KIO::ApplicationLauncherJob(service, q);
     job->setUrls(urls);
     job->setRunFlags(m_deleteTemporaryFile ? KIO::ApplicationLauncherJob::DeleteTemporaryFiles : KIO::ApplicationLauncherJob::RunFlags{});
@@ -312,6 +343,16 @@ void KIO::OpenUrlJobPrivate::runLink(const QString &filePath, const QString &url
     q->start();
 }
 
+void KIO::OpenUrlJobPrivate::startPhase()
+{
+    m_phaseTimer.start();
+}
+
+void KIO::OpenUrlJobPrivate::endPhase(const char *phase)
+{
+    qCDebug(KIO_OPENURLJOB_TIMING) << phase << "for" << m_url << "took" << m_phaseTimer.nsecsElapsed() / 1000 << "us";
+}
+
 void KIO::OpenUrlJobPrivate::emitAccessDenied()
 {
     q->setError(KIO::ERR_ACCESS_DENIED);
@@ -348,6 +389,26 @@ static bool hasExecuteBit(const QString &fileName)
     return QFileInfo(fileName).isExecutable();
 }
 
+// Runs in a thread, don't touch the job from here
+static LocalFileChecks checkLocalFile(const QString &filePath, bool parseDesktopFile)
+{
+    LocalFileChecks checks;
+    checks.hasExecuteBit = hasExecuteBit(filePath);
+    if (parseDesktopFile) {
+        auto cfg = std::make_shared<KDesktopFile>(filePath);
+        checks.hasTypeEntry = cfg->desktopGroup().hasKey("Type");
+        if (cfg->hasLinkType()) {
+            checks.isLink = true;
+            checks.linkUrl = cfg->readUrl();
+            checks.lastOpenedWith = cfg->desktopGroup().readEntry("X-KDE-LastOpenedWith");
+        } else if (cfg->hasApplicationType() || cfg->readType() == QLatin1String("Service")) { // kio_settings lets users run Type=Service desktop files
+            // Keep the parsed file, the job creates the KService from it without reading it again
+            checks.serviceDesktopFile = cfg;
+        }
+    }
+    return checks;
+}
+
 // Handle native binaries (.e.g. /usr/bin/*); and .exe files
 void KIO::OpenUrlJobPrivate::handleBinaries(const QMimeType &mimeType)
 {
@@ -409,7 +470,7 @@ void KIO::OpenUrlJobPrivate::handleBinariesHelper(const QString &localPath, bool
     }
 
     // Native binaries
-    if (!hasExecuteBit(localPath)) {
+    if (!m_localFileChecks.hasExecuteBit) {
         // Show untrustedProgram dialog for local, native executables without the execute bit
         showUntrustedProgramWarningDialog(localPath);
         return;
@@ -451,6 +512,7 @@ void KIO::OpenUrlJobPrivate::showUntrustedProgramWarningDialog(const QString &fi
 
 void KIO::OpenUrlJobPrivate::executeCommand()
 {
+    startPhase();
     // Execute the URL as a command. This is how we start scripts and executables
     KIO::CommandLauncherJob *job = new KIO::CommandLauncherJob(m_url.toLocalFile(), QStringList());
     job->setStartupId(m_startupId);
@@ -465,6 +527,8 @@ void KIO::OpenUrlJobPrivate::executeCommand()
 
 void KIO::OpenUrlJobPrivate::runUrlWithMimeType()
 {
+    endPhase("mimetype");
+
     // Tell the app, in case it wants us to stop here
     Q_EMIT q->mimeTypeFound(m_mimeTypeName);
     if (q->error() == KJob::KilledJobError) {
@@ -482,6 +546,26 @@ void KIO::OpenUrlJobPrivate::runUrlWithMimeType()
     QMimeDatabase db;
     const QMimeType mimeType = db.mimeTypeForName(m_mimeTypeName);
 
+    // Local executables and .desktop files need a look at the file first,
+    // don't block the application while doing that
+    const bool isDesktopFile = mimeType.inherits(QStringLiteral("application/x-desktop"));
+    if (m_url.isLocalFile() && (isDesktopFile || isTextScript(mimeType) || isBinary(mimeType))) {
+        const bool parseDesktopFile =
+            isDesktopFile && m_url.fileName() != QLatin1String(".directory") && m_mimeTypeName != QLatin1String("application/x-theme");
+        startPhase();
+        QtConcurrent::run(checkLocalFile, m_url.toLocalFile(), parseDesktopFile).then(q, [this, mimeType](const LocalFileChecks &checks) {
+            endPhase("filesystem checks");
+            m_localFileChecks = checks;
+            runUrlWithMimeTypeHelper(mimeType);
+        });
+        return;
+    }
+
+    runUrlWithMimeTypeHelper(mimeType);
+}
+
+void KIO::OpenUrlJobPrivate::runUrlWithMimeTypeHelper(const QMimeType &mimeType)
+{
     // .desktop files
     if (mimeType.inherits(QStringLiteral("application/x-desktop"))) {
         handleDesktopFiles();
@@ -520,9 +604,7 @@ void KIO::OpenUrlJobPrivate::handleDesktopFiles()
     }
 
     const QString filePath = m_url.toLocalFile();
-    KDesktopFile cfg(filePath);
-    KConfigGroup cfgGroup = cfg.desktopGroup();
-    if (!cfgGroup.hasKey("Type")) {
+    if (!m_localFileChecks.hasTypeEntry) {
         q->setError(KJob::UserDefinedError);
         q->setErrorText(i18n("The desktop entry file %1 has no Type=... entry.", filePath));
         q->emitResult();
@@ -530,13 +612,13 @@ void KIO::OpenUrlJobPrivate::handleDesktopFiles()
         return;
     }
 
-    if (cfg.hasLinkType()) {
-        runLink(filePath, cfg.readUrl(), cfg.desktopGroup().readEntry("X-KDE-LastOpenedWith"));
+    if (m_localFileChecks.isLink) {
+        runLink(filePath, m_localFileChecks.linkUrl, m_localFileChecks.lastOpenedWith);
         return;
     }
 
-    if ((cfg.hasApplicationType() || cfg.readType() == QLatin1String("Service"))) { // kio_settings lets users run Type=Service desktop files
-        KService::Ptr service(new KService(filePath));
+    if (m_localFileChecks.serviceDesktopFile) {
+        const KService::Ptr service(new KService(m_localFileChecks.serviceDesktopFile.get(), filePath));
         if (!service->exec().isEmpty()) {
             if (m_showOpenOrExecuteDialog) { // Show the openOrExecute dialog
                 auto dialogFinished = [this, filePath, service](bool shouldExecute) {
@@ -572,8 +654,7 @@ void KIO::OpenUrlJobPrivate::handleScripts()
     }
 
     const bool isLocal = m_url.isLocalFile();
-    const QString localPath = m_url.toLocalFile();
-    if (!isLocal || !hasExecuteBit(localPath)) {
+    if (!isLocal || !m_localFileChecks.hasExecuteBit) {
         // Open remote scripts or ones without the execute bit, with the default application
         openInPreferredApp();
         return;
@@ -601,7 +682,9 @@ void KIO::OpenUrlJobPrivate::handleScripts()
 
 void KIO::OpenUrlJobPrivate::openInPreferredApp()
 {
+    startPhase();
     KService::Ptr service = KApplicationTrader::preferredService(m_mimeTypeName);
+    endPhase("service lookup");
     if (service) {
         startService(service);
     } else {
@@ -692,6 +775,7 @@ void KIO::OpenUrlJobPrivate::showOpenOrExecuteFileDialog(std::function<void(bool
 void KIO::OpenUrlJob::slotResult(KJob *job)
 {
     // This is only used for the final application/launcher job, so we're done when it's done
+    d->endPhase("process spawn");
     const int errCode = job->error();
     if (errCode) {
         setError(errCode);
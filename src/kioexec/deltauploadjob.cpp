@@ -0,0 +1,262 @@
+/*
+    This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "deltauploadjob.h"
+
+#include <KIO/CopyJob>
+#include <KIO/FileJob>
+#include <KIO/SimpleJob>
+#include <KIO/StatJob>
+#include <KProtocolManager>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFileInfo>
+
+FileChecksums FileChecksums::compute(const QString &path)
+{
+    FileChecksums checksums;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return checksums;
+    }
+    // Before reading, a change while reading makes it newer than the checksums
+    checksums.m_modificationTime = QFileInfo(file).lastModified();
+
+    QByteArray block(blockSize, Qt::Uninitialized);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (;;) {
+        const qint64 n = file.read(block.data(), blockSize);
+        if (n < 0) {
+            return FileChecksums();
+        }
+        if (n == 0) {
+            break;
+        }
+        hash.reset();
+        hash.addData(QByteArrayView(block.constData(), n));
+        checksums.m_blocks.append(hash.result());
+        checksums.m_size += n;
+    }
+    checksums.m_valid = true;
+    return checksums;
+}
+
+QByteArray FileChecksums::toByteArray() const
+{
+    QByteArray data;
+    if (m_valid) {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream << m_size << m_modificationTime << m_blocks;
+    }
+    return data;
+}
+
+FileChecksums FileChecksums::fromByteArray(const QByteArray &data)
+{
+    FileChecksums checksums;
+    if (data.isEmpty()) {
+        return checksums;
+    }
+    QDataStream stream(data);
+    stream >> checksums.m_size >> checksums.m_modificationTime >> checksums.m_blocks;
+    checksums.m_valid = stream.status() == QDataStream::Ok;
+    return checksums;
+}
+
+DeltaUploadJob::DeltaUploadJob(const QString &path, const QUrl &dest, const FileChecksums &remote, const FileChecksums &local, QObject *parent)
+    : KJob(parent)
+    , m_path(path)
+    , m_dest(dest)
+    , m_remote(remote)
+    , m_local(local)
+    , m_file(path)
+{
+}
+
+DeltaUploadJob::~DeltaUploadJob()
+{
+    if (m_fileJob) {
+        m_fileJob->kill();
+    }
+}
+
+void DeltaUploadJob::start()
+{
+    if (!m_remote.isValid() || !m_local.isValid() || !KProtocolManager::supportsOpening(m_dest)) {
+        copyWholeFile();
+        return;
+    }
+    if (m_local.size() < m_remote.size() && !KProtocolManager::supportsTruncating(m_dest)) {
+        copyWholeFile();
+        return;
+    }
+
+    // Adjacent changed blocks are written as one range
+    qint64 changed = 0;
+    for (qsizetype i = 0; i < m_local.blockCount(); ++i) {
+        if (i < m_remote.blockCount() && m_local.m_blocks.at(i) == m_remote.m_blocks.at(i)) {
+            continue;
+        }
+        const qint64 offset = i * FileChecksums::blockSize;
+        const qint64 length = qMin(FileChecksums::blockSize, m_local.size() - offset);
+        if (!m_ranges.isEmpty() && m_ranges.last().offset + m_ranges.last().length == offset) {
+            m_ranges.last().length += length;
+        } else {
+            m_ranges.append(Range{offset, length});
+        }
+        changed += length;
+    }
+
+    // Rewriting most of the file in place saves little, and isn't atomic like a copy can be
+    if (changed > m_local.size() / 2) {
+        copyWholeFile();
+        return;
+    }
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        copyWholeFile();
+        return;
+    }
+
+    KIO::StatJob *job = KIO::stat(m_dest, KIO::StatJob::DestinationSide, KIO::StatBasic | KIO::StatTime, KIO::HideProgressInfo);
+    connect(job, &KJob::result, this, &DeltaUploadJob::slotStatResult);
+}
+
+void DeltaUploadJob::slotStatResult(KJob *job)
+{
+    // Someone else changed the remote file since the download, its blocks can't be trusted.
+    // Without a modification time, there's no telling.
+    const KIO::UDSEntry entry = static_cast<KIO::StatJob *>(job)->statResult();
+    const qint64 mtime = entry.numberValue(KIO::UDSEntry::UDS_MODIFICATION_TIME, -1);
+    if (job->error() || entry.numberValue(KIO::UDSEntry::UDS_SIZE, -1) != m_remote.size() || mtime == -1
+        || mtime != m_remote.modificationTime().toSecsSinceEpoch()) {
+        m_file.close();
+        copyWholeFile();
+        return;
+    }
+
+    m_fileJob = KIO::open(m_dest, QIODevice::ReadWrite);
+    connect(m_fileJob, &KIO::FileJob::open, this, &DeltaUploadJob::slotOpen);
+    connect(m_fileJob, &KIO::FileJob::position, this, [this](KIO::Job *, KIO::filesize_t offset) {
+        slotPosition(offset);
+    });
+    connect(m_fileJob, &KIO::FileJob::written, this, [this](KIO::Job *, KIO::filesize_t written) {
+        slotWritten(written);
+    });
+    connect(m_fileJob, &KIO::FileJob::truncated, this, [this]() {
+        m_finished = true;
+        m_fileJob->close();
+    });
+    connect(m_fileJob, &KJob::result, this, &DeltaUploadJob::slotFileJobResult);
+}
+
+void DeltaUploadJob::slotOpen()
+{
+    // Changed since the stat
+    if (m_fileJob->size() != KIO::filesize_t(m_remote.size())) {
+        m_fileJob->close();
+        return;
+    }
+    writeNextRange();
+}
+
+void DeltaUploadJob::writeNextRange()
+{
+    if (m_rangeIndex < m_ranges.size()) {
+        m_rangeWritten = 0;
+        m_fileJob->seek(m_ranges.at(m_rangeIndex).offset);
+        return;
+    }
+
+    if (m_local.size() < m_remote.size()) {
+        m_fileJob->truncate(m_local.size());
+        return;
+    }
+    m_finished = true;
+    m_fileJob->close();
+}
+
+void DeltaUploadJob::slotPosition(KIO::filesize_t offset)
+{
+    const Range &range = m_ranges.at(m_rangeIndex);
+    if (offset != KIO::filesize_t(range.offset) || !m_file.seek(range.offset)) {
+        m_fileJob->close();
+        return;
+    }
+    writeChunk();
+}
+
+void DeltaUploadJob::writeChunk()
+{
+    const Range &range = m_ranges.at(m_rangeIndex);
+    const QByteArray chunk = m_file.read(qMin(FileChecksums::blockSize, range.length - m_rangeWritten));
+    if (chunk.isEmpty()) {
+        // The local file changed since its checksums were computed
+        m_fileJob->close();
+        return;
+    }
+    m_chunkSize = chunk.size();
+    m_fileJob->write(chunk);
+}
+
+void DeltaUploadJob::slotWritten(KIO::filesize_t written)
+{
+    if (written != KIO::filesize_t(m_chunkSize)) {
+        m_fileJob->close();
+        return;
+    }
+    m_rangeWritten += m_chunkSize;
+    if (m_rangeWritten < m_ranges.at(m_rangeIndex).length) {
+        writeChunk();
+        return;
+    }
+    ++m_rangeIndex;
+    writeNextRange();
+}
+
+void DeltaUploadJob::slotFileJobResult(KJob *job)
+{
+    m_file.close();
+    if (job->error() == KIO::ERR_USER_CANCELED) {
+        setError(job->error());
+        setErrorText(job->errorString());
+        emitResult();
+        return;
+    }
+    if (job->error() || !m_finished) {
+        // Whatever got written already is overwritten by the copy
+        copyWholeFile();
+        return;
+    }
+    setModificationTime();
+}
+
+void DeltaUploadJob::copyWholeFile()
+{
+    // Like writing the changed blocks, the user asked for the remote file to be replaced
+    KIO::CopyJob *job = KIO::copy(QUrl::fromLocalFile(m_path), m_dest, KIO::Overwrite);
+    connect(job, &KJob::result, this, [this](KJob *job) {
+        if (job->error()) {
+            setError(job->error());
+            setErrorText(job->errorString());
+        }
+        emitResult();
+    });
+}
+
+void DeltaUploadJob::setModificationTime()
+{
+    // Like a copy does, so that the next upload can tell whether someone else changed the file.
+    // Not being able to only makes the next upload a full copy.
+    KIO::SimpleJob *job = KIO::setModificationTime(m_dest, m_local.modificationTime());
+    connect(job, &KJob::result, this, [this]() {
+        emitResult();
+    });
+}
+
+#include "moc_deltauploadjob.cpp"
@@ -0,0 +1,135 @@
+/*
+    This file is part of the KDE project
+    SPDX-FileCopyrightText: 2026 KDE e.V. <kde-ev-board@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef DELTAUPLOADJOB_H
+#define DELTAUPLOADJOB_H
+
+#include <KIO/Global>
+#include <KJob>
+
+#include <QDateTime>
+#include <QFile>
+#include <QList>
+#include <QPointer>
+#include <QUrl>
+
+namespace KIO
+{
+class FileJob;
+class Job;
+}
+
+/**
+ * Checksums of the blocks of a file, to find out whether and where it was modified.
+ */
+class FileChecksums
+{
+public:
+    static constexpr qint64 blockSize = 1024 * 1024;
+
+    /**
+     * Reads @p path and computes the checksums of its blocks.
+     * Returns invalid checksums if the file can't be read.
+     * The modification time of @p path is kept as well, right after a download
+     * it's the one of the remote file.
+     */
+    static FileChecksums compute(const QString &path);
+
+    /**
+     * For passing the checksums to kioexecd.
+     */
+    QByteArray toByteArray() const;
+    static FileChecksums fromByteArray(const QByteArray &data);
+
+    bool isValid() const
+    {
+        return m_valid;
+    }
+
+    qint64 size() const
+    {
+        return m_size;
+    }
+
+    QDateTime modificationTime() const
+    {
+        return m_modificationTime;
+    }
+
+    /**
+     * The number of blocks, the last one may be shorter than blockSize.
+     */
+    qsizetype blockCount() const
+    {
+        return m_blocks.size();
+    }
+
+    /**
+     * Whether the content is the same, the modification times don't matter.
+     */
+    bool operator==(const FileChecksums &other) const
+    {
+        return m_valid && other.m_valid && m_size == other.m_size && m_blocks == other.m_blocks;
+    }
+
+private:
+    friend class DeltaUploadJob;
+
+    bool m_valid = false;
+    qint64 m_size = 0;
+    QDateTime m_modificationTime;
+    QList<QByteArray> m_blocks;
+};
+
+/**
+ * Uploads the changes of a local copy of a remote file.
+ *
+ * If the worker can open files for writing, and the remote file still has the
+ * size and modification time it had when it was downloaded, only the blocks
+ * that differ between @p remote and @p local are written, and the modification
+ * time of @p path is set on it. Otherwise, or if that fails, the whole file is
+ * copied over the remote one like KIO::copy() does.
+ */
+class DeltaUploadJob : public KJob
+{
+    Q_OBJECT
+public:
+    DeltaUploadJob(const QString &path, const QUrl &dest, const FileChecksums &remote, const FileChecksums &local, QObject *parent = nullptr);
+    ~DeltaUploadJob() override;
+
+    void start() override;
+
+private:
+    struct Range {
+        qint64 offset;
+        qint64 length;
+    };
+
+    void slotStatResult(KJob *job);
+    void slotOpen();
+    void slotPosition(KIO::filesize_t offset);
+    void slotWritten(KIO::filesize_t written);
+    void slotFileJobResult(KJob *job);
+    void writeNextRange();
+    void writeChunk();
+    void copyWholeFile();
+    void setModificationTime();
+
+    const QString m_path;
+    const QUrl m_dest;
+    const FileChecksums m_remote;
+    const FileChecksums m_local;
+    QList<Range> m_ranges;
+    qsizetype m_rangeIndex = 0;
+    qint64 m_rangeWritten = 0;
+    qint64 m_chunkSize = 0;
+    bool m_finished = false;
+    QFile m_file;
+    QPointer<KIO::FileJob> m_fileJob;
+};
+
+#endif
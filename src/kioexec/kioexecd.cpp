@@ -10,7 +10,6 @@
 #include "kioexecdebug.h"
 
 #include <KDirWatch>
-#include <KIO/CopyJob>
 #include <KLocalizedString>
 #include <KMessageBox>
 #include <KPluginFactory>
@@ -18,6 +17,9 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QStandardPaths>
+#include <QThread>
+
+#include <memory>
 
 static const int predefinedTimeout = 30000; // 30s
 
@@ -51,7 +53,7 @@ KIOExecd::~KIOExecd()
     }
 }
 
-void KIOExecd::watch(const QString &path, const QString &destUrl)
+void KIOExecd::watch(const QString &path, const QString &destUrl, const QByteArray &checksums)
 {
     if (m_watched.contains(path)) {
         qCDebug(KIOEXEC) << "Already watching" << path;
@@ -63,6 +65,7 @@ void KIOExecd::watch(const QString &path, const QString &destUrl)
     // Watch the temporary file for modifications, creations or deletions
     m_watcher->addFile(path);
     m_watched.insert(path, QUrl(destUrl));
+    m_checksums.insert(path, FileChecksums::fromByteArray(checksums));
 }
 
 void KIOExecd::slotCreated(const QString &path)
@@ -79,6 +82,31 @@ void KIOExecd::slotDirty(const QString &path)
         return;
     }
 
+    // Hashing big files takes a while, don't block the other kiod modules meanwhile
+    auto checksums = std::make_shared<FileChecksums>();
+    QThread *thread = QThread::create([path, checksums]() {
+        *checksums = FileChecksums::compute(path);
+    });
+    connect(thread, &QThread::finished, this, [this, thread, path, checksums]() {
+        thread->deleteLater();
+        slotChecksumsComputed(path, *checksums);
+    });
+    thread->start();
+}
+
+void KIOExecd::slotChecksumsComputed(const QString &path, const FileChecksums &checksums)
+{
+    if (!m_watched.contains(path)) {
+        return;
+    }
+
+    // Saved without changes, or changed back
+    const FileChecksums remote = m_checksums.value(path);
+    if (checksums.isValid() && checksums == remote) {
+        qCDebug(KIOEXEC) << "Content of" << path << "didn't change";
+        return;
+    }
+
     const auto dest = m_watched.value(path);
 
     const auto result = KMessageBox::questionTwoActions(nullptr,
@@ -91,12 +119,15 @@ void KIOExecd::slotDirty(const QString &path)
     }
 
     qCDebug(KIOEXEC) << "Uploading" << path << "to" << dest;
-    auto job = KIO::copy(QUrl::fromLocalFile(path), dest);
-    connect(job, &KJob::result, this, [](KJob *job) {
+    auto job = new DeltaUploadJob(path, dest, remote, checksums, this);
+    connect(job, &KJob::result, this, [this, path, checksums](KJob *job) {
         if (job->error()) {
             KMessageBox::error(nullptr, job->errorString());
+        } else if (m_watched.contains(path)) {
+            m_checksums.insert(path, checksums);
         }
     });
+    job->start();
 }
 
 void KIOExecd::slotDeleted(const QString &path)
@@ -118,6 +149,7 @@ void KIOExecd::slotCheckDeletedFiles()
             qCDebug(KIOEXEC) << "Going to forget" << it.key();
             m_watcher->removeFile(it.key());
             m_watched.remove(it.key());
+            m_checksums.remove(it.key());
             QFileInfo info(it.key());
             const auto parentDir = info.path();
             qCDebug(KIOEXEC) << "About to delete" << parentDir;
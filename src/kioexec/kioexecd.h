@@ -10,6 +10,8 @@
 
 #include <KDEDModule>
 
+#include "deltauploadjob.h"
+
 #include <QMap>
 #include <QTimer>
 #include <QUrl>
@@ -26,7 +28,7 @@ public:
     ~KIOExecd() override;
 
 public Q_SLOTS:
-    void watch(const QString &path, const QString &destUrl);
+    void watch(const QString &path, const QString &destUrl, const QByteArray &checksums);
 
 private Q_SLOTS:
     void slotDirty(const QString &path);
@@ -35,9 +37,13 @@ private Q_SLOTS:
     void slotCheckDeletedFiles();
 
 private:
+    void slotChecksumsComputed(const QString &path, const FileChecksums &checksums);
+
     KDirWatch *m_watcher;
     // temporary file and associated remote file
     QMap<QString, QUrl> m_watched;
+    // temporary file and the checksums of the remote file's content
+    QMap<QString, FileChecksums> m_checksums;
     // temporary file and the last date it was removed
     QMap<QString, QDateTime> m_deleted;
     QTimer m_timer;
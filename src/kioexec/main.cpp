@@ -24,6 +24,7 @@
 #include <copyjob.h>
 #include <desktopexecparser.h>
 #include <job.h>
+#include <statjob.h>
 
 #include <QCommandLineOption>
 #include <QCommandLineParser>
@@ -33,6 +34,8 @@
 
 #include <config-kioexec.h>
 
+#include <memory>
+
 #if HAVE_X11
 #include <KStartupInfo>
 #include <private/qtx11extras_p.h>
@@ -144,18 +147,62 @@ void KIOExec::slotResult(KJob *job)
                 qDebug() << path << " not found in list";
             }
         } else {
-            // Tell kioexecd to watch the file for changes.
+            // The download doesn't keep the modification time of the remote file, it's what tells
+            // an upload whether someone else changed the remote file meanwhile
             const QString dest = copyJob->srcUrl().toString();
-            qDebug() << "Telling kioexecd to watch path" << path << "dest" << dest;
-            OrgKdeKIOExecdInterface kioexecd(QStringLiteral("org.kde.kioexecd6"), QStringLiteral("/modules/kioexecd"), QDBusConnection::sessionBus());
-            kioexecd.watch(path, dest);
-            mUseDaemon = !kioexecd.lastError().isValid();
-            if (!mUseDaemon) {
-                qDebug() << "Not using kioexecd";
-            }
+            KIO::StatJob *statJob = KIO::stat(copyJob->srcUrl(), KIO::StatJob::SourceSide, KIO::StatTime, KIO::HideProgressInfo);
+            connect(statJob, &KJob::result, this, [this, path, dest](KJob *job) {
+                const qint64 mtime = static_cast<KIO::StatJob *>(job)->statResult().numberValue(KIO::UDSEntry::UDS_MODIFICATION_TIME, -1);
+                QFile file(path);
+                if (!job->error() && mtime != -1 && file.open(QIODevice::ReadWrite)) {
+                    file.setFileTime(QDateTime::fromSecsSinceEpoch(mtime), QFileDevice::FileModificationTime);
+                }
+                computeChecksums(path, dest);
+            });
+            return;
         }
     }
 
+    fileDone();
+}
+
+void KIOExec::computeChecksums(const QString &path, const QString &dest)
+{
+    // Before the application can modify it. Hashing big files takes a while, don't block the UI meanwhile.
+    auto checksums = std::make_shared<FileChecksums>();
+    QThread *thread = QThread::create([path, checksums]() {
+        *checksums = FileChecksums::compute(path);
+    });
+    connect(thread, &QThread::finished, this, [this, thread, path, dest, checksums]() {
+        thread->deleteLater();
+        slotChecksumsComputed(path, dest, *checksums);
+    });
+    thread->start();
+}
+
+void KIOExec::slotChecksumsComputed(const QString &path, const QString &dest, const FileChecksums &checksums)
+{
+    auto it = std::find_if(fileList.begin(), fileList.end(), [&path](const FileInfo &i) {
+        return i.path == path;
+    });
+    if (it != fileList.end()) {
+        it->checksums = checksums;
+    }
+
+    // Tell kioexecd to watch the file for changes.
+    qDebug() << "Telling kioexecd to watch path" << path << "dest" << dest;
+    OrgKdeKIOExecdInterface kioexecd(QStringLiteral("org.kde.kioexecd6"), QStringLiteral("/modules/kioexecd"), QDBusConnection::sessionBus());
+    kioexecd.watch(path, dest, checksums.toByteArray());
+    mUseDaemon = !kioexecd.lastError().isValid();
+    if (!mUseDaemon) {
+        qDebug() << "Not using kioexecd";
+    }
+
+    fileDone();
+}
+
+void KIOExec::fileDone()
+{
     counter++;
 
     if (counter < expectedCounter) {
@@ -239,19 +286,25 @@ void KIOExec::slotRunApp()
                     continue; // don't delete the temp file
                 }
             } else if (uploadChanges) { // no upload when it's already a local file or kioexecd already did it.
-                const auto result =
-                    KMessageBox::questionTwoActions(nullptr,
-                                                    i18n("The file\n%1\nhas been modified.\nDo you want to upload the changes?", dest.toDisplayString()),
-                                                    i18n("File Changed"),
-                                                    KGuiItem(i18n("Upload")),
-                                                    KGuiItem(i18n("Do Not Upload")));
-                if (result == KMessageBox::PrimaryAction) {
-                    qDebug() << "src='" << src << "'  dest='" << dest << "'";
-                    // Do it the synchronous way.
-                    KIO::CopyJob *job = KIO::copy(QUrl::fromLocalFile(src), dest);
-                    if (!job->exec()) {
-                        KMessageBox::error(nullptr, job->errorText());
-                        continue; // don't delete the temp file
+                // Saved without changes, or changed back
+                const FileChecksums checksums = FileChecksums::compute(src);
+                if (checksums.isValid() && checksums == it->checksums) {
+                    qDebug() << "Content of" << src << "didn't change";
+                } else {
+                    const auto result =
+                        KMessageBox::questionTwoActions(nullptr,
+                                                        i18n("The file\n%1\nhas been modified.\nDo you want to upload the changes?", dest.toDisplayString()),
+                                                        i18n("File Changed"),
+                                                        KGuiItem(i18n("Upload")),
+                                                        KGuiItem(i18n("Do Not Upload")));
+                    if (result == KMessageBox::PrimaryAction) {
+                        qDebug() << "src='" << src << "'  dest='" << dest << "'";
+                        // Do it the synchronous way.
+                        DeltaUploadJob *job = new DeltaUploadJob(src, dest, it->checksums, checksums);
+                        if (!job->exec()) {
+                            KMessageBox::error(nullptr, job->errorText());
+                            continue; // don't delete the temp file
+                        }
                     }
                 }
             }
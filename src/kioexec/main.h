@@ -17,6 +17,8 @@
 #include <QDateTime>
 #include <QUrl>
 
+#include "deltauploadjob.h"
+
 namespace KIO
 {
 class Job;
@@ -40,6 +42,11 @@ public Q_SLOTS:
     void slotResult(KJob *);
     void slotRunApp();
 
+private:
+    void computeChecksums(const QString &path, const QString &dest);
+    void slotChecksumsComputed(const QString &path, const QString &dest, const FileChecksums &checksums);
+    void fileDone();
+
 protected:
     bool mExited;
     bool mTempFiles;
@@ -52,6 +59,8 @@ protected:
         QString path;
         QUrl url;
         QDateTime time;
+        // of the downloaded content, to tell what changed
+        FileChecksums checksums;
     };
     QList<FileInfo> fileList;
     int jobCounter;
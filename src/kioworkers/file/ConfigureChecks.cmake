@@ -17,6 +17,40 @@ check_function_exists(copy_file_range HAVE_COPY_FILE_RANGE)
 
 check_function_exists(posix_fadvise    HAVE_FADVISE)                  # KIO worker
 
+check_cxx_source_compiles("
+    #include <sys/uio.h>
+
+    int main() {
+        struct iovec iov;
+        return preadv2(0, &iov, 1, 0, RWF_NOWAIT);
+    }
+" HAVE_PREADV2)
+
+check_cxx_source_compiles("
+    #include <fcntl.h>
+
+    int main() {
+        return fallocate(0, FALLOC_FL_KEEP_SIZE, 0, 0);
+    }
+" HAVE_FALLOCATE)
+
+check_cxx_source_compiles("
+    #include <fcntl.h>
+
+    int main() {
+        return sync_file_range(0, 0, 0, SYNC_FILE_RANGE_WRITE);
+    }
+" HAVE_SYNC_FILE_RANGE)
+
+check_cxx_source_compiles("
+    #include <fcntl.h>
+    #include <stdio.h>
+
+    int main() {
+        return renameat2(AT_FDCWD, \"/foo\", AT_FDCWD, \"/bar\", RENAME_NOREPLACE);
+    }
+" HAVE_RENAMEAT2)
+
 check_struct_has_member("struct dirent" d_type dirent.h HAVE_DIRENT_D_TYPE LANGUAGE CXX)
 
 check_symbol_exists("__GLIBC__" "stdlib.h" LIBC_IS_GLIBC)
@@ -16,11 +16,22 @@
 #include <QStorageInfo>
 
 #include "../../utils_p.h"
+#include "commands_p.h"
 #include "kioglobal_p.h"
 #include "statjob.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <cerrno>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+#if HAVE_FALLOCATE || HAVE_SYNC_FILE_RANGE || HAVE_FADVISE
+#include <fcntl.h>
+#endif
 #ifdef Q_OS_WIN
 #include <qt_windows.h>
 #include <sys/utime.h>
@@ -30,9 +41,13 @@
 #endif
 
 #include <QCoreApplication>
+#include <QCryptographicHash>
 #include <QDate>
+#include <QMutex>
 #include <QTemporaryFile>
+#include <QThread>
 #include <QVarLengthArray>
+#include <QWaitCondition>
 #ifdef Q_OS_WIN
 #include <QDir>
 #include <QFileInfo>
@@ -332,14 +347,28 @@ WorkerResult FileProtocol::get(const QUrl &url)
         }
     }
 
+    // Only send up to "range-end" (inclusive) if given, e.g. to sniff the MIME type
+    KIO::filesize_t endOffset = 0;
+    bool rangeLimited = false;
+    const QString rangeEnd = metaData(QStringLiteral("range-end"));
+    if (!rangeEnd.isEmpty()) {
+        bool ok;
+        const KIO::filesize_t lastByte = rangeEnd.toULongLong(&ok);
+        if (ok && lastByte + 1 < static_cast<KIO::filesize_t>(buff.st_size)) {
+            endOffset = lastByte + 1;
+            rangeLimited = true;
+        }
+    }
+
     char buffer[s_maxIPCSize];
     QByteArray array;
 
-    while (1) {
+    while (!rangeLimited || processed_size < endOffset) {
         if (wasKilled()) {
             return WorkerResult::pass();
         }
-        int n = f.read(buffer, s_maxIPCSize);
+        const KIO::filesize_t toRead = rangeLimited ? std::min<KIO::filesize_t>(s_maxIPCSize, endOffset - processed_size) : s_maxIPCSize;
+        int n = f.read(buffer, toRead);
         if (n == -1) {
             if (errno == EINTR) {
                 continue;
@@ -365,7 +394,7 @@ WorkerResult FileProtocol::get(const QUrl &url)
 
     f.close();
 
-    processedSize(buff.st_size);
+    processedSize(rangeLimited ? processed_size : buff.st_size);
     return WorkerResult::pass();
 }
 
@@ -397,7 +426,9 @@ WorkerResult FileProtocol::open(const QUrl &url, QIODevice::OpenMode mode)
     }
 
     mFile = new QFile(openPath);
-    if (!mFile->open(mode)) {
+    mFilePos = 0;
+    // No QFile buffering, all I/O is positional on the descriptor
+    if (!mFile->open(mode | QIODevice::Unbuffered)) {
         if (mode & QIODevice::ReadOnly) {
             return WorkerResult::fail(KIO::ERR_CANNOT_OPEN_FOR_READING, openPath);
         } else {
@@ -427,14 +458,15 @@ WorkerResult FileProtocol::read(KIO::filesize_t bytes)
 
     QVarLengthArray<char> buffer(bytes);
 
-    qint64 bytesRead = mFile->read(buffer.data(), bytes);
+    qint64 bytesRead = readAt(buffer.data(), bytes, mFilePos);
 
     if (bytesRead == -1) {
         const auto fileName = mFile->fileName();
-        qCWarning(KIO_FILE) << "Couldn't read. Error:" << mFile->errorString();
+        qCWarning(KIO_FILE) << "Couldn't read. Error:" << strerror(errno);
         closeWithoutFinish();
         return WorkerResult::fail(KIO::ERR_CANNOT_READ, fileName);
     } else {
+        mFilePos += bytesRead;
         const QByteArray fileData = QByteArray::fromRawData(buffer.data(), bytesRead);
         data(fileData);
         return WorkerResult::pass();
@@ -446,21 +478,25 @@ WorkerResult FileProtocol::write(const QByteArray &data)
     // qDebug() << "File::open -- write";
     Q_ASSERT(mFile && mFile->isWritable());
 
-    qint64 bytesWritten = mFile->write(data);
+    if (mFile->openMode() & QIODevice::Append) {
+        mFilePos = mFile->size();
+    }
+
+    qint64 bytesWritten = writeAt(data.constData(), data.size(), mFilePos);
 
     if (bytesWritten == -1) {
-        if (mFile->error() == QFileDevice::ResourceError) { // disk full
+        if (errno == ENOSPC) { // disk full
             const auto fileName = mFile->fileName();
             closeWithoutFinish();
             return WorkerResult::fail(KIO::ERR_DISK_FULL, fileName);
         } else {
             const auto fileName = mFile->fileName();
-            qCWarning(KIO_FILE) << "Couldn't write. Error:" << mFile->errorString();
+            qCWarning(KIO_FILE) << "Couldn't write. Error:" << strerror(errno);
             closeWithoutFinish();
             return WorkerResult::fail(KIO::ERR_CANNOT_WRITE, fileName);
         }
     } else {
-        mFile->flush();
+        mFilePos += bytesWritten;
         written(bytesWritten);
 
         return WorkerResult::pass();
@@ -472,14 +508,46 @@ KIO::WorkerResult FileProtocol::seek(KIO::filesize_t offset)
     // qDebug() << "File::open -- seek";
     Q_ASSERT(mFile && mFile->isOpen());
 
-    if (mFile->seek(offset)) {
-        position(offset);
-        return WorkerResult::pass();
-    } else {
+    if (offset > KIO::filesize_t(std::numeric_limits<qint64>::max())) {
         const auto fileName = mFile->fileName();
         closeWithoutFinish();
         return WorkerResult::fail(KIO::ERR_CANNOT_SEEK, fileName);
     }
+
+    // Reads and writes are positional, so seeking needs no syscall
+    mFilePos = offset;
+    position(offset);
+    return WorkerResult::pass();
+}
+
+KIO::WorkerResult FileProtocol::readv(const KIO::FileRangeList &ranges)
+{
+    Q_ASSERT(mFile && mFile->isOpen());
+
+    // The buffers are allocated up front from the requested lengths, FileJob never asks for more
+    bool tooBig = ranges.size() > KIO::maxReadvRanges;
+    KIO::filesize_t total = 0;
+    for (auto it = ranges.cbegin(); !tooBig && it != ranges.cend(); ++it) {
+        total += it->second;
+        tooBig = it->second > KIO::maxReadvSize || total > KIO::maxReadvSize;
+    }
+    if (tooBig) {
+        const auto fileName = mFile->fileName();
+        qCWarning(KIO_FILE) << "Rejecting readv of" << ranges.size() << "ranges and" << total << "bytes";
+        closeWithoutFinish();
+        return WorkerResult::fail(KIO::ERR_CANNOT_READ, fileName);
+    }
+
+    QList<QByteArray> chunks;
+    if (!readRangesAt(ranges, chunks)) {
+        const auto fileName = mFile->fileName();
+        qCWarning(KIO_FILE) << "Couldn't read. Error:" << strerror(errno);
+        closeWithoutFinish();
+        return WorkerResult::fail(KIO::ERR_CANNOT_READ, fileName);
+    }
+
+    dataVector(chunks);
+    return WorkerResult::pass();
 }
 
 KIO::WorkerResult FileProtocol::truncate(KIO::filesize_t length)
@@ -517,6 +585,195 @@ KIO::WorkerResult FileProtocol::close()
     return WorkerResult::pass();
 }
 
+// Reserve the blocks for the whole file up front, which means fewer extents and
+// metadata updates than growing it chunk by chunk. The file size isn't changed,
+// so an interrupted transfer doesn't leave a file that looks complete.
+static bool preallocate(QFile &f, KIO::filesize_t size)
+{
+#if HAVE_FALLOCATE
+    const KIO::filesize_t currentSize = f.size();
+    if (size <= currentSize) {
+        return false;
+    }
+    if (fallocate(f.handle(), FALLOC_FL_KEEP_SIZE, currentSize, size - currentSize) == -1) {
+        // EOPNOTSUPP on filesystems that can't do it, nothing to worry about
+        qCDebug(KIO_FILE) << "Couldn't preallocate" << f.fileName() << strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(f)
+    Q_UNUSED(size)
+    return false;
+#endif
+}
+
+// Give back what preallocate() reserved beyond the data actually written. Truncating
+// to the current size isn't guaranteed to do that on every filesystem, punching a hole
+// into the reserved range is.
+static void releasePreallocation(QFile &f, KIO::filesize_t reservedSize)
+{
+#if HAVE_FALLOCATE
+    f.flush();
+    const KIO::filesize_t size = f.size();
+    if (size >= reservedSize) {
+        return;
+    }
+    if (fallocate(f.handle(), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, size, reservedSize - size) == -1) {
+        qCDebug(KIO_FILE) << "Couldn't release preallocated space of" << f.fileName() << strerror(errno);
+        f.resize(size);
+    }
+#else
+    Q_UNUSED(f)
+    Q_UNUSED(reservedSize)
+#endif
+}
+
+/*
+ * Writes the chunks received by put() on a separate thread, so that receiving the
+ * next chunk overlaps with writing the previous one. Only the writer thread touches
+ * the file until finish() returned.
+ */
+class WriteBehind
+{
+public:
+    WriteBehind(QFile &file, bool throttleDirtyPages)
+        : m_file(file)
+        , m_offset(file.pos())
+        , m_syncedOffset(m_offset)
+        , m_throttleDirtyPages(throttleDirtyPages)
+    {
+        m_thread.reset(QThread::create([this]() {
+            run();
+        }));
+        m_thread->start();
+    }
+
+    ~WriteBehind()
+    {
+        finish();
+    }
+
+    // Queues @p chunk, blocking while the queue is full. Returns false once a write failed.
+    bool write(const QByteArray &chunk)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_queue.size() >= s_maxQueuedChunks && m_error == QFileDevice::NoError) {
+            m_condition.wait(&m_mutex);
+        }
+        if (m_error != QFileDevice::NoError) {
+            return false;
+        }
+        m_queue.push_back(chunk);
+        m_condition.wakeAll();
+        return true;
+    }
+
+    // Waits until everything queued is written. Returns false if a write failed.
+    bool finish()
+    {
+        if (m_thread) {
+            {
+                QMutexLocker locker(&m_mutex);
+                m_finishing = true;
+                m_condition.wakeAll();
+            }
+            m_thread->wait();
+            m_thread.reset();
+        }
+        return m_error == QFileDevice::NoError;
+    }
+
+    QFileDevice::FileError error() const
+    {
+        return m_error;
+    }
+
+    QString errorString() const
+    {
+        return m_errorString;
+    }
+
+private:
+    void run()
+    {
+        for (;;) {
+            QByteArray chunk;
+            {
+                QMutexLocker locker(&m_mutex);
+                while (m_queue.empty() && !m_finishing) {
+                    m_condition.wait(&m_mutex);
+                }
+                if (m_queue.empty()) {
+                    return;
+                }
+                chunk = m_queue.front();
+                m_queue.pop_front();
+                m_condition.wakeAll();
+            }
+
+            if (m_file.write(chunk) == -1) {
+                QMutexLocker locker(&m_mutex);
+                m_error = m_file.error();
+                m_errorString = m_file.errorString();
+                m_queue.clear();
+                m_condition.wakeAll();
+                return;
+            }
+            m_offset += chunk.size();
+            if (m_throttleDirtyPages) {
+                throttleDirtyPages();
+            }
+        }
+    }
+
+    // Keep huge copies from filling the page cache with dirty pages: start the
+    // writeback of each window as soon as it's complete, wait for the previous
+    // one and drop it from the cache, since we won't read it again.
+    void throttleDirtyPages()
+    {
+#if HAVE_SYNC_FILE_RANGE
+        if (m_offset - m_syncedOffset < s_syncWindow) {
+            return;
+        }
+        m_file.flush();
+        const int fd = m_file.handle();
+        sync_file_range(fd, m_syncedOffset, m_offset - m_syncedOffset, SYNC_FILE_RANGE_WRITE);
+        if (m_previousSyncedOffset != m_syncedOffset) {
+            const off_t length = m_syncedOffset - m_previousSyncedOffset;
+            sync_file_range(fd, m_previousSyncedOffset, length, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+#if HAVE_FADVISE
+            posix_fadvise(fd, m_previousSyncedOffset, length, POSIX_FADV_DONTNEED);
+#endif
+        }
+        m_previousSyncedOffset = m_syncedOffset;
+        m_syncedOffset = m_offset;
+#endif
+    }
+
+    static constexpr size_t s_maxQueuedChunks = 4;
+    static constexpr qint64 s_syncWindow = 8 * 1024 * 1024;
+
+    QFile &m_file;
+    std::unique_ptr<QThread> m_thread;
+
+    // Only used by the writer thread
+    qint64 m_offset;
+    qint64 m_syncedOffset;
+    qint64 m_previousSyncedOffset = m_syncedOffset;
+    const bool m_throttleDirtyPages;
+
+    QMutex m_mutex; // protects the members below
+    QWaitCondition m_condition;
+    std::deque<QByteArray> m_queue;
+    bool m_finishing = false;
+    QFileDevice::FileError m_error = QFileDevice::NoError;
+    QString m_errorString;
+};
+
+// Small files are written directly, starting a thread isn't worth it for them
+static const KIO::filesize_t s_writeBehindThreshold = 1024 * 1024;
+
 KIO::WorkerResult FileProtocol::put(const QUrl &url, int _mode, KIO::JobFlags _flags)
 {
     if (privilegeOperationUnitTestMode()) {
@@ -583,6 +840,11 @@ KIO::WorkerResult FileProtocol::put(const QUrl &url, int _mode, KIO::JobFlags _f
     int error = 0;
     QString dest;
     QFile f;
+    bool preallocated = false;
+    KIO::filesize_t bytesWritten = 0;
+    std::unique_ptr<WriteBehind> writeBehind;
+    // Set by file_copy when the source size is known
+    const KIO::filesize_t expectedSize = metaData(QStringLiteral("size")).toULongLong();
 
     // Loop until we got 0 (end of data)
     do {
@@ -658,15 +920,27 @@ KIO::WorkerResult FileProtocol::put(const QUrl &url, int _mode, KIO::JobFlags _f
 #endif
                     }
                 }
+
+                if (expectedSize > 0) {
+                    preallocated = preallocate(f, expectedSize);
+                }
             }
 
-            if (f.write(buffer) == -1) {
-                if (f.error() == QFile::ResourceError) { // disk full
+            if (!writeBehind && bytesWritten >= s_writeBehindThreshold) {
+                writeBehind = std::make_unique<WriteBehind>(f, configValue(QStringLiteral("ThrottleDirtyPages"), false));
+            }
+            const bool written = writeBehind ? writeBehind->write(buffer) : f.write(buffer) != -1;
+            if (written) {
+                bytesWritten += buffer.size();
+            } else {
+                const QFileDevice::FileError fileError = writeBehind ? writeBehind->error() : f.error();
+                if (fileError == QFile::ResourceError) { // disk full
                     error = KIO::ERR_DISK_FULL;
                     result = -2; // means: remove dest file
                 } else {
-                    qCWarning(KIO_FILE) << "Couldn't write. Error:" << f.errorString();
+                    qCWarning(KIO_FILE) << "Couldn't write. Error:" << (writeBehind ? writeBehind->errorString() : f.errorString());
                     error = KIO::ERR_CANNOT_WRITE;
+                    result = -1;
                 }
             }
         } else {
@@ -675,11 +949,28 @@ KIO::WorkerResult FileProtocol::put(const QUrl &url, int _mode, KIO::JobFlags _f
         }
     } while (result > 0);
 
+    if (writeBehind) {
+        if (!writeBehind->finish() && result >= 0) {
+            if (writeBehind->error() == QFile::ResourceError) {
+                error = KIO::ERR_DISK_FULL;
+                result = -2;
+            } else {
+                qCWarning(KIO_FILE) << "Couldn't write. Error:" << writeBehind->errorString();
+                error = KIO::ERR_CANNOT_WRITE;
+                result = -1;
+            }
+        }
+        writeBehind.reset();
+    }
+
     // An error occurred deal with it.
     if (result < 0) {
         // qDebug() << "Error during 'put'. Aborting.";
 
         if (f.isOpen()) {
+            if (preallocated) {
+                releasePreallocation(f, expectedSize);
+            }
             f.close();
 
             QT_STATBUF buff;
@@ -697,6 +988,9 @@ KIO::WorkerResult FileProtocol::put(const QUrl &url, int _mode, KIO::JobFlags _f
         return WorkerResult::pass();
     }
 
+    if (preallocated) {
+        releasePreallocation(f, expectedSize);
+    }
     f.close();
 
     if (f.error() != QFile::NoError) {
@@ -1016,6 +1310,101 @@ WorkerResult FileProtocol::fileSystemFreeSpace(const QUrl &url)
     }
 }
 
+static std::optional<QCryptographicHash::Algorithm> checksumAlgorithm(const QString &name)
+{
+    if (name == QLatin1String("md5")) {
+        return QCryptographicHash::Md5;
+    } else if (name == QLatin1String("sha1")) {
+        return QCryptographicHash::Sha1;
+    } else if (name == QLatin1String("sha224")) {
+        return QCryptographicHash::Sha224;
+    } else if (name == QLatin1String("sha256")) {
+        return QCryptographicHash::Sha256;
+    } else if (name == QLatin1String("sha384")) {
+        return QCryptographicHash::Sha384;
+    } else if (name == QLatin1String("sha512")) {
+        return QCryptographicHash::Sha512;
+    }
+    return std::nullopt;
+}
+
+WorkerResult FileProtocol::checksum(const QUrl &url, const QStringList &algorithms)
+{
+    if (!url.isLocalFile()) {
+        return WorkerResult::fail(KIO::ERR_UNSUPPORTED_PROTOCOL, url.url());
+    }
+
+    std::vector<std::pair<QString, std::unique_ptr<QCryptographicHash>>> hashes;
+    for (const QString &name : algorithms) {
+        const auto algorithm = checksumAlgorithm(name);
+        const bool duplicate = std::any_of(hashes.cbegin(), hashes.cend(), [&name](const auto &hash) {
+            return hash.first == name;
+        });
+        if (algorithm && !duplicate) {
+            hashes.emplace_back(name, std::make_unique<QCryptographicHash>(*algorithm));
+        }
+    }
+    if (hashes.empty()) {
+        return WorkerResult::fail(KIO::ERR_UNSUPPORTED_ACTION, algorithms.join(QLatin1String(", ")));
+    }
+
+    const QString path = url.toLocalFile();
+    QT_STATBUF buff;
+    if (QT_STAT(QFile::encodeName(path).constData(), &buff) == -1) {
+        if (errno == EACCES) {
+            return WorkerResult::fail(KIO::ERR_ACCESS_DENIED, path);
+        } else {
+            return WorkerResult::fail(KIO::ERR_DOES_NOT_EXIST, path);
+        }
+    }
+    if (Utils::isDirMask(buff.st_mode)) {
+        return WorkerResult::fail(KIO::ERR_IS_DIRECTORY, path);
+    }
+    if (!Utils::isRegFileMask(buff.st_mode)) {
+        return WorkerResult::fail(KIO::ERR_CANNOT_OPEN_FOR_READING, path);
+    }
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        return WorkerResult::fail(KIO::ERR_CANNOT_OPEN_FOR_READING, path);
+    }
+
+#if HAVE_FADVISE
+    posix_fadvise(f.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    totalSize(buff.st_size);
+
+    // Read each block once and feed it to all the digests
+    QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+    KIO::filesize_t processed = 0;
+    while (true) {
+        if (wasKilled()) {
+            return WorkerResult::pass();
+        }
+        const qint64 n = f.read(buffer.data(), buffer.size());
+        if (n < 0) {
+            return WorkerResult::fail(KIO::ERR_CANNOT_READ, path);
+        }
+        if (n == 0) {
+            break;
+        }
+
+        const QByteArrayView block(buffer.constData(), n);
+        for (const auto &hash : hashes) {
+            hash.second->addData(block);
+        }
+
+        processed += n;
+        processedSize(processed);
+    }
+
+    for (const auto &hash : hashes) {
+        setMetaData(QLatin1String("checksum-") + hash.first, QString::fromLatin1(hash.second->result().toHex()));
+    }
+    return WorkerResult::pass();
+}
+
 // needed for JSON file embedding
 #include "file.moc"
 
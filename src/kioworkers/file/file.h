@@ -16,6 +16,7 @@
 #include <QFile>
 #include <QHash>
 #include <QObject>
+#include <QSet>
 
 #include <config-kioworker-file.h>
 #include <qplatformdefs.h> // mode_t
@@ -43,6 +44,7 @@ public:
     virtual KIO::WorkerResult put(const QUrl &url, int _mode, KIO::JobFlags _flags) override;
     virtual KIO::WorkerResult copy(const QUrl &src, const QUrl &dest, int mode, KIO::JobFlags flags) override;
     virtual KIO::WorkerResult rename(const QUrl &src, const QUrl &dest, KIO::JobFlags flags) override;
+    KIO::WorkerResult renameBatch(const QList<QUrl> &src, const QList<QUrl> &dest) override;
     virtual KIO::WorkerResult symlink(const QString &target, const QUrl &dest, KIO::JobFlags flags) override;
 
     KIO::WorkerResult stat(const QUrl &url) override;
@@ -50,17 +52,20 @@ public:
     KIO::WorkerResult mkdir(const QUrl &url, int permissions) override;
     KIO::WorkerResult chmod(const QUrl &url, int permissions) override;
     KIO::WorkerResult chown(const QUrl &url, const QString &owner, const QString &group) override;
+    KIO::WorkerResult chmodRecursive(const QUrl &url, int permissions, int mask) override;
     KIO::WorkerResult setModificationTime(const QUrl &url, const QDateTime &mtime) override;
     KIO::WorkerResult del(const QUrl &url, bool isfile) override;
     KIO::WorkerResult open(const QUrl &url, QIODevice::OpenMode mode) override;
     KIO::WorkerResult read(KIO::filesize_t size) override;
     KIO::WorkerResult write(const QByteArray &data) override;
     KIO::WorkerResult seek(KIO::filesize_t offset) override;
+    KIO::WorkerResult readv(const KIO::FileRangeList &ranges) override;
     KIO::WorkerResult truncate(KIO::filesize_t length) override;
     bool copyXattrs(const int src_fd, const int dest_fd);
     KIO::WorkerResult close() override;
 
     KIO::WorkerResult fileSystemFreeSpace(const QUrl &url) override;
+    KIO::WorkerResult checksum(const QUrl &url, const QStringList &algorithms) override;
 
     /**
      * Special commands supported by this worker:
@@ -95,8 +100,19 @@ private:
     // Close without calling finish(). Use this to close after error.
     void closeWithoutFinish();
 
+    // Positional I/O on mFile, implemented per platform. These don't use
+    // the descriptor's own offset, read() and write() go through mFilePos.
+    qint64 readAt(char *buffer, qint64 size, KIO::filesize_t offset);
+    qint64 writeAt(const char *data, qint64 size, KIO::filesize_t offset);
+    bool readRangesAt(const KIO::FileRangeList &ranges, QList<QByteArray> &chunks);
+
 private:
     QFile *mFile;
+    KIO::filesize_t mFilePos = 0;
+#if HAVE_PREADV2
+    // Filesystems (by st_dev) that don't support RWF_NOWAIT reads
+    QSet<dev_t> mNowaitUnsupportedDevices;
+#endif
 
     bool resultWasCancelled(KIO::WorkerResult result);
 
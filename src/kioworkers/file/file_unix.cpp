@@ -22,8 +22,12 @@
 #include <QDir>
 #include <QFile>
 #include <QMimeDatabase>
+#include <QMutex>
+#include <QSet>
 #include <QStandardPaths>
 #include <QThread>
+#include <QVarLengthArray>
+#include <QWaitCondition>
 #include <qplatformdefs.h>
 
 #include <KConfigGroup>
@@ -32,10 +36,18 @@
 #include <QDebug>
 #include <kmountpoint.h>
 
+#include <algorithm>
 #include <array>
 #include <cerrno>
+#include <deque>
+#include <dirent.h>
+#include <fcntl.h>
+#include <functional>
+#include <memory>
 #include <stdint.h>
+#include <unistd.h>
 #include <utime.h>
+#include <vector>
 
 #include <KAuth/Action>
 #include <KAuth/ExecuteJob>
@@ -51,6 +63,10 @@
 
 #endif // Q_OS_LINUX
 
+#if HAVE_PREADV2
+#include <sys/uio.h>
+#endif
+
 #if HAVE_STATX
 #include <sys/stat.h>
 #include <sys/sysmacros.h> // for makedev()
@@ -77,6 +93,9 @@ using namespace KIO;
 /* 512 kB */
 static constexpr int s_maxIPCSize = 1024 * 512;
 
+// How many items renameBatch() renames between two progress reports
+static constexpr int s_renameBatchProgressInterval = 500;
+
 static bool same_inode(const QT_STATBUF &src, const QT_STATBUF &dest)
 {
     if (src.st_ino == dest.st_ino && src.st_dev == dest.st_dev) {
@@ -527,6 +546,110 @@ WorkerResult FileProtocol::tryChangeFileAttr(ActionType action, const QVariantLi
     return WorkerResult::fail(errcode);
 }
 
+qint64 FileProtocol::readAt(char *buffer, qint64 size, KIO::filesize_t offset)
+{
+    const int fd = mFile->handle();
+    qint64 total = 0;
+    while (total < size) {
+        const ssize_t n = ::pread(fd, buffer + total, size - total, offset + total);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            break; // EOF
+        }
+        total += n;
+    }
+    return total;
+}
+
+qint64 FileProtocol::writeAt(const char *data, qint64 size, KIO::filesize_t offset)
+{
+    const int fd = mFile->handle();
+    qint64 total = 0;
+    while (total < size) {
+        const ssize_t n = ::pwrite(fd, data + total, size - total, offset + total);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        total += n;
+    }
+    return total;
+}
+
+bool FileProtocol::readRangesAt(const KIO::FileRangeList &ranges, QList<QByteArray> &chunks)
+{
+    QT_STATBUF buff;
+    if (QT_FSTAT(mFile->handle(), &buff) == -1) {
+        return false;
+    }
+    const KIO::filesize_t fileSize = buff.st_size;
+
+    chunks.clear();
+    chunks.reserve(ranges.size());
+    QVarLengthArray<qint64, 16> done(ranges.size());
+    std::fill(done.begin(), done.end(), 0);
+    for (const auto &[offset, length] : ranges) {
+        const qint64 size = offset < fileSize ? qMin(length, fileSize - offset) : 0;
+        chunks.append(QByteArray(size, Qt::Uninitialized));
+    }
+
+#if HAVE_PREADV2
+    // First take whatever is already in the page cache without blocking...
+    // Whether it's supported depends on the filesystem the file is on
+    bool nowaitSupported = !mNowaitUnsupportedDevices.contains(buff.st_dev);
+    bool allCached = true;
+    for (qsizetype i = 0; i < ranges.size(); ++i) {
+        QByteArray &chunk = chunks[i];
+        if (chunk.isEmpty() || !nowaitSupported) {
+            allCached = allCached && chunk.isEmpty();
+            continue;
+        }
+        struct iovec iov = {chunk.data(), size_t(chunk.size())};
+        const ssize_t n = ::preadv2(mFile->handle(), &iov, 1, ranges.at(i).first, RWF_NOWAIT);
+        if (n > 0) {
+            done[i] = n;
+        } else if (n == -1 && errno != EAGAIN) {
+            // e.g. EOPNOTSUPP on filesystems without RWF_NOWAIT support
+            nowaitSupported = false;
+            mNowaitUnsupportedDevices.insert(buff.st_dev);
+        }
+        allCached = allCached && done[i] == chunk.size();
+    }
+    if (allCached) {
+        return true;
+    }
+#endif
+
+#if HAVE_FADVISE
+    // ...then have the kernel fetch all of the rest concurrently before blocking on it
+    for (qsizetype i = 0; i < ranges.size(); ++i) {
+        if (done[i] < chunks.at(i).size()) {
+            posix_fadvise(mFile->handle(), ranges.at(i).first + done[i], chunks.at(i).size() - done[i], POSIX_FADV_WILLNEED);
+        }
+    }
+#endif
+
+    for (qsizetype i = 0; i < ranges.size(); ++i) {
+        QByteArray &chunk = chunks[i];
+        if (done[i] == chunk.size()) {
+            continue;
+        }
+        const qint64 n = readAt(chunk.data() + done[i], chunk.size() - done[i], ranges.at(i).first + done[i]);
+        if (n == -1) {
+            return false;
+        }
+        chunk.truncate(done[i] + n);
+    }
+    return true;
+}
+
 #if HAVE_SYS_XATTR_H || HAVE_SYS_EXTATTR_H
 bool FileProtocol::copyXattrs(const int src_fd, const int dest_fd)
 {
@@ -1206,6 +1329,216 @@ WorkerResult FileProtocol::rename(const QUrl &srcUrl, const QUrl &destUrl, KIO::
     return WorkerResult::pass();
 }
 
+// Like ::rename(), but fails with EEXIST instead of replacing an existing @p to
+static int renameNoReplace(const QByteArray &from, const QByteArray &to)
+{
+#if HAVE_RENAMEAT2
+    if (::renameat2(AT_FDCWD, from.constData(), AT_FDCWD, to.constData(), RENAME_NOREPLACE) == 0) {
+        return 0;
+    }
+    if (errno != EINVAL && errno != ENOSYS) { // otherwise the filesystem or the kernel doesn't support the flag
+        return -1;
+    }
+#endif
+    QT_STATBUF buff;
+    if (QT_LSTAT(to.constData(), &buff) == 0) {
+        errno = EEXIST;
+        return -1;
+    }
+    return ::rename(from.constData(), to.constData());
+}
+
+WorkerResult FileProtocol::renameBatch(const QList<QUrl> &srcUrls, const QList<QUrl> &destUrls)
+{
+    if (srcUrls.size() != destUrls.size()) {
+        return WorkerResult::fail(KIO::ERR_INTERNAL, i18n("Got %1 files to rename, but %2 new names", srcUrls.size(), destUrls.size()));
+    }
+
+    const qsizetype count = srcUrls.size();
+    QList<QByteArray> sources;
+    QList<QByteArray> destinations;
+    sources.reserve(count);
+    destinations.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        sources.append(QFile::encodeName(srcUrls.at(i).toLocalFile()));
+        destinations.append(QFile::encodeName(destUrls.at(i).toLocalFile()));
+    }
+    QList<QByteArray> current = sources; // where each item is right now
+    QHash<QByteArray, qsizetype> occupants; // current path -> item, for items that still have to move
+    occupants.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        occupants.insert(sources.at(i), i);
+    }
+
+    // Check everything first, nothing is renamed if an item would overwrite a file outside of the batch
+    QSet<QByteArray> newNames;
+    newNames.reserve(count);
+    std::vector<bool> caseOnly(count); // the new name only differs by case, on a case-insensitive filesystem
+    for (qsizetype i = 0; i < count; ++i) {
+        const QByteArray &dest = destinations.at(i);
+        if (newNames.contains(dest)) {
+            return WorkerResult::fail(KIO::ERR_FILE_ALREADY_EXIST, destUrls.at(i).toLocalFile());
+        }
+        newNames.insert(dest);
+
+        QT_STATBUF buff_src;
+        if (QT_LSTAT(sources.at(i).constData(), &buff_src) == -1) {
+            return WorkerResult::fail(errno == EACCES ? KIO::ERR_ACCESS_DENIED : KIO::ERR_DOES_NOT_EXIST, srcUrls.at(i).toLocalFile());
+        }
+        if (dest == sources.at(i) || occupants.contains(dest)) {
+            continue;
+        }
+        QT_STATBUF buff_dest;
+        if (QT_LSTAT(dest.constData(), &buff_dest) == 0) {
+            if (same_inode(buff_dest, buff_src)) {
+                caseOnly[i] = true;
+                continue;
+            }
+            return WorkerResult::fail(S_ISDIR(buff_dest.st_mode) ? KIO::ERR_DIR_ALREADY_EXIST : KIO::ERR_FILE_ALREADY_EXIST, destUrls.at(i).toLocalFile());
+        }
+    }
+
+    struct Rename {
+        qsizetype item;
+        QByteArray from;
+        QByteArray to;
+        bool caseOnly;
+    };
+    std::vector<Rename> done;
+
+    auto doRename = [&](qsizetype item, const QByteArray &to, bool parking) -> int {
+        const QByteArray from = current.at(item);
+        if (caseOnly[item] && !parking) {
+            // QFile::rename() goes through a temporary name, ::rename() would do nothing here
+            if (!QFile::rename(QFile::decodeName(from), QFile::decodeName(to))) {
+                return EIO;
+            }
+        } else if (renameNoReplace(from, to) == -1) {
+            return errno;
+        }
+        occupants.remove(from);
+        if (parking) {
+            occupants.insert(to, item);
+        }
+        current[item] = to;
+        done.push_back(Rename{item, from, to, caseOnly[item] && !parking});
+        return 0;
+    };
+
+    // Moves @p item out of the way, next to where it is
+    auto park = [&](qsizetype item) -> int {
+        const QByteArray &path = current.at(item);
+        const QByteArray dir = path.left(path.lastIndexOf('/') + 1);
+        int result = EEXIST;
+        for (int attempt = 0; attempt < 10 && result == EEXIST; ++attempt) {
+            result = doRename(item, dir + ".kio-rename-" + KRandom::randomString(8).toLatin1(), true);
+        }
+        return result;
+    };
+
+    enum State {
+        Pending,
+        InProgress,
+        Renamed,
+    };
+    std::vector<State> states(count, Pending);
+    qsizetype renamed = 0;
+    int error = 0;
+    qsizetype failedItem = -1;
+    for (qsizetype i = 0; i < count && !error; ++i) {
+        if (states[i] == Renamed) {
+            continue;
+        }
+        // An item whose new name is still taken by another one of the batch goes after it
+        std::vector<qsizetype> chain{i};
+        states[i] = InProgress;
+        while (!chain.empty()) {
+            const qsizetype item = chain.back();
+            if (current.at(item) != destinations.at(item)) {
+                const qsizetype occupant = occupants.value(destinations.at(item), -1);
+                if (occupant != -1 && states[occupant] == Pending) {
+                    states[occupant] = InProgress;
+                    chain.push_back(occupant);
+                    continue;
+                }
+                if (occupant != -1) {
+                    // A cycle: park the occupant under a temporary name, it gets its turn once we're back to it
+                    error = park(occupant);
+                    if (error) {
+                        failedItem = occupant;
+                        break;
+                    }
+                }
+                error = doRename(item, destinations.at(item), false);
+                if (error) {
+                    failedItem = item;
+                    break;
+                }
+            }
+            states[item] = Renamed;
+            chain.pop_back();
+            if (++renamed % s_renameBatchProgressInterval == 0) {
+                processedSize(renamed);
+            }
+        }
+    }
+
+    if (!error) {
+        processedSize(renamed);
+        return WorkerResult::pass();
+    }
+
+    // Put everything back, last rename first
+    while (!done.empty()) {
+        const Rename &last = done.back();
+        if (last.caseOnly ? !QFile::rename(QFile::decodeName(last.to), QFile::decodeName(last.from)) : renameNoReplace(last.to, last.from) == -1) {
+            break;
+        }
+        current[last.item] = last.from;
+        done.pop_back();
+    }
+    const QString src = srcUrls.at(failedItem).toLocalFile();
+    const QString dest = destUrls.at(failedItem).toLocalFile();
+    if (!done.empty()) {
+        qCWarning(KIO_FILE) << "Could not undo" << done.size() << "renames after renaming" << sources.at(failedItem) << "failed";
+        QStringList stillRenamed;
+        QStringList parked; // still under a temporary name from a cycle, the user has to find them
+        for (qsizetype i = 0; i < count; ++i) {
+            if (current.at(i) == sources.at(i)) {
+                continue;
+            }
+            if (current.at(i) == destinations.at(i)) {
+                stillRenamed.append(QString::number(i));
+            } else {
+                parked.append(i18nc("@item a file left under a temporary name", "%1 (was %2)", QFile::decodeName(current.at(i)), srcUrls.at(i).toLocalFile()));
+            }
+        }
+        setMetaData(QStringLiteral("renamed"), stillRenamed.join(QLatin1Char(',')));
+        if (!parked.isEmpty()) {
+            qCWarning(KIO_FILE) << "Left under a temporary name:" << parked;
+            return WorkerResult::fail(KIO::ERR_WORKER_DEFINED,
+                                      i18n("Could not rename %1, and the files renamed before it could not all be renamed back. "
+                                           "These files are left under a temporary name:\n%2",
+                                           src,
+                                           parked.join(QLatin1Char('\n'))));
+        }
+    }
+
+    switch (error) {
+    case EACCES:
+    case EPERM:
+        return WorkerResult::fail(KIO::ERR_WRITE_ACCESS_DENIED, dest);
+    case EEXIST:
+        return WorkerResult::fail(KIO::ERR_FILE_ALREADY_EXIST, dest);
+    case EXDEV:
+        return WorkerResult::fail(KIO::ERR_UNSUPPORTED_ACTION, QStringLiteral("rename"));
+    case EROFS: // The file is on a read-only filesystem
+        return WorkerResult::fail(KIO::ERR_CANNOT_DELETE, src);
+    default:
+        return WorkerResult::fail(KIO::ERR_CANNOT_RENAME, src);
+    }
+}
+
 WorkerResult FileProtocol::symlink(const QString &target, const QUrl &destUrl, KIO::JobFlags flags)
 {
     // Assume dest is local too (wouldn't be here otherwise)
@@ -1383,6 +1716,326 @@ WorkerResult FileProtocol::chown(const QUrl &url, const QString &owner, const QS
     return WorkerResult::pass();
 }
 
+/*
+ * Changes permissions of everything below a directory for chmodRecursive().
+ * A few threads read directories in parallel and change each entry with fchmodat()
+ * relative to the fd of its directory. A directory that gets read or search access
+ * for its owner is changed before it's read, any other directory only once everything
+ * below it is done, so that taking permissions away never locks the walk out.
+ * Entries that can't be accessed are skipped, the rest of the tree is still changed
+ * and the first of them is reported at the end.
+ */
+class ChmodTreeWalker
+{
+public:
+    ChmodTreeWalker(int permissions, int mask)
+        : m_permissions(permissions)
+        , m_mask(mask)
+    {
+    }
+
+    ~ChmodTreeWalker()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_failed = true;
+            m_condition.wakeAll();
+        }
+        for (const auto &thread : m_threads) {
+            thread->wait();
+        }
+    }
+
+    // Walks the tree below @p path, the directory itself currently has @p currentMode and gets @p mode
+    void start(const QByteArray &path, mode_t currentMode, mode_t mode)
+    {
+        bool changed = false;
+        if (addsOwnerAccess(currentMode, mode)) {
+            changed = ::chmod(path.constData(), mode) == 0;
+            if (!changed) {
+                skipOrFail(errno, path);
+            }
+        }
+        m_directories.push_back(Directory{path, nullptr, mode, 1, changed});
+        m_queue.push_back(&m_directories.back());
+        m_unfinished = 1;
+
+        const int threadCount = std::clamp(QThread::idealThreadCount(), 1, s_maxThreads);
+        for (int i = 0; i < threadCount; ++i) {
+            m_threads.emplace_back(QThread::create([this]() {
+                run();
+            }));
+            m_threads.back()->start();
+        }
+    }
+
+    // Blocks until the walk is done, calling @p progress with the number of changed entries meanwhile
+    bool wait(const std::function<void(quint64)> &progress)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_unfinished > 0 && !m_failed) {
+            m_doneCondition.wait(&m_mutex, s_progressInterval);
+            const quint64 processed = m_processed;
+            locker.unlock();
+            progress(processed);
+            locker.relock();
+        }
+        progress(m_processed);
+        return !m_failed && m_error == 0;
+    }
+
+    int error() const
+    {
+        return m_error;
+    }
+
+    QString errorPath() const
+    {
+        return QFile::decodeName(m_errorPath);
+    }
+
+private:
+    struct Directory {
+        QByteArray path;
+        Directory *parent;
+        mode_t mode; // applied once everything below is done, unless it's already changed
+        int pending; // its own listing, plus one per subdirectory that isn't done yet
+        bool changed; // the mode was applied before reading it
+    };
+
+    // Without read and search access the directory can't be walked, so such a change comes first
+    static bool addsOwnerAccess(mode_t currentMode, mode_t mode)
+    {
+        return (mode & ~currentMode & (S_IRUSR | S_IXUSR)) != 0;
+    }
+
+    // Same as ChmodJob: "x" bits are only given to files that had one already (chmod +X)
+    mode_t newMode(mode_t currentMode, bool isDir) const
+    {
+        const int permissions = currentMode & 0777; // get rid of "set gid" and other special flags
+        int mask = m_mask;
+        if (!isDir) {
+            const int newPerms = m_permissions & mask;
+            if ((newPerms & 0111) && !(permissions & 0111)) {
+                // don't interfere with mandatory file locking
+                if (newPerms & 02000) {
+                    mask = mask & ~0101;
+                } else {
+                    mask = mask & ~0111;
+                }
+            }
+        }
+        return (m_permissions & mask) | (permissions & ~mask);
+    }
+
+    void run()
+    {
+        for (;;) {
+            Directory *dir;
+            {
+                QMutexLocker locker(&m_mutex);
+                while (m_queue.empty() && m_unfinished > 0 && !m_failed) {
+                    m_condition.wait(&m_mutex);
+                }
+                if (m_queue.empty() || m_failed) {
+                    return;
+                }
+                dir = m_queue.front();
+                m_queue.pop_front();
+            }
+            processDirectory(dir);
+        }
+    }
+
+    void processDirectory(Directory *dir)
+    {
+        const int fd = QT_OPEN(dir->path.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        DIR *dp = fd != -1 ? fdopendir(fd) : nullptr;
+        if (!dp) {
+            const int error = errno;
+            if (fd != -1) {
+                ::close(fd);
+            }
+            // An unreadable directory still gets its own mode
+            if (skipOrFail(error, dir->path)) {
+                finishDirectory(dir);
+            }
+            return;
+        }
+
+        QT_DIRENT *ep;
+        while ((ep = QT_READDIR(dp)) != nullptr) {
+            if (qstrcmp(ep->d_name, ".") == 0 || qstrcmp(ep->d_name, "..") == 0) {
+                continue;
+            }
+            QT_STATBUF st;
+            if (fstatat(fd, ep->d_name, &st, AT_SYMLINK_NOFOLLOW) == -1) {
+                if (errno == ENOENT) { // deleted meanwhile
+                    continue;
+                }
+                if (!skipOrFail(errno, dir->path + '/' + ep->d_name)) {
+                    break;
+                }
+                continue;
+            }
+            if (S_ISLNK(st.st_mode)) { // don't do anything with symlinks
+                continue;
+            }
+            if (S_ISDIR(st.st_mode)) {
+                const mode_t mode = newMode(st.st_mode, true);
+                const bool changeFirst = addsOwnerAccess(st.st_mode, mode);
+                if (changeFirst && fchmodat(fd, ep->d_name, mode, 0) == -1) {
+                    // It couldn't be read either, skip it altogether
+                    if (!skipOrFail(errno, dir->path + '/' + ep->d_name)) {
+                        break;
+                    }
+                    continue;
+                }
+                QMutexLocker locker(&m_mutex);
+                if (m_failed) {
+                    break;
+                }
+                m_directories.push_back(Directory{dir->path + '/' + ep->d_name, dir, mode, 1, changeFirst});
+                m_queue.push_back(&m_directories.back());
+                ++dir->pending;
+                ++m_unfinished;
+                m_condition.wakeOne();
+                continue;
+            }
+
+            const mode_t mode = newMode(st.st_mode, false);
+            if (mode != (st.st_mode & 07777) && fchmodat(fd, ep->d_name, mode, 0) == -1) {
+                if (!skipOrFail(errno, dir->path + '/' + ep->d_name)) {
+                    break;
+                }
+                continue;
+            }
+            QMutexLocker locker(&m_mutex);
+            ++m_processed;
+            if (m_failed) {
+                break;
+            }
+        }
+        closedir(dp);
+
+        finishDirectory(dir);
+    }
+
+    // Drops the pending count of @p dir, changing it and then its parents once nothing is left below them
+    void finishDirectory(Directory *dir)
+    {
+        while (dir) {
+            {
+                QMutexLocker locker(&m_mutex);
+                if (--dir->pending > 0 || m_failed) {
+                    return;
+                }
+            }
+
+            // Not through an fd, the directory may not be readable
+            QT_STATBUF st;
+            if (!dir->changed
+                && (QT_LSTAT(dir->path.constData(), &st) == -1
+                    || (S_ISDIR(st.st_mode) && dir->mode != (st.st_mode & 07777) && ::chmod(dir->path.constData(), dir->mode) == -1))
+                && !skipOrFail(errno, dir->path)) {
+                return;
+            }
+
+            QMutexLocker locker(&m_mutex);
+            ++m_processed;
+            if (--m_unfinished == 0) {
+                m_condition.wakeAll();
+                m_doneCondition.wakeAll();
+            }
+            dir = dir->parent;
+        }
+    }
+
+    void fail(int error, const QByteArray &path)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_failed) {
+            m_failed = true;
+            m_error = error;
+            m_errorPath = path;
+        }
+        m_condition.wakeAll();
+        m_doneCondition.wakeAll();
+    }
+
+    // Access errors are remembered and the walk goes on, returns false if it has to stop
+    bool skipOrFail(int error, const QByteArray &path)
+    {
+        if (error != EACCES && error != EPERM) {
+            fail(error, path);
+            return false;
+        }
+        QMutexLocker locker(&m_mutex);
+        if (m_error == 0) {
+            m_error = error;
+            m_errorPath = path;
+        }
+        return true;
+    }
+
+    static constexpr int s_maxThreads = 4;
+    static constexpr int s_progressInterval = 200; // ms
+
+    const int m_permissions;
+    const int m_mask;
+    std::vector<std::unique_ptr<QThread>> m_threads;
+
+    // Guarded by m_mutex
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    QWaitCondition m_doneCondition;
+    std::deque<Directory> m_directories; // never shrinks, so pointers to its items stay valid
+    std::deque<Directory *> m_queue;
+    int m_unfinished = 0;
+    quint64 m_processed = 0;
+    bool m_failed = false;
+    int m_error = 0;
+    QByteArray m_errorPath;
+};
+
+WorkerResult FileProtocol::chmodRecursive(const QUrl &url, int permissions, int mask)
+{
+    const QString path = url.toLocalFile();
+    const QByteArray _path(QFile::encodeName(path));
+
+    QT_STATBUF buff;
+    if (QT_LSTAT(_path.constData(), &buff) == -1) {
+        return WorkerResult::fail(errno == ENOENT ? KIO::ERR_DOES_NOT_EXIST : KIO::ERR_CANNOT_STAT, path);
+    }
+    if (S_ISLNK(buff.st_mode)) { // don't do anything with symlinks
+        return WorkerResult::pass();
+    }
+
+    // The toplevel item gets the permissions as they are, no +X emulation here
+    const mode_t mode = (permissions & mask) | (buff.st_mode & 0777 & ~mask);
+    if (!S_ISDIR(buff.st_mode)) {
+        return chmod(url, mode);
+    }
+
+    ChmodTreeWalker walker(permissions, mask);
+    walker.start(_path, buff.st_mode & 07777, mode);
+    if (walker.wait([this](quint64 processed) {
+            processedSize(processed);
+        })) {
+        return WorkerResult::pass();
+    }
+
+    switch (walker.error()) {
+    case EPERM:
+    case EACCES:
+        return WorkerResult::fail(KIO::ERR_ACCESS_DENIED, walker.errorPath());
+    case ENOSPC:
+        return WorkerResult::fail(KIO::ERR_DISK_FULL, walker.errorPath());
+    default:
+        return WorkerResult::fail(KIO::ERR_CANNOT_CHMOD, walker.errorPath());
+    }
+}
+
 WorkerResult FileProtocol::stat(const QUrl &url)
 {
     if (!isLocalFileSameHost(url)) {
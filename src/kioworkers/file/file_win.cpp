@@ -13,6 +13,8 @@
 
 #include <qt_windows.h>
 
+#include <cerrno>
+
 #include <QDir>
 #include <QDirIterator>
 #include <QFileInfo>
@@ -307,6 +309,18 @@ WorkerResult FileProtocol::chown(const QUrl &url, const QString &, const QString
     return WorkerResult::fail(KIO::ERR_CANNOT_CHOWN, url.toLocalFile());
 }
 
+WorkerResult FileProtocol::chmodRecursive(const QUrl &url, int permissions, int mask)
+{
+    // ChmodJob falls back to listing and changing files one by one
+    return WorkerBase::chmodRecursive(url, permissions, mask);
+}
+
+WorkerResult FileProtocol::renameBatch(const QList<QUrl> &src, const QList<QUrl> &dest)
+{
+    // BatchRenameJob falls back to renaming files one by one
+    return WorkerBase::renameBatch(src, dest);
+}
+
 WorkerResult FileProtocol::stat(const QUrl &url)
 {
     if (!url.isLocalFile()) {
@@ -349,6 +363,44 @@ WorkerResult FileProtocol::tryChangeFileAttr(ActionType, const QVariantList &, i
     return WorkerResult::fail(err);
 }
 
+// No pread()/pwrite() here, so emulate them with QFile
+qint64 FileProtocol::readAt(char *buffer, qint64 size, KIO::filesize_t offset)
+{
+    if (!mFile->seek(offset)) {
+        return -1;
+    }
+    return mFile->read(buffer, size);
+}
+
+qint64 FileProtocol::writeAt(const char *data, qint64 size, KIO::filesize_t offset)
+{
+    if (!mFile->seek(offset)) {
+        return -1;
+    }
+    const qint64 n = mFile->write(data, size);
+    if (n == -1 && mFile->error() == QFileDevice::ResourceError) {
+        errno = ENOSPC;
+    }
+    return n;
+}
+
+bool FileProtocol::readRangesAt(const KIO::FileRangeList &ranges, QList<QByteArray> &chunks)
+{
+    const KIO::filesize_t fileSize = mFile->size();
+    chunks.clear();
+    chunks.reserve(ranges.size());
+    for (const auto &[offset, length] : ranges) {
+        QByteArray chunk(offset < fileSize ? qMin(length, fileSize - offset) : 0, Qt::Uninitialized);
+        const qint64 n = chunk.isEmpty() ? 0 : readAt(chunk.data(), chunk.size(), offset);
+        if (n == -1) {
+            return false;
+        }
+        chunk.truncate(n);
+        chunks.append(chunk);
+    }
+    return true;
+}
+
 int FileProtocol::setACL(const char *path, mode_t perm, bool directoryDefault)
 {
     Q_UNUSED(path);
@@ -26,6 +26,7 @@
 #include <utime.h>
 #endif
 
+#include <algorithm>
 #include <cctype>
 #include <cerrno>
 #include <cstdlib>
@@ -1211,6 +1212,68 @@ Result FtpInternal::chmod(const QUrl &url, int permissions)
     return Result::pass();
 }
 
+static QByteArray ftpHashAlgorithm(const QString &algorithm)
+{
+    if (algorithm == QLatin1String("md5")) {
+        return QByteArrayLiteral("MD5");
+    } else if (algorithm == QLatin1String("sha1")) {
+        return QByteArrayLiteral("SHA-1");
+    } else if (algorithm == QLatin1String("sha256")) {
+        return QByteArrayLiteral("SHA-256");
+    } else if (algorithm == QLatin1String("sha512")) {
+        return QByteArrayLiteral("SHA-512");
+    }
+    return QByteArray();
+}
+
+Result FtpInternal::checksum(const QUrl &url, const QStringList &algorithms)
+{
+    const auto result = ftpOpenConnection(LoginMode::Implicit);
+    if (!result.success()) {
+        return result;
+    }
+
+    if (m_extControl & hashUnknown) { // previous errors?
+        return Result::pass();
+    }
+
+    // The server hashes the whole file for each HASH command, so only ask
+    // for the first algorithm in order of preference that it supports
+    for (const QString &algorithm : algorithms) {
+        const QByteArray ftpAlgorithm = ftpHashAlgorithm(algorithm);
+        if (ftpAlgorithm.isEmpty()) {
+            continue;
+        }
+        if (!ftpSendCmd("OPTS HASH " + ftpAlgorithm)) {
+            return Result::fail(ERR_CANNOT_READ, url.path());
+        }
+        if (m_iRespCode == 500 || m_iRespCode == 502) {
+            m_extControl |= hashUnknown;
+            qCDebug(KIO_FTP) << "checksum: HASH not supported - disabling";
+            return Result::pass();
+        }
+        if (m_iRespType != 2) {
+            continue; // Algorithm not supported by the server
+        }
+
+        if (!ftpSendCmd("HASH " + q->remoteEncoding()->encode(url))) {
+            return Result::fail(ERR_CANNOT_READ, url.path());
+        }
+        if (m_iRespType != 2) {
+            return Result::pass();
+        }
+
+        // skip leading "213 ", then "SHA-256 0-49 <hash> <filename>"
+        const QList<QByteArray> fields = QByteArray(ftpResponse(4)).trimmed().split(' ');
+        if (fields.size() >= 3) {
+            q->setMetaData(QLatin1String("checksum-") + algorithm, QString::fromLatin1(fields.at(2)).toLower());
+        }
+        break;
+    }
+
+    return Result::pass();
+}
+
 void FtpInternal::ftpCreateUDSEntry(const QString &filename, const FtpEntry &ftpEnt, UDSEntry &entry, bool isDir)
 {
     Q_ASSERT(entry.count() == 0); // by contract :-)
@@ -1855,6 +1918,20 @@ Result FtpInternal::ftpGet(int iCopyFile, const QString &sCopyFile, const QUrl &
         q->totalSize(m_size); // emit the total size...
     }
 
+    // Stop after "range-end" (inclusive) if given, e.g. when only sniffing the MIME type.
+    // The server's answer to closing the data connection early is read and ignored by get().
+    bool rangeLimited = false;
+    const QString rangeEnd = q->metaData(QStringLiteral("range-end"));
+    if (iCopyFile == -1 && !rangeEnd.isEmpty()) {
+        bool ok;
+        const KIO::filesize_t endOffset = rangeEnd.toULongLong(&ok) + 1;
+        if (ok && endOffset > static_cast<KIO::filesize_t>(llOffset) && (m_size == UnknownSize || endOffset < m_size)) {
+            bytesLeft = endOffset - llOffset;
+            rangeLimited = true;
+        }
+    }
+    const bool sizeKnown = m_size != UnknownSize || rangeLimited;
+
     qCDebug(KIO_FTP) << "starting with offset=" << llOffset;
     KIO::fileoffset_t processed_size = llOffset;
 
@@ -1866,7 +1943,7 @@ Result FtpInternal::ftpGet(int iCopyFile, const QString &sCopyFile, const QUrl &
     int iBlockSize = initialIpcSize;
     int iBufferCur = 0;
 
-    while (m_size == UnknownSize || bytesLeft > 0) {
+    while (!sizeKnown || bytesLeft > 0) {
         // let the buffer size grow if the file is larger 64kByte ...
         if (processed_size - llOffset > 1024 * 64) {
             iBlockSize = maximumIpcSize;
@@ -1876,13 +1953,14 @@ Result FtpInternal::ftpGet(int iCopyFile, const QString &sCopyFile, const QUrl &
         if (iBlockSize + iBufferCur > (int)sizeof(buffer)) {
             iBlockSize = sizeof(buffer) - iBufferCur;
         }
+        const int toRead = rangeLimited ? static_cast<int>(std::min<KIO::filesize_t>(iBlockSize, bytesLeft)) : iBlockSize;
         if (m_data->bytesAvailable() == 0) {
             m_data->waitForReadyRead((q->readTimeout() * 1000));
         }
-        int n = m_data->read(buffer + iBufferCur, iBlockSize);
+        int n = m_data->read(buffer + iBufferCur, toRead);
         if (n <= 0) {
             // this is how we detect EOF in case of unknown size
-            if (m_size == UnknownSize && n == 0) {
+            if (!sizeKnown && n == 0) {
                 break;
             }
             // unexpected eof. Happens when the daemon gets killed.
@@ -1891,7 +1969,7 @@ Result FtpInternal::ftpGet(int iCopyFile, const QString &sCopyFile, const QUrl &
         processed_size += n;
 
         // collect very small data chunks in buffer before processing ...
-        if (m_size != UnknownSize) {
+        if (sizeKnown) {
             bytesLeft -= n;
             iBufferCur += n;
             if (iBufferCur < minimumMimeSize && bytesLeft > 0) {
@@ -1921,7 +1999,7 @@ Result FtpInternal::ftpGet(int iCopyFile, const QString &sCopyFile, const QUrl &
         q->data(array); // array is empty and must be empty!
     }
 
-    q->processedSize(m_size == UnknownSize ? processed_size : m_size);
+    q->processedSize((m_size == UnknownSize || rangeLimited) ? processed_size : m_size);
     return Result::pass();
 }
 
@@ -2582,6 +2660,11 @@ KIO::WorkerResult Ftp::copy(const QUrl &src, const QUrl &dest, int permissions,
     return d->copy(src, dest, permissions, flags);
 }
 
+KIO::WorkerResult Ftp::checksum(const QUrl &url, const QStringList &algorithms)
+{
+    return d->checksum(url, algorithms);
+}
+
 QDebug operator<<(QDebug dbg, const Result &r)
 
 {
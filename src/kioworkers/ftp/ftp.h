@@ -101,6 +101,8 @@ public:
      */
     KIO::WorkerResult copy(const QUrl &src, const QUrl &dest, int permissions, KIO::JobFlags flags) override;
 
+    KIO::WorkerResult checksum(const QUrl &url, const QStringList &algorithms) override;
+
     std::unique_ptr<FtpInternal> d;
 };
 
@@ -157,6 +159,11 @@ public:
      */
     Q_REQUIRED_RESULT Result copy(const QUrl &src, const QUrl &dest, int permissions, KIO::JobFlags flags);
 
+    /**
+     * Asks the server for a checksum with the HASH command (draft-bryan-ftp-hash)
+     */
+    Q_REQUIRED_RESULT Result checksum(const QUrl &url, const QStringList &algorithms);
+
     // ---------------------------------------- END API
 
     static bool isSocksProxyScheme(const QString &scheme);
@@ -456,6 +463,7 @@ private: // data members
         epsvAllSent = 0x10,
         pasvUnknown = 0x20,
         chmodUnknown = 0x100,
+        hashUnknown = 0x200,
     };
     int m_extControl;
 
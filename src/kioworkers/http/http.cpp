@@ -418,15 +418,41 @@ HTTPProtocol::makeRequest(const QUrl &url, KIO::HTTP_METHOD method, QIODevice *i
     setMetaData(QStringLiteral("responsecode"), QString::number(statusCode));
     setMetaData(QStringLiteral("content-type"), reply->header(QNetworkRequest::ContentTypeHeader).toString());
 
+    QMap<QByteArray, QByteArray> headers;
+    const auto headerPairs = reply->rawHeaderPairs();
+    for (const auto &[key, value] : headerPairs) {
+        headers.insert(key.toLower(), value);
+    }
+
     reply->deleteLater();
 
-    return {statusCode, buf};
+    return {statusCode, buf, 0, headers};
 }
 
 KIO::WorkerResult HTTPProtocol::get(const QUrl &url)
 {
     QByteArray inputData = getData();
-    Response response = makeRequest(url, KIO::HTTP_GET, inputData);
+
+    // Only fetch a prefix of the file if "range-end" (inclusive) is given, e.g. to sniff the MIME type.
+    // "range-start" is not supported here, since we can't resume.
+    QMap<QByteArray, QByteArray> extraHeaders;
+    qint64 rangeLength = -1;
+    const QString rangeEnd = metaData(QStringLiteral("range-end"));
+    if (!rangeEnd.isEmpty()) {
+        bool ok;
+        const qint64 lastByte = rangeEnd.toLongLong(&ok);
+        if (ok && lastByte >= 0) {
+            extraHeaders.insert("Range", "bytes=0-" + QByteArray::number(lastByte));
+            rangeLength = lastByte + 1;
+        }
+    }
+
+    Response response = makeRequest(url, KIO::HTTP_GET, inputData, extraHeaders);
+
+    // The server may ignore the Range header and send everything
+    if (rangeLength >= 0 && response.data.size() > rangeLength) {
+        response.data.truncate(rangeLength);
+    }
 
     data(response.data);
 
@@ -1119,6 +1145,33 @@ KIO::WorkerResult HTTPProtocol::fileSystemFreeSpace(const QUrl &url)
     return davStatList(url, true);
 }
 
+KIO::WorkerResult HTTPProtocol::checksum(const QUrl &url, const QStringList &algorithms)
+{
+    // ownCloud and Nextcloud report the checksums they store for a file,
+    // e.g. "OC-Checksum: SHA1:0a4d55a8d778e5022fab701977c5d840bbc486d0",
+    // so a HEAD request is enough and the contents aren't transferred.
+    QByteArray inputData;
+    const Response response = makeRequest(url, KIO::HTTP_HEAD, inputData);
+    if (response.kioCode || response.httpCode >= 400) {
+        return sendHttpError(url, KIO::HTTP_HEAD, response);
+    }
+
+    const QList<QByteArray> entries = response.headers.value("oc-checksum").split(' ');
+    for (const QByteArray &entry : entries) {
+        const qsizetype colon = entry.indexOf(':');
+        if (colon <= 0) {
+            continue;
+        }
+        const QString algorithm = QString::fromLatin1(entry.left(colon)).toLower();
+        if (algorithms.contains(algorithm)) {
+            setMetaData(QLatin1String("checksum-") + algorithm, QString::fromLatin1(entry.mid(colon + 1)).toLower());
+        }
+    }
+
+    // Not finding any is not an error here, ChecksumJob reports it as unsupported
+    return KIO::WorkerResult::pass();
+}
+
 KIO::WorkerResult HTTPProtocol::davError(KIO::HTTP_METHOD method, const QUrl &url, const Response &response)
 {
     if (response.kioCode == KIO::ERR_ACCESS_DENIED) {
@@ -42,6 +42,7 @@ public:
     KIO::WorkerResult copy(const QUrl &src, const QUrl &dest, int, KIO::JobFlags flags) override;
     KIO::WorkerResult del(const QUrl &url, bool _isfile) override;
     KIO::WorkerResult fileSystemFreeSpace(const QUrl &url) override;
+    KIO::WorkerResult checksum(const QUrl &url, const QStringList &algorithms) override;
 
 Q_SIGNALS:
     void errorOut(KIO::Error error);
@@ -51,6 +52,7 @@ private:
         int httpCode;
         QByteArray data;
         int kioCode = 0;
+        QMap<QByteArray, QByteArray> headers; // keys in lowercase
     };
 
     /**
@@ -16,6 +16,7 @@
 #include <kdirnotify.h>
 #include <kio/batchrenamejob.h>
 #include <kio/copyjob.h>
+#include <kio/deletejob.h>
 #include <kio/filecopyjob.h>
 #include <kio/jobuidelegate.h>
 #include <kio/mkdirjob.h>
@@ -547,6 +548,10 @@ void FileUndoManagerPrivate::stepMovingFiles()
         return;
     }
 
+    if (m_undoState == MOVINGFILES && (stepBatchRenaming() || stepMovingFileBatch())) {
+        return;
+    }
+
     const BasicOperation op = m_currentCmd.m_opQueue.head();
     Q_ASSERT(op.m_valid);
     if (op.m_type == BasicOperation::Directory || op.m_type == BasicOperation::Item) {
@@ -589,6 +594,114 @@ void FileUndoManagerPrivate::stepMovingFiles()
     addDirToUpdate(url);
 }
 
+// Undoing a large copy or move one file at a time takes as long as the operation
+// itself, so consecutive files from the same folder are moved back, or deleted,
+// with a single job. Returns false if the next operation has to be undone alone.
+bool FileUndoManagerPrivate::stepMovingFileBatch()
+{
+    const bool isCopy = m_currentCmd.m_type == FileUndoManager::Copy;
+    // Trashed items are restored one by one, their names in the trash differ from the original ones
+    const bool isMove = m_currentCmd.isMoveOrRename();
+    if (!isCopy && !isMove) {
+        return false;
+    }
+
+    auto &opQueue = m_currentCmd.m_opQueue;
+    const BasicOperation &first = opQueue.head();
+    // Copied files are checked for modifications before deleting them, remote ones need a stat job each
+    if (isCopy && !first.m_dst.isLocalFile()) {
+        return false;
+    }
+
+    const QUrl srcDir = first.m_src.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash);
+    const QUrl dstDir = first.m_dst.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash);
+    auto isInBatch = [&](const BasicOperation &op) {
+        if (op.m_type != BasicOperation::File || op.m_dst.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash) != dstDir) {
+            return false;
+        }
+        // Moving back into a folder keeps the file names
+        return isCopy || (op.m_src.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash) == srcDir && op.m_src.fileName() == op.m_dst.fileName());
+    };
+
+    qsizetype count = 0;
+    while (count < opQueue.size() && isInBatch(opQueue.at(count))) {
+        ++count;
+    }
+    if (count < 2) {
+        return false;
+    }
+
+    QList<QUrl> urls;
+    urls.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        const BasicOperation op = opQueue.dequeue();
+        if (isCopy) {
+            const QFileInfo info(op.m_dst.toLocalFile());
+            if (!info.exists()) {
+                continue; // nothing left to undo
+            }
+            // Same check as done with a stat job for single files (#20532)
+            const QDateTime mtime = QDateTime::fromSecsSinceEpoch(info.lastModified().toSecsSinceEpoch(), QTimeZone::UTC);
+            if (mtime != op.m_mtime) {
+                qCDebug(KIO_WIDGETS) << op.m_dst << "was modified after being copied. Initial timestamp" << op.m_mtime << "now" << mtime;
+                if (!m_uiInterface->copiedFileWasModified(op.m_src, op.m_dst, op.m_mtime.toLocalTime(), mtime.toLocalTime())) {
+                    stopUndo(false);
+                    return true;
+                }
+            }
+        }
+        urls.append(op.m_dst);
+    }
+
+    // The jobs below emit KDirNotify themselves, but the folders may need an update anyway
+    addDirToUpdate(dstDir);
+    addDirToUpdate(srcDir);
+
+    if (urls.isEmpty()) {
+        stepMovingFiles();
+        return true;
+    }
+
+    if (isCopy) {
+        m_currentJob = KIO::del(urls, KIO::HideProgressInfo);
+        m_undoJob->emitDeleting(urls.first());
+    } else {
+        m_currentJob = KIO::move(urls, srcDir, KIO::HideProgressInfo);
+        m_currentJob->uiDelegateExtension()->createClipboardUpdater(m_currentJob, JobUiDelegateExtension::UpdateContent);
+        m_undoJob->emitMovingOrRenaming(dstDir, srcDir, m_currentCmd.m_type);
+    }
+    m_currentJob->setParentJob(m_undoJob);
+    return true;
+}
+
+// A batch rename is undone with a single batch rename, which also takes care of
+// names that went from one file to another. Returns false for other commands.
+bool FileUndoManagerPrivate::stepBatchRenaming()
+{
+    auto &opQueue = m_currentCmd.m_opQueue;
+    if (m_currentCmd.m_type != FileUndoManager::BatchRename || opQueue.size() < 2) {
+        return false;
+    }
+
+    // Last renamed first, in case the job has to rename them back one by one
+    QList<QUrl> src;
+    QList<QUrl> dest;
+    src.reserve(opQueue.size());
+    dest.reserve(opQueue.size());
+    while (!opQueue.isEmpty()) {
+        const BasicOperation op = opQueue.dequeue();
+        src.prepend(op.m_dst);
+        dest.prepend(op.m_src);
+        addDirToUpdate(op.m_dst.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash));
+        addDirToUpdate(op.m_src.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash));
+    }
+
+    m_currentJob = KIO::batchRename(src, dest, KIO::HideProgressInfo);
+    m_undoJob->emitMovingOrRenaming(src.first(), dest.first(), m_currentCmd.m_type);
+    m_currentJob->setParentJob(m_undoJob);
+    return true;
+}
+
 void FileUndoManagerPrivate::stepRemovingLinks()
 {
     // qDebug() << "REMOVINGLINKS";
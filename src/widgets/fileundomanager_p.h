@@ -131,6 +131,8 @@ public:
     void startUndo();
     void stepMakingDirectories();
     void stepMovingFiles();
+    bool stepMovingFileBatch();
+    bool stepBatchRenaming();
     void stepRemovingLinks();
     void stepRemovingDirectories();
 
@@ -24,6 +24,8 @@
 #include <QTextLayout>
 #include <qmath.h>
 
+#include <memory>
+
 #include <KIconEffect>
 #include <KIconLoader>
 #include <KLocalizedString>
@@ -38,6 +40,34 @@ struct Margin {
     int left, right, top, bottom;
 };
 
+// Everything the layout of a label or information text depends on
+struct TextLayoutKey {
+    QString text;
+    QFont font;
+    QSize constraints;
+    Qt::LayoutDirection direction;
+    Qt::Alignment alignment;
+    QTextOption::WrapMode wrapMode;
+    bool wrapText;
+    Qt::TextElideMode elideMode;
+
+    bool operator==(const TextLayoutKey &other) const
+    {
+        return text == other.text && font == other.font && constraints == other.constraints && direction == other.direction
+            && alignment == other.alignment && wrapMode == other.wrapMode && wrapText == other.wrapText && elideMode == other.elideMode;
+    }
+};
+
+static size_t qHash(const TextLayoutKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.text, key.font, key.constraints.width(), key.constraints.height(), int(key.alignment), int(key.wrapMode));
+}
+
+struct CachedTextLayout {
+    std::shared_ptr<QTextLayout> layout;
+    QSize size;
+};
+
 class Q_DECL_HIDDEN KFileItemDelegate::Private
 {
 public:
@@ -75,10 +105,12 @@ public:
     QIcon decoration(const QStyleOptionViewItem &option, const QModelIndex &index) const;
     QPoint iconPosition(const QStyleOptionViewItem &option) const;
     QRect labelRectangle(const QStyleOptionViewItem &option, const QModelIndex &index) const;
+    TextLayoutKey textLayoutKey(const QStyleOptionViewItem &option, const QString &text, const QSize &constraints) const;
+    std::shared_ptr<QTextLayout> cachedLayout(const QStyleOptionViewItem &option, const QString &text, const QSize &constraints, QSize *size) const;
     void layoutTextItems(const QStyleOptionViewItem &option,
                          const QModelIndex &index,
-                         QTextLayout *labelLayout,
-                         QTextLayout *infoLayout,
+                         std::shared_ptr<QTextLayout> *labelLayout,
+                         std::shared_ptr<QTextLayout> *infoLayout,
                          QRect *textBoundingRect) const;
     void drawTextItems(QPainter *painter,
                        const QTextLayout &labelLayout,
@@ -113,6 +145,10 @@ private:
     Margin verticalMargin[NMargins];
     Margin horizontalMargin[NMargins];
     Margin *activeMargins;
+
+    // Laying out the texts is expensive, and the same items get painted over and over when scrolling
+    mutable QCache<TextLayoutKey, CachedTextLayout> layoutCache;
+    mutable QCache<TextLayoutKey, QSize> sizeHintCache;
 };
 
 KFileItemDelegate::Private::Private(KFileItemDelegate *parent)
@@ -125,7 +161,14 @@ KFileItemDelegate::Private::Private(KFileItemDelegate *parent)
     , jobTransfersVisible(false)
     , animationHandler(new KIO::DelegateAnimationHandler(parent))
     , activeMargins(nullptr)
+    , layoutCache(2000)
+    , sizeHintCache(2000)
 {
+    // The fonts are part of the keys, this just frees the layouts that can't be used anymore
+    QObject::connect(qApp, &QGuiApplication::fontChanged, parent, [this]() {
+        layoutCache.clear();
+        sizeHintCache.clear();
+    });
 }
 
 void KFileItemDelegate::Private::setActiveMargins(Qt::Orientation layout)
@@ -427,10 +470,17 @@ QSize KFileItemDelegate::Private::displaySizeHint(const QStyleOptionViewItem &op
         label += QChar(QChar::LineSeparator) + info;
     }
 
-    QTextLayout layout;
-    setLayoutOptions(layout, option);
+    const TextLayoutKey key = textLayoutKey(option, label, QSize(maxWidth, 0));
+    QSize size;
+    if (const QSize *cachedSize = sizeHintCache.object(key)) {
+        size = *cachedSize;
+    } else {
+        QTextLayout layout;
+        setLayoutOptions(layout, option);
+        size = layoutText(layout, label, maxWidth);
+        sizeHintCache.insert(key, new QSize(size));
+    }
 
-    QSize size = layoutText(layout, label, maxWidth);
     if (!info.isEmpty()) {
         // As soon as additional information is shown, it might be necessary that
         // the label and/or the additional information must get elided. To prevent
@@ -617,18 +667,39 @@ QPixmap KFileItemDelegate::Private::transition(const QPixmap &from, const QPixma
     }
 }
 
+TextLayoutKey KFileItemDelegate::Private::textLayoutKey(const QStyleOptionViewItem &option, const QString &text, const QSize &constraints) const
+{
+    const bool wrapText = option.features & QStyleOptionViewItem::WrapText;
+    return TextLayoutKey{text, option.font, constraints, option.direction, option.displayAlignment, wrapText ? wrapMode : QTextOption::NoWrap, wrapText, option.textElideMode};
+}
+
+// Returns the text laid out and elided like layoutText() does, reusing an earlier layout if possible
+std::shared_ptr<QTextLayout>
+KFileItemDelegate::Private::cachedLayout(const QStyleOptionViewItem &option, const QString &text, const QSize &constraints, QSize *size) const
+{
+    const TextLayoutKey key = textLayoutKey(option, text, constraints);
+    if (const CachedTextLayout *cached = layoutCache.object(key)) {
+        *size = cached->size;
+        return cached->layout;
+    }
+
+    auto layout = std::make_shared<QTextLayout>();
+    setLayoutOptions(*layout, option);
+    *size = layoutText(*layout, option, text, constraints);
+    layoutCache.insert(key, new CachedTextLayout{layout, *size});
+    return layout;
+}
+
 void KFileItemDelegate::Private::layoutTextItems(const QStyleOptionViewItem &option,
                                                  const QModelIndex &index,
-                                                 QTextLayout *labelLayout,
-                                                 QTextLayout *infoLayout,
+                                                 std::shared_ptr<QTextLayout> *labelLayout,
+                                                 std::shared_ptr<QTextLayout> *infoLayout,
                                                  QRect *textBoundingRect) const
 {
     KFileItem item = fileItem(index);
     const QString info = information(option, index, item);
     bool showInformation = false;
 
-    setLayoutOptions(*labelLayout, option);
-
     const QRect textArea = labelRectangle(option, index);
     QRect textRect = subtractMargin(textArea, Private::TextMargin);
 
@@ -641,21 +712,25 @@ void KFileItemDelegate::Private::layoutTextItems(const QStyleOptionViewItem &opt
     // If we have additional info text, and there's space for at least two lines of text,
     // adjust the max label size to make room for at least one line of the info text
     if (!info.isEmpty() && textRect.height() >= option.fontMetrics.lineSpacing() * 2) {
-        infoLayout->setFont(labelLayout->font());
-        infoLayout->setTextOption(labelLayout->textOption());
-
         maxLabelSize.rheight() -= option.fontMetrics.lineSpacing();
         showInformation = true;
     }
 
     // Lay out the label text, and adjust the max info size based on the label size
-    labelSize = layoutText(*labelLayout, option, option.text, maxLabelSize);
+    *labelLayout = cachedLayout(option, option.text, maxLabelSize, &labelSize);
     maxInfoSize.rheight() -= labelSize.height();
 
     // Lay out the info text
     if (showInformation) {
-        infoSize = layoutText(*infoLayout, option, info, maxInfoSize);
+        *infoLayout = cachedLayout(option, info, maxInfoSize, &infoSize);
+        // The same text as the label, but it's drawn at another position
+        if (*infoLayout == *labelLayout) {
+            *infoLayout = std::make_shared<QTextLayout>();
+            setLayoutOptions(**infoLayout, option);
+            infoSize = layoutText(**infoLayout, option, info, maxInfoSize);
+        }
     } else {
+        *infoLayout = std::make_shared<QTextLayout>();
         infoSize = QSize(0, 0);
     }
 
@@ -664,8 +739,8 @@ void KFileItemDelegate::Private::layoutTextItems(const QStyleOptionViewItem &opt
     *textBoundingRect = QStyle::alignedRect(option.direction, option.displayAlignment, size, textRect);
 
     // Compute the positions where we should draw the layouts
-    labelLayout->setPosition(QPointF(textRect.x(), textBoundingRect->y()));
-    infoLayout->setPosition(QPointF(textRect.x(), textBoundingRect->y() + labelSize.height()));
+    (*labelLayout)->setPosition(QPointF(textRect.x(), textBoundingRect->y()));
+    (*infoLayout)->setPosition(QPointF(textRect.x(), textBoundingRect->y() + labelSize.height()));
 }
 
 void KFileItemDelegate::Private::drawTextItems(QPainter *painter,
@@ -1226,8 +1301,8 @@ void KFileItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opt
     // ### Apply the selection effect to the icon when the item is selected and
     //      showDecorationSelected is false.
 
-    QTextLayout labelLayout;
-    QTextLayout infoLayout;
+    std::shared_ptr<QTextLayout> labelLayout;
+    std::shared_ptr<QTextLayout> infoLayout;
     QRect textBoundingRect;
 
     d->layoutTextItems(opt, index, &labelLayout, &infoLayout, &textBoundingRect);
@@ -1253,7 +1328,7 @@ void KFileItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opt
         p.setRenderHint(QPainter::Antialiasing);
         style->drawPrimitive(QStyle::PE_PanelItemViewItem, &opt, &p, opt.widget);
         p.drawPixmap(iconPos, icon);
-        d->drawTextItems(&p, labelLayout, labelColor, infoLayout, infoColor, textBoundingRect);
+        d->drawTextItems(&p, *labelLayout, labelColor, *infoLayout, infoColor, textBoundingRect);
         d->drawFocusRect(&p, opt, focusRect);
         p.end();
 
@@ -1265,7 +1340,7 @@ void KFileItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opt
         p.setRenderHint(QPainter::Antialiasing);
         style->drawPrimitive(QStyle::PE_PanelItemViewItem, &opt, &p, opt.widget);
         p.drawPixmap(iconPos, icon);
-        d->drawTextItems(&p, labelLayout, labelColor, infoLayout, infoColor, textBoundingRect);
+        d->drawTextItems(&p, *labelLayout, labelColor, *infoLayout, infoColor, textBoundingRect);
         d->drawFocusRect(&p, opt, focusRect);
         p.end();
 
@@ -1306,7 +1381,7 @@ void KFileItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opt
     style->drawPrimitive(QStyle::PE_PanelItemViewItem, &opt, painter, opt.widget);
     painter->drawPixmap(iconPos, icon);
 
-    d->drawTextItems(painter, labelLayout, labelColor, infoLayout, infoColor, textBoundingRect);
+    d->drawTextItems(painter, *labelLayout, labelColor, *infoLayout, infoColor, textBoundingRect);
     d->drawFocusRect(painter, opt, focusRect);
 
     if (d->jobTransfersVisible && index.column() == 0 && state) {
@@ -1442,11 +1517,11 @@ bool KFileItemDelegate::helpEvent(QHelpEvent *event, QAbstractItemView *view, co
     d->initStyleOption(&opt, index);
     d->setActiveMargins(d->verticalLayout(opt) ? Qt::Vertical : Qt::Horizontal);
 
-    QTextLayout labelLayout;
-    QTextLayout infoLayout;
+    std::shared_ptr<QTextLayout> labelLayout;
+    std::shared_ptr<QTextLayout> infoLayout;
     QRect textBoundingRect;
     d->layoutTextItems(opt, index, &labelLayout, &infoLayout, &textBoundingRect);
-    const QString elidedText = d->elidedText(labelLayout, opt, textBoundingRect.size());
+    const QString elidedText = d->elidedText(*labelLayout, opt, textBoundingRect.size());
 
     if (elidedText != d->display(index)) {
         return QAbstractItemDelegate::helpEvent(event, view, option, index);
@@ -1461,8 +1536,8 @@ QRegion KFileItemDelegate::shape(const QStyleOptionViewItem &option, const QMode
     d->initStyleOption(&opt, index);
     d->setActiveMargins(d->verticalLayout(opt) ? Qt::Vertical : Qt::Horizontal);
 
-    QTextLayout labelLayout;
-    QTextLayout infoLayout;
+    std::shared_ptr<QTextLayout> labelLayout;
+    std::shared_ptr<QTextLayout> infoLayout;
     QRect textBoundingRect;
     d->layoutTextItems(opt, index, &labelLayout, &infoLayout, &textBoundingRect);
 
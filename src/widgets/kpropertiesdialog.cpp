@@ -50,6 +50,7 @@
 #include <kio/jobuidelegate.h>
 #include <kio/renamedialog.h>
 #include <kio/statjob.h>
+#include <kio/transferjob.h>
 #include <kioglobal_p.h>
 #include <kmountpoint.h>
 #include <kprotocolinfo.h>
@@ -107,16 +108,24 @@
 #include <QList>
 #include <QLocale>
 #include <QMimeDatabase>
+#include <QPointer>
 #include <QProgressBar>
 #include <QPushButton>
 #include <QRegularExpression>
 #include <QStandardPaths>
 #include <QStyle>
 #include <QUrl>
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 
+#include <atomic>
 #include <cerrno>
+#include <memory>
+#include <utility>
 extern "C" {
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
 #if HAVE_SYS_XATTR_H
 #include <sys/xattr.h>
 #endif
@@ -2669,6 +2678,102 @@ void KFilePermissionsPropsPlugin::applyChanges()
     chmodDirs();
 }
 
+// All checksums are computed in the same pass, whichever one was asked for
+static const QList<QCryptographicHash::Algorithm> s_checksumAlgorithms = {
+    QCryptographicHash::Md5,
+    QCryptographicHash::Sha1,
+    QCryptographicHash::Sha256,
+    QCryptographicHash::Sha512,
+};
+
+// Large blocks keep the per-block fan-out overhead negligible
+static constexpr qsizetype s_checksumBlockSize = 4 * 1024 * 1024;
+
+// Queued but not yet hashed data of a remote file, before the transfer is suspended
+static constexpr qint64 s_maxQueuedChecksumData = 32 * 1024 * 1024;
+
+namespace
+{
+/**
+ * Feeds each block of data to several hashes, which run in parallel.
+ * Each hash only ever sees its own state, so no locking is needed.
+ */
+class MultiChecksum
+{
+public:
+    explicit MultiChecksum(const QList<QCryptographicHash::Algorithm> &algorithms)
+    {
+        m_hashes.reserve(algorithms.size());
+        for (QCryptographicHash::Algorithm algorithm : algorithms) {
+            m_hashes.push_back(std::make_unique<QCryptographicHash>(algorithm));
+        }
+    }
+
+    void addData(QByteArrayView data)
+    {
+        if (m_hashes.size() == 1) {
+            m_hashes.front()->addData(data);
+            return;
+        }
+        QtConcurrent::blockingMap(m_hashes, [data](std::unique_ptr<QCryptographicHash> &hash) {
+            hash->addData(data);
+        });
+    }
+
+    QStringList results() const
+    {
+        QStringList checksums;
+        checksums.reserve(m_hashes.size());
+        for (const auto &hash : m_hashes) {
+            checksums.append(QString::fromLatin1(hash->result().toHex()));
+        }
+        return checksums;
+    }
+
+private:
+    std::vector<std::unique_ptr<QCryptographicHash>> m_hashes;
+};
+
+struct RemoteChecksumState {
+    explicit RemoteChecksumState(const QList<QCryptographicHash::Algorithm> &algorithms)
+        : checksum(algorithms)
+    {
+    }
+
+    MultiChecksum checksum;
+    std::atomic<qint64> queuedData = 0;
+    std::atomic<bool> cancelled = false;
+
+    // Only used on the GUI thread
+    QByteArray pendingBlock;
+    QFuture<void> hashing; // the last queued block
+    bool hashingStarted = false;
+};
+
+// Hashes the data gathered so far after the blocks queued before
+static void queueChecksumBlock(const std::shared_ptr<RemoteChecksumState> &state)
+{
+    if (state->pendingBlock.isEmpty()) {
+        return;
+    }
+
+    const QByteArray block = std::exchange(state->pendingBlock, QByteArray());
+    state->queuedData += block.size();
+    auto hashBlock = [state, block]() {
+        if (!state->cancelled) {
+            state->checksum.addData(block);
+        }
+        state->queuedData -= block.size();
+    };
+    if (state->hashingStarted) {
+        state->hashing = state->hashing.then(QtFuture::Launch::Async, hashBlock);
+    } else {
+        state->hashingStarted = true;
+        state->hashing = QtConcurrent::run(hashBlock);
+    }
+}
+}
+
 class KChecksumsPlugin::KChecksumsPluginPrivate
 {
 public:
@@ -2678,6 +2783,13 @@ public:
 
     ~KChecksumsPluginPrivate()
     {
+        if (remoteJob) {
+            remoteJob->kill();
+        }
+        // The queued blocks only hold on to their shared state, let them finish without us
+        if (remoteState) {
+            remoteState->cancelled = true;
+        }
     }
 
     QWidget m_widget;
@@ -2688,6 +2800,13 @@ public:
     QString m_sha1;
     QString m_sha256;
     QString m_sha512;
+
+    std::vector<std::function<void()>> pendingRequests;
+    bool computing = false;
+    bool restartComputation = false;
+
+    QPointer<KIO::TransferJob> remoteJob;
+    std::shared_ptr<RemoteChecksumState> remoteState;
 };
 
 KChecksumsPlugin::KChecksumsPlugin(KPropertiesDialog *dialog)
@@ -2711,7 +2830,10 @@ KChecksumsPlugin::KChecksumsPlugin(KPropertiesDialog *dialog)
     connect(d->m_ui.sha256Button, &QPushButton::clicked, this, &KChecksumsPlugin::slotShowSha256);
     connect(d->m_ui.sha512Button, &QPushButton::clicked, this, &KChecksumsPlugin::slotShowSha512);
 
-    d->fileWatcher.addPath(properties->item().localPath());
+    const QString localPath = properties->item().localPath();
+    if (!localPath.isEmpty()) {
+        d->fileWatcher.addPath(localPath);
+    }
     connect(&d->fileWatcher, &QFileSystemWatcher::fileChanged, this, &KChecksumsPlugin::slotInvalidateCache);
 
     auto clipboard = QApplication::clipboard();
@@ -2747,7 +2869,7 @@ bool KChecksumsPlugin::supports(const KFileItemList &items)
     }
 
     const KFileItem &item = items.first();
-    return item.isFile() && !item.localPath().isEmpty() && item.isReadable() && !item.isDesktopFile() && !item.isLink();
+    return item.isFile() && item.isReadable() && !item.isDesktopFile() && !item.isLink();
 }
 
 void KChecksumsPlugin::slotInvalidateCache()
@@ -2756,6 +2878,11 @@ void KChecksumsPlugin::slotInvalidateCache()
     d->m_sha1 = QString();
     d->m_sha256 = QString();
     d->m_sha512 = QString();
+
+    // Whatever is being computed right now is already outdated
+    if (d->computing) {
+        d->restartComputation = true;
+    }
 }
 
 void KChecksumsPlugin::slotShowMd5()
@@ -2830,13 +2957,9 @@ void KChecksumsPlugin::slotVerifyChecksum(const QString &input)
         return;
     }
 
-    // Calculate checksum in another thread.
-    auto futureWatcher = new QFutureWatcher<QString>(this);
-    connect(futureWatcher, &QFutureWatcher<QString>::finished, this, [=]() {
-        const QString checksum = futureWatcher->result();
-        futureWatcher->deleteLater();
-
-        cacheChecksum(checksum, algorithm);
+    // Calculate checksums in the background.
+    requestChecksums([=]() {
+        const QString checksum = cachedChecksum(algorithm);
 
         switch (algorithm) {
         case QCryptographicHash::Md5:
@@ -2865,9 +2988,6 @@ void KChecksumsPlugin::slotVerifyChecksum(const QString &input)
 
     // Notify the user about the background computation.
     setVerifyState();
-
-    auto future = QtConcurrent::run(&KChecksumsPlugin::computeChecksum, algorithm, properties->item().localPath());
-    futureWatcher->setFuture(future);
 }
 
 bool KChecksumsPlugin::isMd5(const QString &input)
@@ -2894,17 +3014,42 @@ bool KChecksumsPlugin::isSha512(const QString &input)
     return regex.match(input).hasMatch();
 }
 
-QString KChecksumsPlugin::computeChecksum(QCryptographicHash::Algorithm algorithm, const QString &path)
+QStringList KChecksumsPlugin::computeChecksums(const QList<QCryptographicHash::Algorithm> &algorithms, const QString &path)
 {
+    const QStringList failed(algorithms.size());
+
     QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return QString();
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        return failed;
+    }
+
+#ifdef Q_OS_LINUX
+    // The file is read exactly once, front to back
+    posix_fadvise(file.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    MultiChecksum checksum(algorithms);
+    QByteArray block(s_checksumBlockSize, Qt::Uninitialized);
+    QByteArray nextBlock(s_checksumBlockSize, Qt::Uninitialized);
+
+    qint64 blockSize = file.read(block.data(), block.size());
+    while (blockSize > 0) {
+        // Hash this block while the next one is being read
+        QFuture<void> hashing = QtConcurrent::run([&checksum, &block, blockSize]() {
+            checksum.addData(QByteArrayView(block.constData(), blockSize));
+        });
+        const qint64 nextBlockSize = file.read(nextBlock.data(), nextBlock.size());
+        hashing.waitForFinished();
+
+        block.swap(nextBlock);
+        blockSize = nextBlockSize;
     }
 
-    QCryptographicHash hash(algorithm);
-    hash.addData(&file);
+    if (blockSize < 0) {
+        return failed;
+    }
 
-    return QString::fromLatin1(hash.result().toHex());
+    return checksum.results();
 }
 
 QCryptographicHash::Algorithm KChecksumsPlugin::detectAlgorithm(const QString &input)
@@ -3005,22 +3150,114 @@ void KChecksumsPlugin::showChecksum(QCryptographicHash::Algorithm algorithm, QLa
         return;
     }
 
-    // Calculate checksum in another thread.
-    auto futureWatcher = new QFutureWatcher<QString>(this);
-    connect(futureWatcher, &QFutureWatcher<QString>::finished, this, [=]() {
-        const QString checksum = futureWatcher->result();
-        futureWatcher->deleteLater();
+    // Calculate checksums in the background.
+    requestChecksums([=]() {
+        label->setText(cachedChecksum(algorithm));
+        copyButton->show();
+    });
+}
 
-        label->setText(checksum);
-        cacheChecksum(checksum, algorithm);
+void KChecksumsPlugin::requestChecksums(const std::function<void()> &callback)
+{
+    d->pendingRequests.push_back(callback);
+    if (!d->computing) {
+        startComputation();
+    }
+}
 
-        copyButton->show();
+void KChecksumsPlugin::startComputation()
+{
+    d->computing = true;
+    d->restartComputation = false;
+
+    const QString localPath = properties->item().localPath();
+    if (localPath.isEmpty()) {
+        startRemoteComputation(properties->item().url());
+        return;
+    }
+
+    auto futureWatcher = new QFutureWatcher<QStringList>(this);
+    connect(futureWatcher, &QFutureWatcher<QStringList>::finished, this, [=]() {
+        futureWatcher->deleteLater();
+        computationFinished(futureWatcher->result());
     });
 
-    auto future = QtConcurrent::run(&KChecksumsPlugin::computeChecksum, algorithm, properties->item().localPath());
+    auto future = QtConcurrent::run(&KChecksumsPlugin::computeChecksums, s_checksumAlgorithms, localPath);
     futureWatcher->setFuture(future);
 }
 
+void KChecksumsPlugin::startRemoteComputation(const QUrl &url)
+{
+    // Stream the file and hash it as it arrives. The data is gathered into large blocks,
+    // which are hashed in order on the thread pool, and the transfer is suspended
+    // whenever hashing falls behind.
+    auto state = std::make_shared<RemoteChecksumState>(s_checksumAlgorithms);
+    auto job = KIO::get(url, KIO::NoReload, KIO::HideProgressInfo);
+    d->remoteJob = job;
+    d->remoteState = state;
+
+    connect(job, &KIO::TransferJob::data, this, [this, job, state](KIO::Job *, const QByteArray &data) {
+        if (state->pendingBlock.isEmpty()) {
+            state->pendingBlock.reserve(s_checksumBlockSize);
+        }
+        state->pendingBlock.append(data);
+        if (state->pendingBlock.size() < s_checksumBlockSize) {
+            return;
+        }
+        queueChecksumBlock(state);
+
+        if (state->queuedData > s_maxQueuedChecksumData && !job->isSuspended()) {
+            job->suspend();
+            state->hashing.then(this, [job = QPointer<KIO::TransferJob>(job)]() {
+                // The job may have finished or been killed in the meantime
+                if (job && job->isSuspended()) {
+                    job->resume();
+                }
+            });
+        }
+    });
+
+    connect(job, &KJob::result, this, [this, state](KJob *finishedJob) {
+        if (finishedJob->error()) {
+            // Don't wait for the blocks still queued, they are skipped
+            state->cancelled = true;
+            d->remoteState.reset();
+            computationFinished(QStringList(s_checksumAlgorithms.size()));
+            return;
+        }
+
+        queueChecksumBlock(state);
+        if (!state->hashingStarted) {
+            d->remoteState.reset();
+            computationFinished(state->checksum.results());
+            return;
+        }
+        state->hashing.then(this, [this, state]() {
+            d->remoteState.reset();
+            computationFinished(state->checksum.results());
+        });
+    });
+}
+
+void KChecksumsPlugin::computationFinished(const QStringList &checksums)
+{
+    if (d->restartComputation) {
+        startComputation();
+        return;
+    }
+
+    d->computing = false;
+    for (int i = 0; i < s_checksumAlgorithms.size(); ++i) {
+        cacheChecksum(checksums.at(i), s_checksumAlgorithms.at(i));
+    }
+
+    const auto requests = std::move(d->pendingRequests);
+    d->pendingRequests.clear();
+    for (const auto &request : requests) {
+        request();
+    }
+}
+
 QString KChecksumsPlugin::cachedChecksum(QCryptographicHash::Algorithm algorithm) const
 {
     switch (algorithm) {
@@ -20,6 +20,8 @@
 
 #include <QCryptographicHash>
 
+#include <functional>
+
 class QComboBox;
 class QLabel;
 
@@ -170,7 +172,11 @@ private:
     static bool isSha1(const QString &input);
     static bool isSha256(const QString &input);
     static bool isSha512(const QString &input);
-    static QString computeChecksum(QCryptographicHash::Algorithm algorithm, const QString &path);
+    /**
+     * Computes all @p algorithms over the file at @p path, reading it only once.
+     * Returns one hex string per algorithm, empty ones if the file couldn't be read.
+     */
+    static QStringList computeChecksums(const QList<QCryptographicHash::Algorithm> &algorithms, const QString &path);
     static QCryptographicHash::Algorithm detectAlgorithm(const QString &input);
 
     void setDefaultState();
@@ -180,6 +186,15 @@ private:
     void setVerifyState();
     void showChecksum(QCryptographicHash::Algorithm algorithm, QLabel *label, QPushButton *copyButton);
 
+    /**
+     * Calls @p callback once all checksums are in cache, computing them
+     * in a single pass over the file if needed.
+     */
+    void requestChecksums(const std::function<void()> &callback);
+    void startComputation();
+    void startRemoteComputation(const QUrl &url);
+    void computationFinished(const QStringList &checksums);
+
     QString cachedChecksum(QCryptographicHash::Algorithm algorithm) const;
     void cacheChecksum(const QString &checksum, QCryptographicHash::Algorithm algorithm);
 